@@ -0,0 +1,25 @@
+#include <cstddef> // size_t
+
+#include <string> // string
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/char_encoder.hpp>
+
+#include "corpus.hpp"
+
+static void CharEncoderEncode(benchmark::State &state) {
+    using std::size_t, std::string;
+
+    const string &text = corpus();
+    size_t count = 0U;
+    const auto consume = [&count](wchar_t) constexpr -> void { ++count; };
+    char_encoder<char, wchar_t, decltype(consume)> invocable(consume);
+    for (auto _ : state) {
+        for (const char c : text)
+            invocable(c);
+        benchmark::DoNotOptimize(count);
+    }
+    set_counters(state);
+}
+BENCHMARK(CharEncoderEncode);
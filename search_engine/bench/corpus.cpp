@@ -0,0 +1,138 @@
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+#include <cstdint> // int64_t
+
+#include <stdexcept> // runtime_error
+#include <string_view> // string_view
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/char_encoder.hpp>
+#include <search_engine/normalizer.hpp>
+#include <search_engine/tokenizer.hpp>
+
+#include "corpus.hpp"
+
+using std::size_t, std::string, std::string_view, std::vector, std::wstring;
+
+static constexpr size_t corpus_size = 1U << 20U;
+
+static constexpr string_view paragraphs[] = {
+    "Москва — столица России, город федерального значения, административный "
+    "центр Центрального федерального округа и центр Московской области, в "
+    "состав которой не входит. Крупнейший по численности населения город "
+    "России и её субъект — 13 010 112 человек (2021), самый населённый из "
+    "городов, полностью расположенных в Европе.\n",
+    "Санкт-Петербург — второй по численности населения город России. Город "
+    "федерального значения. Административный центр Северо-Западного "
+    "федерального округа. Основан 16 (27) мая 1703 года царём Петром I. В "
+    "1714—1728 и 1732—1918 годах — столица Российского государства.\n",
+    "The quick brown fox jumps over the lazy dog. It's an English-language "
+    "pangram, a sentence that contains all of the letters of the alphabet. "
+    "The phrase was used to test typewriters and computer keyboards, and "
+    "displays examples of fonts; U.S.A. and e-mail are handled as one word, "
+    "while 3.14159 and 1,000,000 stay numbers.\n",
+    "Съешь же ещё этих мягких французских булок, да выпей чаю. Фраза "
+    "содержит все буквы русского алфавита, включая «ё» и «ъ», и поэтому "
+    "используется для демонстрации шрифтов и проверки передачи текста по "
+    "каналам связи.\n",
+    "A search engine maintains an inverted index: for every term it keeps "
+    "the list of documents containing it. Queries are analyzed the same way "
+    "as the documents, so that \"Running\", \"runs\" and \"run\" all reach "
+    "the same posting list after normalization and stemming.\n",
+};
+
+const string &corpus() {
+    using std::runtime_error, std::setlocale;
+
+    static const string text = []() -> string {
+        if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
+            throw runtime_error("corpus: unable to set locale");
+        string returns;
+        returns.reserve(corpus_size + 1024U);
+        while (returns.size() < corpus_size)
+            for (const string_view paragraph : paragraphs)
+                returns.append(paragraph);
+        return returns;
+    }();
+    return text;
+}
+
+const string &json_corpus() {
+    static const string text = []() -> string {
+        string returns;
+        returns.reserve(corpus().size() * 11U / 10U);
+        returns.push_back('"');
+        for (const char c : corpus())
+            switch (c) {
+                case '\n':
+                    returns.append("\\n");
+                    break;
+                case '"':
+                    returns.append("\\\"");
+                    break;
+                case '\\':
+                    returns.append("\\\\");
+                    break;
+                default:
+                    returns.push_back(c);
+                    break;
+            }
+        returns.push_back('"');
+        return returns;
+    }();
+    return text;
+}
+
+const wstring &wide_corpus() {
+    static const wstring text = []() -> wstring {
+        wstring returns;
+        const auto consume = [&returns](const wchar_t wc) -> void {
+            returns.push_back(wc);
+        };
+        char_encoder<char, wchar_t, decltype(consume)> encoder(consume);
+        for (const char c : corpus())
+            encoder(c);
+        return returns;
+    }();
+    return text;
+}
+
+const vector<wstring> &tokens() {
+    static const vector<wstring> list = []() -> vector<wstring> {
+        vector<wstring> returns;
+        tokenizer invocable([&returns](const wstring &token) -> void {
+            returns.push_back(token);
+        });
+        for (const wchar_t wc : wide_corpus())
+            invocable(wc);
+        invocable.flush_buffer();
+        return returns;
+    }();
+    return list;
+}
+
+const vector<wstring> &terms() {
+    static const vector<wstring> list = []() -> vector<wstring> {
+        vector<wstring> returns;
+        normalizer invocable([&returns](size_t, const wstring &term) -> void {
+            returns.push_back(term);
+        });
+        for (wstring token : tokens())
+            invocable(token);
+        return returns;
+    }();
+    return list;
+}
+
+void set_counters(benchmark::State &state) {
+    using benchmark::Counter, std::int64_t;
+
+    state.SetBytesProcessed(
+        state.iterations() * static_cast<int64_t>(corpus().size()));
+    state.counters["tokens"] = Counter(
+        static_cast<double>(state.iterations()) *
+            static_cast<double>(tokens().size()),
+        Counter::kIsRate
+    );
+}
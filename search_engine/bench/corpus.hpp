@@ -0,0 +1,32 @@
+#ifndef SEARCH_ENGINE_BENCH_CORPUS_HPP
+#define SEARCH_ENGINE_BENCH_CORPUS_HPP
+
+#include <string> // string, wstring
+#include <vector> // vector
+
+#include <benchmark/benchmark.h>
+
+// About a megabyte of mixed Russian and English encyclopedic prose, and the
+// same text as it looks at every stage of the analysis chain. Each benchmark
+// feeds a stage the whole corpus per iteration, so bytes/s and tokens/s are
+// measured against the source text and are comparable between stages.
+
+// UTF-8 text.
+const std::string &corpus();
+
+// The text as the body of a JSON string, with escapes.
+const std::string &json_corpus();
+
+// The text decoded to wide characters.
+const std::wstring &wide_corpus();
+
+// Tokenizer output.
+const std::vector<std::wstring> &tokens();
+
+// Normalizer output without stop word removal.
+const std::vector<std::wstring> &terms();
+
+// Reports the corpus bytes and tokens processed by the benchmark.
+void set_counters(benchmark::State &);
+
+#endif
@@ -0,0 +1,33 @@
+#include <cstddef> // size_t
+
+#include <string> // wstring
+#include <vector> // vector
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/normalizer.hpp>
+
+#include "corpus.hpp"
+
+template<bool StopWords>
+static void NormalizerNormalize(benchmark::State &state) {
+    using std::size_t, std::vector, std::wstring;
+
+    const vector<wstring> &list = tokens();
+    size_t count = 0U;
+    const auto consume = [&count](size_t, const wstring &) constexpr -> void {
+        ++count;
+    };
+    normalizer<decltype(consume), StopWords> invocable(consume);
+    wstring buffer;
+    for (auto _ : state) {
+        for (const wstring &token : list) {
+            buffer = token;
+            invocable(buffer);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    set_counters(state);
+}
+BENCHMARK(NormalizerNormalize<false>)->Name("NormalizerNormalize");
+BENCHMARK(NormalizerNormalize<true>)->Name("NormalizerStopWords");
@@ -0,0 +1,30 @@
+#include <cstddef> // size_t
+
+#include <string> // wstring
+#include <vector> // vector
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/stemmer.hpp>
+
+#include "corpus.hpp"
+
+static void StemmerStem(benchmark::State &state) {
+    using std::size_t, std::vector, std::wstring;
+
+    const vector<wstring> &list = terms();
+    size_t count = 0U;
+    stemmer invocable([&count](const wstring &) constexpr -> void {
+        ++count;
+    });
+    wstring buffer;
+    for (auto _ : state) {
+        for (const wstring &term : list) {
+            buffer = term;
+            invocable(buffer);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    set_counters(state);
+}
+BENCHMARK(StemmerStem);
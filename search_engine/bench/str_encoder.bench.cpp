@@ -0,0 +1,28 @@
+#include <cstddef> // size_t
+
+#include <string> // string, wstring
+#include <vector> // vector
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/str_encoder.hpp>
+
+#include "corpus.hpp"
+
+static void StrEncoderEncode(benchmark::State &state) {
+    using std::size_t, std::string, std::vector, std::wstring;
+
+    const vector<wstring> &list = terms();
+    size_t bytes = 0U;
+    const auto consume = [&bytes](const string &term) constexpr -> void {
+        bytes += term.size();
+    };
+    str_encoder<wchar_t, char, decltype(consume)> invocable(consume);
+    for (auto _ : state) {
+        for (const wstring &term : list)
+            invocable(term);
+        benchmark::DoNotOptimize(bytes);
+    }
+    set_counters(state);
+}
+BENCHMARK(StrEncoderEncode);
@@ -0,0 +1,26 @@
+#include <cstddef> // size_t
+
+#include <stdexcept> // logic_error
+#include <string> // string
+#include <string_view> // string_view
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/str_parser.hpp>
+
+#include "corpus.hpp"
+
+static void StrParserParse(benchmark::State &state) {
+    using std::logic_error, std::size_t, std::string, std::string_view;
+
+    const string_view json = json_corpus();
+    size_t count = 0U;
+    str_parser invocable([&count](char) constexpr -> void { ++count; });
+    for (auto _ : state) {
+        if (invocable(json.cbegin(), json.cend()) != json.cend()) [[unlikely]]
+            throw logic_error("StrParserParse: string is not parsed");
+        benchmark::DoNotOptimize(count);
+    }
+    set_counters(state);
+}
+BENCHMARK(StrParserParse);
@@ -0,0 +1,27 @@
+#include <cstddef> // size_t
+
+#include <string> // wstring
+
+#include <benchmark/benchmark.h>
+
+#include <search_engine/tokenizer.hpp>
+
+#include "corpus.hpp"
+
+static void TokenizerTokenize(benchmark::State &state) {
+    using std::size_t, std::wstring;
+
+    const wstring &text = wide_corpus();
+    size_t count = 0U;
+    tokenizer invocable([&count](const wstring &) constexpr -> void {
+        ++count;
+    });
+    for (auto _ : state) {
+        for (const wchar_t wc : text)
+            invocable(wc);
+        invocable.flush_buffer();
+        benchmark::DoNotOptimize(count);
+    }
+    set_counters(state);
+}
+BENCHMARK(TokenizerTokenize);
@@ -0,0 +1,11 @@
+#ifndef SEARCH_ENGINE_ALLOCATIONS_HPP
+#define SEARCH_ENGINE_ALLOCATIONS_HPP
+
+#include <cstdint> // uint64_t
+
+// Number of calls to the global operator new made by the calling thread.
+// Counting is per thread so that it never contends; it is only available in
+// programs linking allocations.cpp, which replaces operator new.
+std::uint64_t allocations() noexcept;
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef SEARCH_ENGINE_ANALYZER_HPP
+#define SEARCH_ENGINE_ANALYZER_HPP
+
+#include <cstddef> // size_t
+
+#include <stdexcept> // logic_error
+#include <string> // string, wstring
+#include <type_traits> // conditional_t, is_invocable_r_v, is_nothrow_*_v
+
+#include <search_engine/char_encoder.hpp>
+#include <search_engine/normalizer.hpp>
+#include <search_engine/stemmer.hpp>
+#include <search_engine/str_encoder.hpp>
+#include <search_engine/tokenizer.hpp>
+
+// Chains char_encoder, tokenizer, normalizer, stemmer and str_encoder: UTF-8
+// bytes go in, normalized UTF-8 terms come out. The same chain is used for
+// documents and queries, so both sides always agree on term spelling.
+template<typename Invocable, bool StopWords = false, bool Stem = false>
+class analyzer final {
+public:
+    constexpr analyzer() noexcept(
+        std::is_nothrow_default_constructible_v<Invocable>) = default;
+    constexpr explicit analyzer(const Invocable &);
+    constexpr analyzer(const analyzer &) = default;
+    constexpr analyzer(analyzer &&) noexcept(
+        std::is_nothrow_move_constructible_v<Invocable>) = default;
+    constexpr analyzer &operator=(const analyzer &) = default;
+    constexpr analyzer &operator=(analyzer &&) noexcept(
+        std::is_nothrow_move_assignable_v<Invocable>) = default;
+    constexpr ~analyzer() noexcept(
+        std::is_nothrow_destructible_v<Invocable>) = default;
+
+    constexpr void operator()(char);
+
+    constexpr void flush();
+
+    constexpr const Invocable &invocable() const noexcept;
+    constexpr Invocable &invocable() noexcept;
+
+private:
+    static_assert(std::is_invocable_r_v<void, Invocable, const std::string &>,
+        "Invocable must have signature void(const string &)"
+    );
+
+    using encoder = str_encoder<wchar_t, char, Invocable>;
+
+    class stage final {
+    public:
+        constexpr stage() = default;
+        constexpr explicit stage(const Invocable &);
+
+        constexpr void operator()(std::size_t, std::wstring &);
+
+        constexpr const encoder &next() const noexcept;
+        constexpr encoder &next() noexcept;
+
+    private:
+        std::conditional_t<Stem, stemmer<encoder>, encoder> next_{};
+    };
+
+    char_encoder<char, wchar_t, tokenizer<normalizer<stage, StopWords>>>
+        chain_{};
+};
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr analyzer<Invocable, StopWords, Stem>::analyzer(
+    const Invocable &invocable
+) : chain_(tokenizer(normalizer<stage, StopWords>(stage(invocable)))) {}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr void analyzer<Invocable, StopWords, Stem>::operator()(const char c) {
+    chain_(c);
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr void analyzer<Invocable, StopWords, Stem>::flush() {
+    using std::logic_error;
+
+    chain_.invocable().flush_buffer();
+    chain_.invocable().invocable().reset_position();
+    if (!chain_.is_init_state()) [[unlikely]] {
+        chain_.clear_state();
+        throw logic_error("analyzer::flush: incomplete multibyte sequence");
+    }
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr const Invocable &analyzer<Invocable, StopWords, Stem>::invocable(
+) const noexcept {
+    return chain_.invocable().invocable().invocable().next().invocable();
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr Invocable &analyzer<Invocable, StopWords, Stem>::invocable(
+) noexcept {
+    return chain_.invocable().invocable().invocable().next().invocable();
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr analyzer<Invocable, StopWords, Stem>::stage::stage(
+    const Invocable &invocable
+) : next_(encoder(invocable)) {}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr void analyzer<Invocable, StopWords, Stem>::stage::operator()(
+    std::size_t,
+    std::wstring &wcs
+) {
+    next_(wcs);
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr auto analyzer<Invocable, StopWords, Stem>::stage::next(
+) const noexcept -> const encoder & {
+    if constexpr (Stem)
+        return next_.invocable();
+    else
+        return next_;
+}
+
+template<typename Invocable, bool StopWords, bool Stem>
+constexpr auto analyzer<Invocable, StopWords, Stem>::stage::next(
+) noexcept -> encoder & {
+    if constexpr (Stem)
+        return next_.invocable();
+    else
+        return next_;
+}
+
+#endif
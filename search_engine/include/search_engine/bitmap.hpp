@@ -0,0 +1,101 @@
+#ifndef SEARCH_ENGINE_BITMAP_HPP
+#define SEARCH_ENGINE_BITMAP_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <bit> // countr_zero, popcount
+#include <vector> // vector
+
+// Word-parallel kernels over bitmaps of document ids, where bit i % 64 of
+// word i / 64 stands for document i, the layout of the bitmap containers of
+// an index. The loops carry no dependency from one word to the next, so
+// compilers vectorize them.
+
+constexpr std::size_t bitmap_words(std::size_t) noexcept;
+
+constexpr bool bitmap_contains(const std::uint64_t *, std::uint32_t) noexcept;
+
+// lhs &= rhs, word by word.
+inline void bitmap_and(std::uint64_t *, const std::uint64_t *,
+    std::size_t) noexcept;
+
+// lhs &= ~rhs, word by word.
+inline void bitmap_and_not(std::uint64_t *, const std::uint64_t *,
+    std::size_t) noexcept;
+
+// lhs |= rhs, word by word.
+inline void bitmap_or(std::uint64_t *, const std::uint64_t *,
+    std::size_t) noexcept;
+
+inline std::size_t bitmap_count(const std::uint64_t *, std::size_t) noexcept;
+
+// Appends the ids of the set bits in ascending order.
+inline void bitmap_extract(const std::uint64_t *, std::size_t,
+    std::vector<std::uint32_t> &);
+
+constexpr std::size_t bitmap_words(const std::size_t size) noexcept {
+    return (size + 63U) / 64U;
+}
+
+constexpr bool bitmap_contains(
+    const std::uint64_t * const words,
+    const std::uint32_t id
+) noexcept {
+    return (words[id / 64U] >> (id % 64U) & 1U) != 0U;
+}
+
+inline void bitmap_and(
+    std::uint64_t * const lhs,
+    const std::uint64_t * const rhs,
+    const std::size_t size
+) noexcept {
+    for (std::size_t i = 0U; i < size; ++i)
+        lhs[i] &= rhs[i];
+}
+
+inline void bitmap_and_not(
+    std::uint64_t * const lhs,
+    const std::uint64_t * const rhs,
+    const std::size_t size
+) noexcept {
+    for (std::size_t i = 0U; i < size; ++i)
+        lhs[i] &= ~rhs[i];
+}
+
+inline void bitmap_or(
+    std::uint64_t * const lhs,
+    const std::uint64_t * const rhs,
+    const std::size_t size
+) noexcept {
+    for (std::size_t i = 0U; i < size; ++i)
+        lhs[i] |= rhs[i];
+}
+
+inline std::size_t bitmap_count(
+    const std::uint64_t * const words,
+    const std::size_t size
+) noexcept {
+    using std::popcount;
+
+    std::size_t count = 0U;
+    for (std::size_t i = 0U; i < size; ++i)
+        count += static_cast<std::size_t>(popcount(words[i]));
+    return count;
+}
+
+inline void bitmap_extract(
+    const std::uint64_t * const words,
+    const std::size_t size,
+    std::vector<std::uint32_t> &ids
+) {
+    using std::countr_zero, std::uint32_t, std::uint64_t;
+
+    ids.reserve(ids.size() + bitmap_count(words, size));
+    for (std::size_t i = 0U; i < size; ++i)
+        for (uint64_t word = words[i]; word != 0U; word &= word - 1U)
+            ids.push_back(static_cast<uint32_t>(i * 64U +
+                static_cast<std::size_t>(countr_zero(word))));
+}
+
+#endif
@@ -0,0 +1,485 @@
+#ifndef SEARCH_ENGINE_BTREE_MAP_HPP
+#define SEARCH_ENGINE_BTREE_MAP_HPP
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <cstdint> // uint32_t
+
+#include <algorithm> // clamp, lower_bound, move, move_backward, upper_bound
+#include <array> // array
+#include <functional> // less
+#include <iterator> // forward_iterator_tag
+#include <limits> // numeric_limits
+#include <stdexcept> // length_error, logic_error
+#include <utility> // as_const, move, pair
+#include <vector> // vector
+
+// Ordered map kept in a B+-tree. Nodes live in two vectors and refer to each
+// other by index, and a node holds its keys in one array, so a lookup touches
+// a few contiguous cache lines per level instead of one node per comparison
+// like a red-black tree. Values are only stored in the leaves, which are
+// chained in key order for range and prefix scans. Compare must be
+// transparent for lookups by other types than Key, which std::less<> is.
+//
+// Insertions invalidate iterators and pointers to values; there is no
+// erase, as terms are never removed from the containers this is meant for.
+template<typename Key, typename Value, typename Compare = std::less<>>
+class btree_map final {
+public:
+    class iterator;
+
+    // Nodes are sized to about this many bytes of keys, four cache lines.
+    static constexpr std::size_t node_bytes = 256U;
+    static constexpr std::size_t node_capacity =
+        std::clamp<std::size_t>(node_bytes / sizeof(Key), 4U, 64U);
+
+    btree_map() = default;
+    btree_map(const btree_map &) = default;
+    btree_map(btree_map &&) noexcept = default;
+    btree_map &operator=(const btree_map &) = default;
+    btree_map &operator=(btree_map &&) noexcept = default;
+    ~btree_map() noexcept = default;
+
+    // Replaces the contents with pairs sorted by unique keys, building the
+    // tree bottom up with nodes as full as possible.
+    void assign(std::vector<std::pair<Key, Value>> &&);
+
+    iterator begin() const;
+    iterator end() const;
+
+    void clear() noexcept;
+
+    constexpr bool empty() const noexcept;
+
+    template<typename K>
+    Value *find(const K &);
+    template<typename K>
+    const Value *find(const K &) const;
+
+    // Returns false and keeps the stored value if the key is present.
+    bool insert(Key, Value);
+
+    // Returns an iterator to the first key not less than the argument.
+    template<typename K>
+    iterator lower_bound(const K &) const;
+
+    constexpr std::size_t size() const noexcept;
+
+    // Returns an iterator to the first key greater than the argument.
+    template<typename K>
+    iterator upper_bound(const K &) const;
+
+    Value &operator[](const Key &);
+
+private:
+    using node_id = std::uint32_t;
+
+    static constexpr node_id none = std::numeric_limits<node_id>::max();
+
+    struct leaf final {
+        std::array<Key, node_capacity> keys{};
+        std::array<Value, node_capacity> values{};
+        std::size_t size = 0U;
+        node_id next = none;
+    };
+
+    // Child i + 1 holds the keys not less than keys[i].
+    struct inner final {
+        std::array<Key, node_capacity> keys{};
+        std::array<node_id, node_capacity + 1U> children{};
+        std::size_t size = 0U;
+    };
+
+    std::pair<Value *, bool> emplace(Key, Value);
+    template<typename K>
+    node_id find_leaf(const K &) const;
+    node_id new_inner();
+    node_id new_leaf();
+
+    std::vector<leaf> leaves_{};
+    std::vector<inner> inners_{};
+    node_id root_ = none;
+    // Levels of inner nodes above the leaves.
+    std::size_t height_ = 0U;
+    std::size_t size_ = 0U;
+    [[no_unique_address]] Compare compare_{};
+};
+
+// Forward iterator over the keys in order; value() is the mapped value.
+template<typename Key, typename Value, typename Compare>
+class btree_map<Key, Value, Compare>::iterator final {
+public:
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using pointer = const Key *;
+    using reference = const Key &;
+    using value_type = Key;
+
+    iterator() = default;
+    iterator(const iterator &) = default;
+    iterator(iterator &&) noexcept = default;
+    iterator &operator=(const iterator &) = default;
+    iterator &operator=(iterator &&) noexcept = default;
+    ~iterator() noexcept = default;
+
+    reference operator*() const noexcept {
+        return map_->leaves_[leaf_].keys[position_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    iterator &operator++() noexcept {
+        if (++position_ == map_->leaves_[leaf_].size) {
+            leaf_ = map_->leaves_[leaf_].next;
+            position_ = 0U;
+        }
+        return *this;
+    }
+
+    iterator operator++(int) noexcept {
+        iterator returns = *this;
+        ++*this;
+        return returns;
+    }
+
+    const Value &value() const noexcept {
+        return map_->leaves_[leaf_].values[position_];
+    }
+
+    friend bool operator==(const iterator &lhs, const iterator &rhs)
+        noexcept {
+        return lhs.leaf_ == rhs.leaf_ && lhs.position_ == rhs.position_;
+    }
+
+private:
+    friend class btree_map;
+
+    iterator(const btree_map &map, const node_id leaf,
+        const std::size_t position) noexcept
+        : map_(&map), leaf_(leaf), position_(position) {}
+
+    const btree_map *map_ = nullptr;
+    node_id leaf_ = none;
+    std::size_t position_ = 0U;
+};
+
+template<typename Key, typename Value, typename Compare>
+void btree_map<Key, Value, Compare>::assign(
+    std::vector<std::pair<Key, Value>> &&pairs
+) {
+    using std::logic_error, std::move, std::size_t, std::vector;
+
+    for (size_t i = 1U; i < pairs.size(); ++i)
+        if (!compare_(pairs[i - 1U].first, pairs[i].first)) [[unlikely]]
+            throw logic_error("btree_map::assign: keys are not sorted");
+    clear();
+    if (pairs.empty())
+        return;
+
+    // Items of a node when count items are spread as evenly as possible.
+    const auto share = [](const size_t count, const size_t node,
+        const size_t nodes
+    ) -> size_t {
+        return count / nodes + (node < count % nodes ? 1U : 0U);
+    };
+
+    size_t nodes = (pairs.size() + node_capacity - 1U) / node_capacity;
+    vector<node_id> level;
+    vector<Key> firsts;
+    level.reserve(nodes);
+    firsts.reserve(nodes);
+    for (size_t node = 0U, next = 0U; node < nodes; ++node) {
+        const node_id id = new_leaf();
+        leaf &current = leaves_[id];
+        current.size = share(pairs.size(), node, nodes);
+        for (size_t i = 0U; i < current.size; ++i, ++next) {
+            current.keys[i] = move(pairs[next].first);
+            current.values[i] = move(pairs[next].second);
+        }
+        current.next = node + 1U < nodes ? id + 1U : none;
+        level.push_back(id);
+        firsts.push_back(current.keys[0]);
+    }
+
+    while (level.size() > 1U) {
+        nodes = (level.size() + node_capacity) / (node_capacity + 1U);
+        vector<node_id> parents;
+        vector<Key> parent_firsts;
+        for (size_t node = 0U, next = 0U; node < nodes; ++node) {
+            const node_id id = new_inner();
+            inner &current = inners_[id];
+            const size_t children = share(level.size(), node, nodes);
+            parents.push_back(id);
+            parent_firsts.push_back(move(firsts[next]));
+            current.size = children - 1U;
+            current.children[0] = level[next++];
+            for (size_t i = 0U; i < current.size; ++i, ++next) {
+                current.keys[i] = move(firsts[next]);
+                current.children[i + 1U] = level[next];
+            }
+        }
+        level.swap(parents);
+        firsts.swap(parent_firsts);
+        ++height_;
+    }
+    root_ = level.front();
+    size_ = pairs.size();
+}
+
+template<typename Key, typename Value, typename Compare>
+auto btree_map<Key, Value, Compare>::begin() const -> iterator {
+    return iterator(*this, leaves_.empty() ? none : 0U, 0U);
+}
+
+template<typename Key, typename Value, typename Compare>
+auto btree_map<Key, Value, Compare>::end() const -> iterator {
+    return iterator(*this, none, 0U);
+}
+
+template<typename Key, typename Value, typename Compare>
+void btree_map<Key, Value, Compare>::clear() noexcept {
+    leaves_.clear();
+    inners_.clear();
+    root_ = none;
+    height_ = size_ = 0U;
+}
+
+template<typename Key, typename Value, typename Compare>
+constexpr bool btree_map<Key, Value, Compare>::empty() const noexcept {
+    return size_ == 0U;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+Value *btree_map<Key, Value, Compare>::find(const K &key) {
+    return const_cast<Value *>(std::as_const(*this).find(key));
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+const Value *btree_map<Key, Value, Compare>::find(const K &key) const {
+    using std::lower_bound;
+
+    const node_id id = find_leaf(key);
+    if (id == none)
+        return nullptr;
+    const leaf &current = leaves_[id];
+    const Key * const last = current.keys.data() + current.size;
+    const Key * const found =
+        lower_bound(current.keys.data(), last, key, compare_);
+    if (found == last || compare_(key, *found))
+        return nullptr;
+    return &current.values[static_cast<std::size_t>(
+        found - current.keys.data())];
+}
+
+template<typename Key, typename Value, typename Compare>
+bool btree_map<Key, Value, Compare>::insert(Key key, Value value) {
+    using std::move;
+
+    return emplace(move(key), move(value)).second;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+auto btree_map<Key, Value, Compare>::lower_bound(const K &key) const
+    -> iterator {
+    using std::size_t;
+
+    const node_id id = find_leaf(key);
+    if (id == none)
+        return end();
+    const leaf &current = leaves_[id];
+    const auto position = static_cast<size_t>(std::lower_bound(
+        current.keys.data(), current.keys.data() + current.size, key,
+        compare_) - current.keys.data());
+    if (position == current.size)
+        return iterator(*this, current.next, 0U);
+    return iterator(*this, id, position);
+}
+
+template<typename Key, typename Value, typename Compare>
+constexpr std::size_t btree_map<Key, Value, Compare>::size() const noexcept {
+    return size_;
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+auto btree_map<Key, Value, Compare>::upper_bound(const K &key) const
+    -> iterator {
+    using std::size_t;
+
+    const node_id id = find_leaf(key);
+    if (id == none)
+        return end();
+    const leaf &current = leaves_[id];
+    const auto position = static_cast<size_t>(std::upper_bound(
+        current.keys.data(), current.keys.data() + current.size, key,
+        compare_) - current.keys.data());
+    if (position == current.size)
+        return iterator(*this, current.next, 0U);
+    return iterator(*this, id, position);
+}
+
+template<typename Key, typename Value, typename Compare>
+Value &btree_map<Key, Value, Compare>::operator[](const Key &key) {
+    if (Value * const found = find(key); found != nullptr)
+        return *found;
+    return *emplace(key, Value{}).first;
+}
+
+// Descends to the leaf, splits it if it is full and inserts the separator of
+// the new node into the parent, splitting inner nodes up to a new root as
+// long as they are full.
+template<typename Key, typename Value, typename Compare>
+auto btree_map<Key, Value, Compare>::emplace(Key key, Value value)
+    -> std::pair<Value *, bool> {
+    using std::array, std::move, std::move_backward, std::pair,
+        std::size_t, std::upper_bound, std::vector;
+
+    if (root_ == none)
+        root_ = new_leaf();
+    vector<pair<node_id, size_t>> path;
+    path.reserve(height_);
+    node_id id = root_;
+    for (size_t level = 0U; level < height_; ++level) {
+        const inner &current = inners_[id];
+        const auto position = static_cast<size_t>(upper_bound(
+            current.keys.data(), current.keys.data() + current.size, key,
+            compare_) - current.keys.data());
+        path.emplace_back(id, position);
+        id = current.children[position];
+    }
+
+    size_t position = static_cast<size_t>(std::lower_bound(
+        leaves_[id].keys.data(), leaves_[id].keys.data() + leaves_[id].size,
+        key, compare_) - leaves_[id].keys.data());
+    if (position < leaves_[id].size &&
+        !compare_(key, leaves_[id].keys[position]))
+        return {&leaves_[id].values[position], false};
+    ++size_;
+
+    node_id target = id, split = none;
+    if (leaves_[id].size == node_capacity) {
+        split = new_leaf();
+        leaf &left = leaves_[id], &right = leaves_[split];
+        const size_t middle = node_capacity / 2U;
+        right.size = node_capacity - middle;
+        move(left.keys.begin() + middle, left.keys.end(), right.keys.begin());
+        move(left.values.begin() + middle, left.values.end(),
+            right.values.begin());
+        left.size = middle;
+        right.next = left.next;
+        left.next = split;
+        if (position > middle) {
+            target = split;
+            position -= middle;
+        }
+    }
+    leaf &current = leaves_[target];
+    move_backward(current.keys.begin() + position,
+        current.keys.begin() + current.size,
+        current.keys.begin() + current.size + 1);
+    move_backward(current.values.begin() + position,
+        current.values.begin() + current.size,
+        current.values.begin() + current.size + 1);
+    current.keys[position] = move(key);
+    current.values[position] = move(value);
+    ++current.size;
+    Value * const returns = &current.values[position];
+    if (split == none)
+        return {returns, true};
+
+    Key separator = leaves_[split].keys[0];
+    while (!path.empty()) {
+        const auto [parent, child] = path.back();
+        path.pop_back();
+        if (inners_[parent].size < node_capacity) {
+            inner &node = inners_[parent];
+            move_backward(node.keys.begin() + child,
+                node.keys.begin() + node.size,
+                node.keys.begin() + node.size + 1);
+            move_backward(node.children.begin() + child + 1,
+                node.children.begin() + node.size + 1,
+                node.children.begin() + node.size + 2);
+            node.keys[child] = move(separator);
+            node.children[child + 1U] = split;
+            ++node.size;
+            return {returns, true};
+        }
+
+        // The full node and the new entry, split around the middle key,
+        // which moves up.
+        array<Key, node_capacity + 1U> keys;
+        array<node_id, node_capacity + 2U> children;
+        inner &full = inners_[parent];
+        move(full.keys.begin(), full.keys.begin() + child, keys.begin());
+        keys[child] = move(separator);
+        move(full.keys.begin() + child, full.keys.end(),
+            keys.begin() + child + 1);
+        move(full.children.begin(), full.children.begin() + child + 1,
+            children.begin());
+        children[child + 1U] = split;
+        move(full.children.begin() + child + 1, full.children.end(),
+            children.begin() + child + 2);
+
+        const node_id sibling = new_inner();
+        inner &left = inners_[parent], &right = inners_[sibling];
+        const size_t middle = (node_capacity + 1U) / 2U;
+        left.size = middle;
+        move(keys.begin(), keys.begin() + middle, left.keys.begin());
+        move(children.begin(), children.begin() + middle + 1,
+            left.children.begin());
+        right.size = node_capacity - middle;
+        move(keys.begin() + middle + 1, keys.end(), right.keys.begin());
+        move(children.begin() + middle + 1, children.end(),
+            right.children.begin());
+        separator = move(keys[middle]);
+        split = sibling;
+    }
+
+    const node_id root = new_inner();
+    inner &node = inners_[root];
+    node.size = 1U;
+    node.keys[0] = move(separator);
+    node.children[0] = root_;
+    node.children[1] = split;
+    root_ = root;
+    ++height_;
+    return {returns, true};
+}
+
+template<typename Key, typename Value, typename Compare>
+template<typename K>
+auto btree_map<Key, Value, Compare>::find_leaf(const K &key) const
+    -> node_id {
+    using std::size_t, std::upper_bound;
+
+    node_id id = root_;
+    for (size_t level = 0U; level < height_ && id != none; ++level) {
+        const inner &current = inners_[id];
+        id = current.children[static_cast<size_t>(upper_bound(
+            current.keys.data(), current.keys.data() + current.size, key,
+            compare_) - current.keys.data())];
+    }
+    return id;
+}
+
+template<typename Key, typename Value, typename Compare>
+auto btree_map<Key, Value, Compare>::new_inner() -> node_id {
+    if (inners_.size() == none) [[unlikely]]
+        throw std::length_error("btree_map::new_inner: too many nodes");
+    inners_.emplace_back();
+    return static_cast<node_id>(inners_.size() - 1U);
+}
+
+template<typename Key, typename Value, typename Compare>
+auto btree_map<Key, Value, Compare>::new_leaf() -> node_id {
+    if (leaves_.size() == none) [[unlikely]]
+        throw std::length_error("btree_map::new_leaf: too many nodes");
+    leaves_.emplace_back();
+    return static_cast<node_id>(leaves_.size() - 1U);
+}
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef SEARCH_ENGINE_CACHE_HPP
+#define SEARCH_ENGINE_CACHE_HPP
+
+#include <cstddef> // size_t
+
+#include <algorithm> // clamp
+#include <functional> // hash
+#include <iterator> // prev
+#include <list> // list
+#include <memory> // shared_ptr
+#include <mutex> // lock_guard, mutex
+#include <stdexcept> // logic_error
+#include <unordered_map> // unordered_map
+#include <utility> // move
+#include <vector> // vector
+
+#include <search_engine/frequency_sketch.hpp>
+
+struct cache_statistics final {
+    std::size_t hits = 0U;
+    std::size_t misses = 0U;
+    std::size_t insertions = 0U;
+    std::size_t rejections = 0U;
+    std::size_t evictions = 0U;
+    std::size_t entries = 0U;
+    std::size_t size = 0U;
+};
+
+// Size-bounded segmented LRU cache. New entries land in the probation segment
+// and are promoted to the protected segment on their second hit, so a burst of
+// one-off keys can only evict other one-off keys. Keys are spread over shards
+// with independent locks, which keeps the cache usable from worker threads.
+// An entry must fit in its shard, so small caches get fewer shards than asked
+// for, each of at least min_shard_capacity bytes; larger entries are counted
+// as rejections.
+//
+// With Admission every lookup is counted in a frequency_sketch and a new entry
+// that would evict another one is only admitted if its key has been requested
+// more often than the victim's (TinyLFU).
+template<typename Key, typename Value, bool Admission = false,
+    typename Hash = std::hash<Key>>
+class cache final {
+public:
+    using statistics = cache_statistics;
+
+    static constexpr std::size_t min_shard_capacity = 1U << 23U;
+
+    // Takes the capacity in bytes and the largest number of shards.
+    explicit cache(std::size_t, std::size_t = 16U);
+    cache(const cache &) = delete;
+    cache(cache &&) = delete;
+    cache &operator=(const cache &) = delete;
+    cache &operator=(cache &&) = delete;
+    ~cache() noexcept = default;
+
+    constexpr std::size_t capacity() const noexcept;
+
+    void clear();
+
+    std::shared_ptr<const Value> find(const Key &);
+
+    void insert(const Key &, std::shared_ptr<const Value>, std::size_t);
+
+    statistics stats() const;
+
+private:
+    // Part of the shard capacity reserved for entries hit at least twice.
+    static constexpr std::size_t protected_percent = 80U;
+    // The frequency sketch is sized for entries of about this many bytes.
+    static constexpr std::size_t sketch_entry_size = 64U;
+
+    static constexpr std::size_t shard_count(std::size_t, std::size_t)
+        noexcept;
+
+    // The key is owned by the entries_ map of the shard, whose nodes never
+    // move. Entries with hits since they last entered probation are protected.
+    struct entry final {
+        std::shared_ptr<const Value> value;
+        const Key *key;
+        std::size_t hash;
+        std::size_t cost;
+        std::size_t hits;
+    };
+
+    class shard final {
+    public:
+        shard() = default;
+        shard(const shard &) = delete;
+        shard &operator=(const shard &) = delete;
+
+        void clear();
+        std::shared_ptr<const Value> find(const Key &, std::size_t,
+            std::size_t);
+        void insert(const Key &, std::shared_ptr<const Value>, std::size_t,
+            std::size_t, std::size_t);
+        void reject();
+        void reserve(std::size_t);
+        void stats(statistics &) const;
+
+    private:
+        using list_type = std::list<entry>;
+
+        bool admit(std::size_t, std::size_t, std::size_t);
+        void demote(std::size_t);
+        void evict(std::size_t);
+
+        list_type probation_{};
+        list_type protected_{};
+        std::unordered_map<Key, typename list_type::iterator, Hash> entries_{};
+        frequency_sketch sketch_{};
+        statistics stats_{};
+        std::size_t probation_size_ = 0U;
+        std::size_t protected_size_ = 0U;
+        mutable std::mutex mutex_{};
+    };
+
+    std::vector<shard> shards_;
+    std::size_t capacity_;
+    std::size_t shard_capacity_;
+    [[no_unique_address]] Hash hash_{};
+};
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+cache<Key, Value, Admission, Hash>::cache(
+    const std::size_t capacity,
+    const std::size_t shards
+) : shards_(shard_count(capacity, shards)), capacity_(capacity),
+    shard_capacity_(shards == 0U ? 0U : capacity / shards_.size()) {
+    using std::clamp, std::logic_error;
+
+    if (shards == 0U) [[unlikely]]
+        throw logic_error("cache::cache: number of shards must be positive");
+    if constexpr (Admission)
+        for (shard &current : shards_)
+            current.reserve(clamp<std::size_t>(
+                shard_capacity_ / sketch_entry_size, 64U, 1U << 20U));
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+constexpr std::size_t cache<Key, Value, Admission, Hash>::capacity(
+) const noexcept {
+    return capacity_;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::clear() {
+    for (shard &current : shards_)
+        current.clear();
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+std::shared_ptr<const Value> cache<Key, Value, Admission, Hash>::find(
+    const Key &key
+) {
+    const std::size_t hash = hash_(key);
+    return shards_[hash % shards_.size()].find(key, hash, shard_capacity_);
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::insert(
+    const Key &key,
+    std::shared_ptr<const Value> value,
+    const std::size_t cost
+) {
+    using std::move;
+
+    const std::size_t hash = hash_(key);
+    shard &owner = shards_[hash % shards_.size()];
+    if (cost > shard_capacity_) [[unlikely]]
+        owner.reject();
+    else
+        owner.insert(key, move(value), hash, cost, shard_capacity_);
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+auto cache<Key, Value, Admission, Hash>::stats() const -> statistics {
+    statistics returns;
+    for (const shard &current : shards_)
+        current.stats(returns);
+    return returns;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+constexpr std::size_t cache<Key, Value, Admission, Hash>::shard_count(
+    const std::size_t capacity,
+    const std::size_t shards
+) noexcept {
+    using std::clamp;
+
+    return shards == 0U ? 0U :
+        clamp<std::size_t>(capacity / min_shard_capacity, 1U, shards);
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::clear() {
+    using std::lock_guard, std::mutex;
+
+    const lock_guard<mutex> lock(mutex_);
+    probation_.clear();
+    protected_.clear();
+    entries_.clear();
+    probation_size_ = protected_size_ = 0U;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+auto cache<Key, Value, Admission, Hash>::shard::find(
+    const Key &key,
+    const std::size_t hash,
+    const std::size_t capacity
+) -> std::shared_ptr<const Value> {
+    using std::lock_guard, std::mutex;
+
+    const lock_guard<mutex> lock(mutex_);
+    if constexpr (Admission)
+        sketch_.increment(hash);
+    const auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+
+    entry &current = *iter->second;
+    if (current.hits++ != 0U)
+        protected_.splice(protected_.cbegin(), protected_, iter->second);
+    else {
+        probation_size_ -= current.cost;
+        protected_size_ += current.cost;
+        protected_.splice(protected_.cbegin(), probation_, iter->second);
+        demote(capacity * protected_percent / 100U);
+    }
+    return current.value;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::insert(
+    const Key &key,
+    std::shared_ptr<const Value> value,
+    const std::size_t hash,
+    const std::size_t cost,
+    const std::size_t capacity
+) {
+    using std::lock_guard, std::move, std::mutex;
+
+    const lock_guard<mutex> lock(mutex_);
+    if (const auto iter = entries_.find(key); iter != entries_.end()) {
+        entry &current = *iter->second;
+        (current.hits != 0U ? protected_size_ : probation_size_) +=
+            cost - current.cost;
+        current.value = move(value);
+        current.cost = cost;
+    } else if (admit(hash, cost, capacity)) {
+        probation_.push_front(entry{move(value), nullptr, hash, cost, 0U});
+        probation_.front().key =
+            &entries_.emplace(key, probation_.begin()).first->first;
+        probation_size_ += cost;
+        ++stats_.insertions;
+    } else {
+        ++stats_.rejections;
+        return;
+    }
+    demote(capacity * protected_percent / 100U);
+    evict(capacity);
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::reject() {
+    using std::lock_guard, std::mutex;
+
+    const lock_guard<mutex> lock(mutex_);
+    ++stats_.rejections;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::stats(
+    statistics &returns
+) const {
+    using std::lock_guard, std::mutex;
+
+    const lock_guard<mutex> lock(mutex_);
+    returns.hits += stats_.hits;
+    returns.misses += stats_.misses;
+    returns.insertions += stats_.insertions;
+    returns.rejections += stats_.rejections;
+    returns.evictions += stats_.evictions;
+    returns.entries += entries_.size();
+    returns.size += probation_size_ + protected_size_;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+bool cache<Key, Value, Admission, Hash>::shard::admit(
+    const std::size_t hash,
+    const std::size_t cost,
+    const std::size_t capacity
+) {
+    if constexpr (Admission) {
+        if (probation_size_ + protected_size_ + cost <= capacity)
+            return true;
+        const entry &victim =
+            (probation_.empty() ? protected_ : probation_).back();
+        return sketch_.estimate(hash) > sketch_.estimate(victim.hash);
+    } else
+        return true;
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::demote(
+    const std::size_t capacity
+) {
+    while (protected_size_ > capacity) {
+        entry &last = protected_.back();
+        last.hits = 0U;
+        protected_size_ -= last.cost;
+        probation_size_ += last.cost;
+        probation_.splice(probation_.cbegin(), protected_,
+            std::prev(protected_.cend()));
+    }
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::reserve(
+    const std::size_t width
+) {
+    sketch_.resize(width);
+}
+
+template<typename Key, typename Value, bool Admission, typename Hash>
+void cache<Key, Value, Admission, Hash>::shard::evict(
+    const std::size_t capacity
+) {
+    while (probation_size_ + protected_size_ > capacity) {
+        list_type &victims = probation_.empty() ? protected_ : probation_;
+        const entry &last = victims.back();
+        (last.hits != 0U ? protected_size_ : probation_size_) -= last.cost;
+        entries_.erase(*last.key);
+        victims.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef SEARCH_ENGINE_DICTIONARY_HPP
+#define SEARCH_ENGINE_DICTIONARY_HPP
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <iterator> // forward_iterator_tag
+#include <optional> // optional
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/index.hpp>
+
+// Read-only view of a sorted, front-coded term dictionary. Terms are grouped
+// in blocks of block_terms; every entry is encoded as varbyte(shared prefix
+// length), varbyte(suffix length), suffix, and the first entry of a block
+// shares nothing with its predecessor. Block headers are therefore stored in
+// full and can be binary searched without decoding, and term ids are implied
+// by the position of a term in the sort order.
+class dictionary final {
+public:
+    using term_id = index::term_id;
+
+    class iterator;
+
+    static constexpr std::size_t block_terms = 32U;
+
+    constexpr dictionary() noexcept = default;
+    dictionary(const std::uint64_t *, const char *, std::size_t);
+    constexpr dictionary(const dictionary &) noexcept = default;
+    constexpr dictionary(dictionary &&) noexcept = default;
+    constexpr dictionary &operator=(const dictionary &) noexcept = default;
+    constexpr dictionary &operator=(dictionary &&) noexcept = default;
+    constexpr ~dictionary() noexcept = default;
+
+    static constexpr std::size_t blocks(std::size_t) noexcept;
+
+    // Front-codes sorted unique terms, appending the block offsets (blocks
+    // + 1 values, starting with 0) and the encoded blocks.
+    static void encode(const std::vector<std::string_view> &,
+        std::vector<std::uint64_t> &, std::string &);
+
+    iterator begin() const;
+    iterator end() const;
+
+    std::optional<term_id> find(std::string_view) const;
+
+    // Returns an iterator to the first term not less than the argument.
+    iterator lower_bound(std::string_view) const;
+
+    constexpr std::size_t size() const noexcept;
+
+    std::string term(term_id) const;
+
+private:
+    std::string_view header(std::size_t) const;
+
+    const std::uint64_t *offsets_ = nullptr;
+    const char *blocks_ = nullptr;
+    std::size_t size_ = 0U;
+};
+
+// Forward iterator decoding consecutive terms of a dictionary.
+class dictionary::iterator final {
+public:
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using pointer = const std::string *;
+    using reference = const std::string &;
+    using value_type = std::string;
+
+    iterator() = default;
+    iterator(const iterator &) = default;
+    iterator(iterator &&) noexcept = default;
+    iterator &operator=(const iterator &) = default;
+    iterator &operator=(iterator &&) noexcept = default;
+    ~iterator() noexcept = default;
+
+    inline reference operator*() const noexcept;
+    inline pointer operator->() const noexcept;
+
+    iterator &operator++();
+    inline iterator operator++(int);
+
+    inline term_id id() const noexcept;
+
+    friend inline bool operator==(const iterator &, const iterator &) noexcept;
+
+private:
+    friend class dictionary;
+
+    iterator(const dictionary &, term_id);
+
+    void decode();
+
+    std::string term_{};
+    const char *first_ = nullptr;
+    const char *last_ = nullptr;
+    term_id id_ = 0U;
+    term_id size_ = 0U;
+};
+
+constexpr std::size_t dictionary::blocks(const std::size_t terms) noexcept {
+    return (terms + block_terms - 1U) / block_terms;
+}
+
+constexpr std::size_t dictionary::size() const noexcept {
+    return size_;
+}
+
+inline auto dictionary::iterator::operator*() const noexcept -> reference {
+    return term_;
+}
+
+inline auto dictionary::iterator::operator->() const noexcept -> pointer {
+    return &term_;
+}
+
+inline auto dictionary::iterator::operator++(int) -> iterator {
+    iterator returns = *this;
+    ++*this;
+    return returns;
+}
+
+inline auto dictionary::iterator::id() const noexcept -> term_id {
+    return id_;
+}
+
+inline bool operator==(
+    const dictionary::iterator &lhs,
+    const dictionary::iterator &rhs
+) noexcept {
+    return lhs.id_ == rhs.id_;
+}
+
+#endif
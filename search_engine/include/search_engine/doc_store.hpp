@@ -0,0 +1,134 @@
+#ifndef SEARCH_ENGINE_DOC_STORE_HPP
+#define SEARCH_ENGINE_DOC_STORE_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <array> // array
+#include <fstream> // ofstream
+#include <memory> // shared_ptr
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/cache.hpp>
+#include <search_engine/index.hpp>
+#include <search_engine/memmap.hpp>
+
+// A stored document; the views point into the decompressed block, which the
+// document keeps alive.
+struct stored_document final {
+    std::shared_ptr<const std::string> block{};
+    std::string_view title{};
+    std::string_view text{};
+};
+
+// Titles and texts of the documents of an index, under the same ids,
+// compressed with lz_compress in blocks of about block_size bytes so that
+// fetching one document decompresses one block rather than the whole file.
+// A document never spans blocks; one larger than a block gets a block of its
+// own. The file is mapped, and recently decompressed blocks are kept in a
+// cache shared by the threads that read the store.
+class doc_store final {
+public:
+    using doc_id = index::doc_id;
+
+    // File layout, every section 8-byte aligned:
+    //   header
+    //   blocks:        compressed blocks, each a sequence of documents
+    //                  stored as varbyte title size, title, varbyte text
+    //                  size, text
+    //   block_offsets: uint64_t offsets[blocks + 1] of the blocks in the
+    //                  file, uint32_t sizes[blocks] of the decompressed
+    //                  blocks
+    //   locations:     location[documents]
+    struct header final {
+        std::array<char, 8> magic;
+        std::uint32_t documents;
+        std::uint32_t block_size;
+        std::uint64_t blocks;
+        std::uint64_t block_offsets;
+        std::uint64_t locations;
+        std::uint64_t size;
+    };
+
+    struct location final {
+        std::uint32_t block;
+        std::uint32_t offset; // in the decompressed block
+    };
+
+    static constexpr std::array<char, 8> magic = {{
+        'S', 'E', 'D', 'O', 'C', 'S', '0', '1'
+    }};
+
+    static constexpr std::size_t default_cache_size = 1U << 24U;
+
+    // The cache size is in bytes of decompressed blocks.
+    explicit doc_store(const char *, std::size_t = default_cache_size);
+    doc_store(const doc_store &) = delete;
+    doc_store(doc_store &&) = delete;
+    doc_store &operator=(const doc_store &) = delete;
+    doc_store &operator=(doc_store &&) = delete;
+    ~doc_store() noexcept = default;
+
+    stored_document get(doc_id) const;
+
+    inline std::size_t size() const noexcept;
+
+    cache_statistics stats() const;
+
+private:
+    std::shared_ptr<const std::string> block(std::uint32_t) const;
+
+    memmap map_;
+    const header *header_ = nullptr;
+    const std::uint64_t *block_offsets_ = nullptr;
+    const std::uint32_t *block_sizes_ = nullptr;
+    const location *locations_ = nullptr;
+    mutable cache<std::uint32_t, std::string> blocks_;
+};
+
+// Writes a doc_store file, document after document, compressing each block
+// once it is full; only the small tables are held in memory until finish.
+class doc_store_writer final {
+public:
+    static constexpr std::size_t default_block_size = 1U << 15U;
+
+    explicit doc_store_writer(const char *,
+        std::size_t = default_block_size);
+    doc_store_writer(const doc_store_writer &) = delete;
+    doc_store_writer(doc_store_writer &&) = delete;
+    doc_store_writer &operator=(const doc_store_writer &) = delete;
+    doc_store_writer &operator=(doc_store_writer &&) = delete;
+    ~doc_store_writer() noexcept = default;
+
+    // Stores the next document, whose id is the number stored before it.
+    void add(std::string_view, std::string_view);
+
+    // Writes the last block and the tables; the file is incomplete before.
+    void finish();
+
+    inline std::size_t size() const noexcept;
+
+private:
+    void flush();
+
+    // Closed by finish.
+    std::ofstream file_;
+    std::string block_{};
+    std::string compressed_{};
+    std::vector<std::uint64_t> block_offsets_;
+    std::vector<std::uint32_t> block_sizes_{};
+    std::vector<doc_store::location> locations_{};
+    std::size_t block_size_;
+};
+
+inline std::size_t doc_store::size() const noexcept {
+    return header_->documents;
+}
+
+inline std::size_t doc_store_writer::size() const noexcept {
+    return locations_.size();
+}
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef SEARCH_ENGINE_FLAT_HASH_MAP_HPP
+#define SEARCH_ENGINE_FLAT_HASH_MAP_HPP
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <cstdint> // uint32_t
+
+#include <bit> // bit_ceil, countr_zero
+#include <functional> // equal_to, hash
+#include <iterator> // forward_iterator_tag
+#include <utility> // move, pair
+#include <vector> // vector
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // _mm_cmpeq_epi8, _mm_loadu_si128, _mm_movemask_epi8
+#endif
+
+#include <search_engine/types.hpp>
+
+// Open addressing hash map in the style of Abseil's Swiss tables. Every slot
+// has a control byte, holding 7 bits of the hash of its key or marking it
+// empty, and the control bytes of a group of 16 consecutive slots are
+// compared with the tag of a key at once, with SSE2 where available, so a
+// lookup usually inspects a single key. The full hash of every key is kept
+// next to it, so mismatches rarely compare keys and growing never hashes
+// them again. Groups are probed quadratically and the table grows before it
+// is 7/8 full.
+//
+// Keys and values are stored in place, so a key that refers to memory, like
+// a string_view, must outlive the map. There is no erase, which spares
+// tombstones; insertions invalidate iterators and pointers to values.
+template<typename Key, typename Value, typename Hash = std::hash<Key>,
+    typename Equal = std::equal_to<Key>>
+class flat_hash_map final {
+public:
+    using value_type = std::pair<Key, Value>;
+
+    class iterator;
+
+    static constexpr std::size_t group_size = 16U;
+
+    flat_hash_map() = default;
+    flat_hash_map(const flat_hash_map &) = default;
+    flat_hash_map(flat_hash_map &&) noexcept = default;
+    flat_hash_map &operator=(const flat_hash_map &) = default;
+    flat_hash_map &operator=(flat_hash_map &&) noexcept = default;
+    ~flat_hash_map() noexcept = default;
+
+    iterator begin() const;
+    iterator end() const;
+
+    constexpr std::size_t capacity() const noexcept;
+
+    void clear() noexcept;
+
+    Value *find(const Key &);
+    const Value *find(const Key &) const;
+
+    // Inserts a key that is not in the map yet and returns its value.
+    Value &insert(Key, Value = Value{});
+
+    // Makes room for the given number of keys without growing again.
+    void reserve(std::size_t);
+
+    constexpr std::size_t size() const noexcept;
+
+private:
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+    static constexpr uchar empty = 0x80U;
+
+    // Bit i is set if byte i of the group equals the tag.
+    static std::uint32_t match(const uchar *, uchar) noexcept;
+    // Bit i is set if slot i of the group is empty.
+    static std::uint32_t match_empty(const uchar *) noexcept;
+
+    std::size_t find_slot(const Key &, std::size_t) const;
+    std::size_t free_slot(std::size_t) const noexcept;
+    void rehash(std::size_t);
+    void set_control(std::size_t, uchar) noexcept;
+
+    // One byte per slot followed by a copy of the first group, so that a
+    // group can be loaded from any slot.
+    std::vector<uchar> control_{};
+    std::vector<value_type> slots_{};
+    std::vector<std::size_t> hashes_{};
+    std::size_t size_ = 0U;
+    std::size_t growth_left_ = 0U;
+    [[no_unique_address]] Hash hash_{};
+    [[no_unique_address]] Equal equal_{};
+};
+
+// Forward iterator over the pairs in slot order.
+template<typename Key, typename Value, typename Hash, typename Equal>
+class flat_hash_map<Key, Value, Hash, Equal>::iterator final {
+public:
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using pointer = const flat_hash_map::value_type *;
+    using reference = const flat_hash_map::value_type &;
+    using value_type = flat_hash_map::value_type;
+
+    iterator() = default;
+    iterator(const iterator &) = default;
+    iterator(iterator &&) noexcept = default;
+    iterator &operator=(const iterator &) = default;
+    iterator &operator=(iterator &&) noexcept = default;
+    ~iterator() noexcept = default;
+
+    reference operator*() const noexcept {
+        return map_->slots_[slot_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    iterator &operator++() noexcept {
+        ++slot_;
+        skip();
+        return *this;
+    }
+
+    iterator operator++(int) noexcept {
+        iterator returns = *this;
+        ++*this;
+        return returns;
+    }
+
+    friend bool operator==(const iterator &lhs, const iterator &rhs)
+        noexcept {
+        return lhs.slot_ == rhs.slot_;
+    }
+
+private:
+    friend class flat_hash_map;
+
+    iterator(const flat_hash_map &map, const std::size_t slot) noexcept
+        : map_(&map), slot_(slot) {
+        skip();
+    }
+
+    void skip() noexcept {
+        while (slot_ < map_->slots_.size() &&
+            map_->control_[slot_] == flat_hash_map::empty)
+            ++slot_;
+    }
+
+    const flat_hash_map *map_ = nullptr;
+    std::size_t slot_ = 0U;
+};
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+auto flat_hash_map<Key, Value, Hash, Equal>::begin() const -> iterator {
+    return iterator(*this, 0U);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+auto flat_hash_map<Key, Value, Hash, Equal>::end() const -> iterator {
+    return iterator(*this, slots_.size());
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+constexpr std::size_t flat_hash_map<Key, Value, Hash, Equal>::capacity(
+) const noexcept {
+    return slots_.size();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+void flat_hash_map<Key, Value, Hash, Equal>::clear() noexcept {
+    control_.clear();
+    slots_.clear();
+    hashes_.clear();
+    size_ = growth_left_ = 0U;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+Value *flat_hash_map<Key, Value, Hash, Equal>::find(const Key &key) {
+    const std::size_t slot = find_slot(key, hash_(key));
+    return slot == none ? nullptr : &slots_[slot].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+const Value *flat_hash_map<Key, Value, Hash, Equal>::find(
+    const Key &key
+) const {
+    const std::size_t slot = find_slot(key, hash_(key));
+    return slot == none ? nullptr : &slots_[slot].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+Value &flat_hash_map<Key, Value, Hash, Equal>::insert(Key key, Value value) {
+    using std::move, std::size_t;
+
+    if (growth_left_ == 0U) [[unlikely]]
+        rehash(slots_.empty() ? group_size : slots_.size() * 2U);
+    const size_t hash = hash_(key), slot = free_slot(hash);
+    set_control(slot, static_cast<uchar>(hash & 0x7FU));
+    slots_[slot] = {move(key), move(value)};
+    hashes_[slot] = hash;
+    ++size_;
+    --growth_left_;
+    return slots_[slot].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+void flat_hash_map<Key, Value, Hash, Equal>::reserve(const std::size_t count) {
+    using std::bit_ceil, std::size_t;
+
+    if (count <= size_ + growth_left_)
+        return;
+    const size_t slots = bit_ceil(count + count / 7U + 1U);
+    rehash(slots < group_size ? group_size : slots);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+constexpr std::size_t flat_hash_map<Key, Value, Hash, Equal>::size(
+) const noexcept {
+    return size_;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+std::uint32_t flat_hash_map<Key, Value, Hash, Equal>::match(
+    const uchar * const group,
+    const uchar tag
+) noexcept {
+#if defined(__SSE2__)
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+    std::uint32_t returns = 0U;
+    for (std::size_t i = 0U; i < group_size; ++i)
+        returns |= static_cast<std::uint32_t>(group[i] == tag) << i;
+    return returns;
+#endif
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+std::uint32_t flat_hash_map<Key, Value, Hash, Equal>::match_empty(
+    const uchar * const group
+) noexcept {
+#if defined(__SSE2__)
+    // Tags are below 0x80, so only empty slots have the high bit set.
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+    return match(group, empty);
+#endif
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+std::size_t flat_hash_map<Key, Value, Hash, Equal>::find_slot(
+    const Key &key,
+    const std::size_t hash
+) const {
+    using std::countr_zero, std::size_t, std::uint32_t;
+
+    if (slots_.empty()) [[unlikely]]
+        return none;
+    const size_t mask = slots_.size() - 1U;
+    const auto tag = static_cast<uchar>(hash & 0x7FU);
+    for (size_t position = (hash >> 7U) & mask, step = group_size; ;
+        position = (position + step) & mask, step += group_size
+    ) {
+        const uchar * const group = control_.data() + position;
+        for (uint32_t bits = match(group, tag); bits != 0U; bits &= bits - 1U)
+        {
+            const size_t slot =
+                (position + static_cast<size_t>(countr_zero(bits))) & mask;
+            if (hashes_[slot] == hash && equal_(slots_[slot].first, key))
+                [[likely]] return slot;
+        }
+        if (match_empty(group) != 0U) [[likely]]
+            return none;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+std::size_t flat_hash_map<Key, Value, Hash, Equal>::free_slot(
+    const std::size_t hash
+) const noexcept {
+    using std::countr_zero, std::size_t, std::uint32_t;
+
+    const size_t mask = slots_.size() - 1U;
+    for (size_t position = (hash >> 7U) & mask, step = group_size; ;
+        position = (position + step) & mask, step += group_size
+    ) if (const uint32_t bits = match_empty(control_.data() + position);
+        bits != 0U
+    ) return (position + static_cast<size_t>(countr_zero(bits))) & mask;
+}
+
+// Moves every pair to a table of the given power of two slots, placing it
+// by its cached hash.
+template<typename Key, typename Value, typename Hash, typename Equal>
+void flat_hash_map<Key, Value, Hash, Equal>::rehash(const std::size_t count) {
+    using std::move, std::size_t, std::vector;
+
+    vector<uchar> control(count + group_size, empty);
+    vector<value_type> slots(count);
+    vector<size_t> hashes(count, 0U);
+    control_.swap(control);
+    slots_.swap(slots);
+    hashes_.swap(hashes);
+    for (size_t i = 0U; i < slots.size(); ++i) {
+        if (control[i] == empty)
+            continue;
+        const size_t slot = free_slot(hashes[i]);
+        set_control(slot, control[i]);
+        slots_[slot] = move(slots[i]);
+        hashes_[slot] = hashes[i];
+    }
+    growth_left_ = count - count / 8U - size_;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal>
+void flat_hash_map<Key, Value, Hash, Equal>::set_control(
+    const std::size_t slot,
+    const uchar tag
+) noexcept {
+    control_[slot] = tag;
+    if (slot < group_size)
+        control_[slots_.size() + slot] = tag;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SEARCH_ENGINE_FREQUENCY_SKETCH_HPP
+#define SEARCH_ENGINE_FREQUENCY_SKETCH_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <algorithm> // min
+#include <array> // array
+#include <bit> // bit_ceil
+#include <vector> // vector
+
+#include <search_engine/types.hpp>
+
+// Count-min sketch of small saturating counters used to estimate how often a
+// key has been requested recently. Counters are halved after every sample
+// period, so the estimate follows changes in the query mix.
+class frequency_sketch final {
+public:
+    frequency_sketch() = default;
+    inline explicit frequency_sketch(std::size_t);
+    frequency_sketch(const frequency_sketch &) = default;
+    frequency_sketch(frequency_sketch &&) noexcept = default;
+    frequency_sketch &operator=(const frequency_sketch &) = default;
+    frequency_sketch &operator=(frequency_sketch &&) noexcept = default;
+    ~frequency_sketch() noexcept = default;
+
+    inline uint estimate(std::size_t) const noexcept;
+
+    inline void increment(std::size_t) noexcept;
+
+    inline void resize(std::size_t);
+
+private:
+    static constexpr std::size_t depth = 4U;
+    static constexpr uchar max_count = 15U;
+    static constexpr std::size_t sample_factor = 10U;
+    static constexpr std::array<std::uint64_t, depth> seeds = {{
+        0x9E3779B97F4A7C15U, 0xBF58476D1CE4E5B9U,
+        0x94D049BB133111EBU, 0xD6E8FEB86659FD93U
+    }};
+
+    static constexpr std::size_t mix(std::uint64_t) noexcept;
+
+    inline void reset() noexcept;
+
+    std::vector<uchar> counters_{};
+    std::size_t mask_ = 0U;
+    std::size_t additions_ = 0U;
+};
+
+inline frequency_sketch::frequency_sketch(const std::size_t width) {
+    resize(width);
+}
+
+inline uint frequency_sketch::estimate(const std::size_t hash) const noexcept {
+    using std::min;
+
+    if (counters_.empty()) [[unlikely]]
+        return 0U;
+    uint returns = max_count;
+    for (std::size_t i = 0U; i < depth; ++i)
+        returns = min<uint>(returns,
+            counters_[i * (mask_ + 1U) + (mix(hash ^ seeds[i]) & mask_)]);
+    return returns;
+}
+
+inline void frequency_sketch::increment(const std::size_t hash) noexcept {
+    if (counters_.empty()) [[unlikely]]
+        return;
+    for (std::size_t i = 0U; i < depth; ++i)
+        if (uchar &counter =
+                counters_[i * (mask_ + 1U) + (mix(hash ^ seeds[i]) & mask_)];
+            counter < max_count
+        ) ++counter;
+    if (++additions_ >= sample_factor * (mask_ + 1U)) [[unlikely]]
+        reset();
+}
+
+inline void frequency_sketch::resize(const std::size_t width) {
+    using std::bit_ceil;
+
+    const std::size_t size = width == 0U ? 0U : bit_ceil(width);
+    counters_.assign(size * depth, 0U);
+    mask_ = size == 0U ? 0U : size - 1U;
+    additions_ = 0U;
+}
+
+constexpr std::size_t frequency_sketch::mix(std::uint64_t value) noexcept {
+    value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9U;
+    value = (value ^ (value >> 27U)) * 0x94D049BB133111EBU;
+    return static_cast<std::size_t>(value ^ (value >> 31U));
+}
+
+inline void frequency_sketch::reset() noexcept {
+    for (uchar &counter : counters_)
+        counter >>= 1U;
+    additions_ /= 2U;
+}
+
+#endif
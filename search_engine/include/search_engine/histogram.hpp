@@ -0,0 +1,130 @@
+#ifndef SEARCH_ENGINE_HISTOGRAM_HPP
+#define SEARCH_ENGINE_HISTOGRAM_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <algorithm> // max, min
+#include <bit> // bit_width
+#include <cmath> // ceil
+#include <vector> // vector
+
+// HDR-style histogram of non-negative integer values. Values below
+// 2^precision are counted exactly; above, every power of two is split into
+// 2^(precision - 1) equal buckets, so a recorded value is known to within a
+// relative error of 2^(1 - precision) over the whole 64-bit range while
+// recording stays a few instructions.
+class histogram final {
+public:
+    static constexpr std::size_t precision = 7U;
+
+    inline histogram();
+    histogram(const histogram &) = default;
+    histogram(histogram &&) noexcept = default;
+    histogram &operator=(const histogram &) = default;
+    histogram &operator=(histogram &&) noexcept = default;
+    ~histogram() noexcept = default;
+
+    inline histogram &operator+=(const histogram &) noexcept;
+
+    constexpr std::uint64_t count() const noexcept;
+
+    constexpr std::uint64_t max() const noexcept;
+
+    inline double mean() const noexcept;
+
+    // Returns the highest value equivalent to the one at quantile q, [0, 1].
+    inline std::uint64_t quantile(double) const noexcept;
+
+    inline void record(std::uint64_t) noexcept;
+
+    inline void reset() noexcept;
+
+private:
+    static constexpr std::size_t exact = std::size_t{1} << precision;
+    static constexpr std::size_t half = exact / 2U;
+    static constexpr std::size_t buckets = (64U - precision) * half + exact;
+
+    static constexpr std::size_t bucket(std::uint64_t) noexcept;
+    static constexpr std::uint64_t highest(std::size_t) noexcept;
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_ = 0U;
+    std::uint64_t max_ = 0U;
+    double sum_ = 0.0;
+};
+
+inline histogram::histogram() : counts_(buckets, 0U) {}
+
+inline histogram &histogram::operator+=(const histogram &rhs) noexcept {
+    using std::max;
+
+    for (std::size_t i = 0U; i < buckets; ++i)
+        counts_[i] += rhs.counts_[i];
+    count_ += rhs.count_;
+    max_ = max(max_, rhs.max_);
+    sum_ += rhs.sum_;
+    return *this;
+}
+
+constexpr std::uint64_t histogram::count() const noexcept {
+    return count_;
+}
+
+constexpr std::uint64_t histogram::max() const noexcept {
+    return max_;
+}
+
+inline double histogram::mean() const noexcept {
+    return count_ == 0U ? 0.0 : sum_ / static_cast<double>(count_);
+}
+
+inline std::uint64_t histogram::quantile(const double q) const noexcept {
+    using std::ceil, std::max, std::min;
+
+    if (count_ == 0U) [[unlikely]]
+        return 0U;
+    const std::uint64_t rank = max<std::uint64_t>(1U,
+        static_cast<std::uint64_t>(
+            ceil(min(max(q, 0.0), 1.0) * static_cast<double>(count_))));
+    std::uint64_t seen = 0U;
+    for (std::size_t i = 0U; i < buckets; ++i)
+        if (seen += counts_[i]; seen >= rank)
+            return min(highest(i), max_);
+    return max_;
+}
+
+inline void histogram::record(const std::uint64_t value) noexcept {
+    using std::max;
+
+    ++counts_[bucket(value)];
+    ++count_;
+    max_ = max(max_, value);
+    sum_ += static_cast<double>(value);
+}
+
+inline void histogram::reset() noexcept {
+    counts_.assign(buckets, 0U);
+    count_ = max_ = 0U;
+    sum_ = 0.0;
+}
+
+constexpr std::size_t histogram::bucket(const std::uint64_t value) noexcept {
+    using std::bit_width;
+
+    if (value < exact)
+        return static_cast<std::size_t>(value);
+    const std::size_t shift = static_cast<std::size_t>(bit_width(value)) -
+        precision;
+    return shift * half + static_cast<std::size_t>(value >> shift);
+}
+
+constexpr std::uint64_t histogram::highest(const std::size_t index) noexcept {
+    if (index < exact)
+        return index;
+    const std::size_t shift = index / half - 1U;
+    const std::uint64_t mantissa = index % half + half;
+    return ((mantissa + 1U) << shift) - 1U;
+}
+
+#endif
@@ -1,37 +1,131 @@
 #ifndef SEARCH_ENGINE_INDEX_HPP
 #define SEARCH_ENGINE_INDEX_HPP
 
-#include <cstdint> // uint32_t
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
 
-#include <iostream> // istream, ostream
+#include <array> // array
+#include <iostream> // ostream
+#include <string> // string
 #include <string_view> // string_view
-#include <unordered_map> // unordered_map
 #include <vector> // vector
 
+#include <search_engine/flat_hash_map.hpp>
+#include <search_engine/posting_pool.hpp>
+
 class index final {
 public:
     using doc_id = std::uint32_t;
+    using term_id = std::uint32_t;
+
+    enum flag : std::uint32_t {
+        stop_words = 1U,
+        stem = 2U
+    };
+
+    // On-disk layout, every section offset is 8-byte aligned:
+    //   titles:     uint64_t offsets[documents + 1], chars
+    //   dictionary: uint64_t offsets[blocks + 1], front-coded sorted terms
+    //               (see dictionary)
+    //   hash:       minimal perfect hash of the terms (see perfect_hash)
+    //   grams:      character k-grams of the terms (see kgram_index)
+    //   postings:   uint64_t offsets[terms + 1], uint32_t frequencies[terms],
+    //               posting lists, each a container byte and the container
+    //               (see container)
+    struct header final {
+        std::array<char, 8> magic;
+        std::uint32_t flags;
+        std::uint32_t documents;
+        std::uint64_t terms;
+        std::uint64_t titles;
+        std::uint64_t dictionary;
+        std::uint64_t hash;
+        std::uint64_t grams;
+        std::uint64_t postings;
+        std::uint64_t size;
+    };
+
+    // Encodings of a posting list; each list takes the one that stores it
+    // in the fewest bytes, so frequent terms get bitmaps, which queries
+    // combine word by word (see bitmap.hpp).
+    enum container : unsigned char {
+        // Varbyte encoded d-gaps.
+        gaps = 0U,
+        // Varbyte encoded pairs of the gap before a run of consecutive ids
+        // and the length of the run minus one.
+        runs = 1U,
+        // Zero padding up to an 8-byte boundary and a bitmap of the
+        // documents, bit i % 64 of uint64_t word i / 64 for document i.
+        bitmap = 2U
+    };
+
+    static constexpr std::array<char, 8> magic = {{
+        'S', 'E', 'I', 'N', 'D', 'E', 'X', '6'
+    }};
 
-    constexpr index();
-    inline index(const index &) noexcept = default;
-    inline index(index &&) noexcept = default;
-    inline index &operator=(const index &) noexcept = default;
-    inline index &operator=(index &&) noexcept = default;
-    inline ~index() noexcept = default;
+    index() = default;
+    inline explicit index(std::uint32_t) noexcept;
+    // The keys of posting view the blocks of dictionary, which a copy would
+    // not share; a move keeps the blocks in place.
+    index(const index &) = delete;
+    index(index &&) noexcept = default;
+    index &operator=(const index &) = delete;
+    index &operator=(index &&) noexcept = default;
+    ~index() noexcept = default;
 
     doc_id insert_document(std::string_view);
+    // Appends sorted ids, offset by base, to the postings of a term; the
+    // bulk form of insert_term, used when merging indexes.
+    void insert_postings(std::string_view, const std::vector<doc_id> &,
+        doc_id);
+    void insert_term(doc_id, std::string_view);
+    // Makes room for the given number of distinct terms.
+    inline void reserve(std::size_t);
+
+    inline std::uint32_t flags() const noexcept;
+    inline std::size_t size() const noexcept;
+    inline std::string_view title(doc_id) const;
+
+    // Serializes the index in place into a writable memory map of the file,
+    // in the format of operator<<, and syncs it to disk.
+    void write(const char *) const;
 
-    // void insert_term(doc_id, std::string_view, size_t);
-    friend std::istream &operator>>(std::istream &, index &);
     friend std::ostream &operator<<(std::ostream &, const index &);
 
 private:
-    std::unordered_map<std::string_view, std::vector<doc_id>> posting{};
-    std::vector<char> dictionary{};
+    static constexpr std::size_t block_size = 1U << 20U;
+
+    struct sections;
+
+    std::string_view insert_string(std::string_view);
+    void prepare(sections &) const;
+
+    flat_hash_map<std::string_view, posting_pool::list> posting{};
+    posting_pool pool{};
+    std::vector<std::vector<char>> dictionary{};
+    std::string titles{};
+    std::vector<std::uint64_t> title_offsets{};
+    std::uint64_t flags_ = 0U;
 };
 
-constexpr index::index() {
-    dictionary.reserve(capacity);
+inline index::index(const std::uint32_t flags) noexcept : flags_(flags) {}
+
+inline std::uint32_t index::flags() const noexcept {
+    return static_cast<std::uint32_t>(flags_);
+}
+
+inline void index::reserve(const std::size_t terms) {
+    posting.reserve(terms);
+}
+
+inline std::size_t index::size() const noexcept {
+    return title_offsets.size();
+}
+
+inline std::string_view index::title(const doc_id id) const {
+    const std::size_t first = id == 0U ? 0U : title_offsets.at(id - 1U);
+    return std::string_view(titles).substr(first,
+        title_offsets.at(id) - first);
 }
 
 #endif
@@ -0,0 +1,117 @@
+#ifndef SEARCH_ENGINE_INDEX_VIEW_HPP
+#define SEARCH_ENGINE_INDEX_VIEW_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <array> // array
+#include <optional> // optional
+#include <string> // string
+#include <string_view> // string_view
+#include <utility> // pair
+#include <vector> // vector
+
+#include <search_engine/dictionary.hpp>
+#include <search_engine/index.hpp>
+#include <search_engine/kgram_index.hpp>
+#include <search_engine/perfect_hash.hpp>
+#include <search_engine/types.hpp>
+
+// The posting lists stored in one container, see index::container. Bytes
+// include the container byte and the padding of bitmaps.
+struct container_statistics final {
+    std::uint64_t lists = 0U;
+    std::uint64_t postings = 0U;
+    std::uint64_t bytes = 0U;
+};
+
+// Structural facts about an index, see index_view::stats. Sizes are in
+// bytes and include the alignment padding of their section.
+struct index_statistics final {
+    std::uint64_t documents = 0U;
+    std::uint64_t terms = 0U;
+    std::uint64_t postings = 0U;
+    // lengths[i] counts the posting lists of 2^i to 2^(i+1) - 1 documents.
+    std::vector<std::uint64_t> lengths{};
+    // Indexed by index::container.
+    std::array<container_statistics, 3U> containers{};
+    std::uint64_t header_bytes = 0U;
+    std::uint64_t title_bytes = 0U;
+    std::uint64_t dictionary_bytes = 0U;
+    std::uint64_t hash_bytes = 0U;
+    std::uint64_t gram_bytes = 0U;
+    // Offsets and frequencies of the posting lists.
+    std::uint64_t posting_table_bytes = 0U;
+    std::uint64_t posting_bytes = 0U;
+    // Total length of the terms, as stored without front coding.
+    std::uint64_t term_bytes = 0U;
+    // Terms with the longest posting lists and their lengths, longest first.
+    std::vector<std::pair<std::string, std::uint32_t>> longest{};
+};
+
+// Read-only view of a serialized index, typically backed by a memmap. The
+// view never copies the underlying bytes, so it is cheap to copy and safe to
+// share between threads.
+class index_view final {
+public:
+    using doc_id = index::doc_id;
+    using term_id = index::term_id;
+
+    constexpr index_view() noexcept = default;
+    explicit index_view(std::string_view);
+    constexpr index_view(const index_view &) noexcept = default;
+    constexpr index_view(index_view &&) noexcept = default;
+    constexpr index_view &operator=(const index_view &) noexcept = default;
+    constexpr index_view &operator=(index_view &&) noexcept = default;
+    constexpr ~index_view() noexcept = default;
+
+    // The words of a posting list stored as a bitmap, bitmap_words(size())
+    // of them, or nullptr if the list has another container.
+    const std::uint64_t *bitmap(term_id) const;
+    inline const class dictionary &dictionary() const noexcept;
+    // Stores the ids of up to limit terms matching a pattern where '*'
+    // stands for any sequence of characters.
+    void expand(std::string_view, std::size_t, std::vector<term_id> &) const;
+    std::optional<term_id> find(std::string_view) const;
+    inline std::uint32_t flags() const noexcept;
+    std::uint32_t frequency(term_id) const;
+    // Stores the ids of up to limit terms within an edit distance of a term.
+    void fuzzy(std::string_view, uint, std::size_t,
+        std::vector<term_id> &) const;
+    void postings(term_id, std::vector<doc_id> &) const;
+    inline std::size_t size() const noexcept;
+    std::string term(term_id) const;
+    inline std::size_t terms() const noexcept;
+    std::string_view title(doc_id) const;
+    // Walks the whole index; top is the number of longest lists to report.
+    index_statistics stats(std::size_t) const;
+
+private:
+    const index::header *header_ = nullptr;
+    const std::uint64_t *title_offsets_ = nullptr;
+    const std::uint64_t *posting_offsets_ = nullptr;
+    const std::uint32_t *frequencies_ = nullptr;
+    const char *titles_ = nullptr;
+    const char *postings_ = nullptr;
+    class dictionary dictionary_{};
+    perfect_hash hash_{};
+    kgram_index grams_{};
+};
+
+inline const class dictionary &index_view::dictionary() const noexcept {
+    return dictionary_;
+}
+
+inline std::uint32_t index_view::flags() const noexcept {
+    return header_ == nullptr ? 0U : header_->flags;
+}
+
+inline std::size_t index_view::size() const noexcept {
+    return header_ == nullptr ? 0U : header_->documents;
+}
+
+inline std::size_t index_view::terms() const noexcept {
+    return header_ == nullptr ? 0U : header_->terms;
+}
+
+#endif
@@ -1,9 +1,100 @@
 #ifndef SEARCH_ENGINE_INDEXER_HPP
 #define SEARCH_ENGINE_INDEXER_HPP
 
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <array> // array
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
 #include <search_engine/index.hpp>
 
+class doc_store_writer;
+
+// Time spent in one stage of the indexing pipeline and the volume of source
+// text that went through it, so that rates of different stages compare.
+struct stage_statistics final {
+    std::uint64_t wall_time = 0U; // nanoseconds
+    std::uint64_t cpu_time = 0U; // nanoseconds of the indexing thread
+    std::uint64_t bytes = 0U; // UTF-8 bytes of document text
+    std::uint64_t tokens = 0U; // tokenizer output
+};
+
+// Per-stage statistics of a profiled indexing run. The stages are run one
+// after another over every document instead of being chained character by
+// character, so the clocks are read only at stage boundaries.
+struct index_profile final {
+    static constexpr std::array<std::string_view, 8U> names = {{
+        "unescape", "decode", "tokenize", "normalize", "stem", "encode",
+        "insert", "invert"
+    }};
+
+    enum stage : std::size_t {
+        unescape, decode, tokenize, normalize, stem, encode, insert, invert
+    };
+
+    index_profile &operator+=(const index_profile &) noexcept;
+
+    std::array<stage_statistics, names.size()> stages{};
+};
+
+// How the terms of the documents become posting lists: every posting is
+// appended to the list of its term as it comes, or all of them are recorded
+// and radix sorted by term at the end (see inverter), which trades memory
+// for a bulk pass that runs on every thread.
+enum class inversion : unsigned char {
+    append, sort
+};
+
+// The class-key is required: <strings.h> declares a POSIX index() function.
+template<bool StopWords = false, bool Stem = false>
+class index make_index(const char *, inversion = inversion::append);
+
+// Indexes files holding consecutive pieces of one texts.json, as written by
+// webcrawler/split.sh, without joining them.
+template<bool StopWords = false, bool Stem = false>
+class index make_index(const std::vector<std::string> &,
+    inversion = inversion::append);
+
+// Builds the same index while accumulating per-stage statistics.
+template<bool StopWords = false, bool Stem = false>
+class index make_index(const std::vector<std::string> &, index_profile &,
+    inversion = inversion::append);
+
+// Also stores the title and raw text of every document, under its id.
 template<bool StopWords = false, bool Stem = false>
-index make_index(const char *);
+class index make_index(const std::vector<std::string> &, doc_store_writer &,
+    inversion = inversion::append);
+
+extern template class index make_index<false, false>(const char *, inversion);
+extern template class index make_index<false, true>(const char *, inversion);
+extern template class index make_index<true, false>(const char *, inversion);
+extern template class index make_index<true, true>(const char *, inversion);
+extern template class index make_index<false, false>(
+    const std::vector<std::string> &, inversion);
+extern template class index make_index<false, true>(
+    const std::vector<std::string> &, inversion);
+extern template class index make_index<true, false>(
+    const std::vector<std::string> &, inversion);
+extern template class index make_index<true, true>(
+    const std::vector<std::string> &, inversion);
+extern template class index make_index<false, false>(
+    const std::vector<std::string> &, index_profile &, inversion);
+extern template class index make_index<false, false>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+extern template class index make_index<false, true>(
+    const std::vector<std::string> &, index_profile &, inversion);
+extern template class index make_index<false, true>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+extern template class index make_index<true, false>(
+    const std::vector<std::string> &, index_profile &, inversion);
+extern template class index make_index<true, false>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+extern template class index make_index<true, true>(
+    const std::vector<std::string> &, index_profile &, inversion);
+extern template class index make_index<true, true>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
 
 #endif
@@ -0,0 +1,71 @@
+#ifndef SEARCH_ENGINE_INVERTER_HPP
+#define SEARCH_ENGINE_INVERTER_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <limits> // numeric_limits
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/flat_hash_map.hpp>
+#include <search_engine/index.hpp>
+
+// Sort-based inversion. Instead of appending every posting to the list of
+// its term as it comes, records (term id, document id) pairs in one array,
+// in document order, and at the end radix sorts them by term id, which
+// keeps the documents of a term in order, and sweeps them into the index
+// one whole posting list at a time. Indexing then only appends to a single
+// array, and the inversion runs at memory bandwidth on every thread.
+class inverter final {
+public:
+    using doc_id = index::doc_id;
+    using term_id = index::term_id;
+
+    inline explicit inverter(class index &, std::size_t = 1U) noexcept;
+    // The keys of ids_ and terms_ view the blocks of strings_, which a copy
+    // would not share; a move keeps the blocks in place.
+    inverter(const inverter &) = delete;
+    inverter(inverter &&) noexcept = default;
+    inverter &operator=(const inverter &) = delete;
+    inverter &operator=(inverter &&) noexcept = default;
+    ~inverter() noexcept = default;
+
+    // Sorts the records and inserts their postings into the index, leaving
+    // the inverter empty.
+    void finish();
+
+    // Records a term of a document of the index; documents come in order.
+    void insert_term(doc_id, std::string_view);
+
+    // The number of records so far.
+    inline std::size_t size() const noexcept;
+
+private:
+    static constexpr std::size_t block_size = 1U << 20U;
+
+    struct term final {
+        term_id id = 0U;
+        // The last document recorded, which drops repeated terms.
+        doc_id last = std::numeric_limits<doc_id>::max();
+    };
+
+    std::string_view insert_string(std::string_view);
+
+    class index *index_;
+    std::size_t threads_;
+    flat_hash_map<std::string_view, term> ids_{};
+    std::vector<std::string_view> terms_{};
+    std::vector<std::vector<char>> strings_{};
+    // The term id in the high half and the document id in the low half.
+    std::vector<std::uint64_t> records_{};
+};
+
+inline inverter::inverter(class index &built, const std::size_t threads)
+    noexcept : index_(&built), threads_(threads) {}
+
+inline std::size_t inverter::size() const noexcept {
+    return records_.size();
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SEARCH_ENGINE_KGRAM_INDEX_HPP
+#define SEARCH_ENGINE_KGRAM_INDEX_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/dictionary.hpp>
+#include <search_engine/index.hpp>
+
+// Read-only view of a character k-gram index: every gram of one to k code
+// points of the terms, padded with boundary on both sides, maps to the sorted
+// ids of the terms containing it; the lone boundary is left out. The shorter
+// grams serve wildcard fragments of fewer than k code points, such as the
+// "т" of "*т*". Grams are front-coded like the term dictionary and the id
+// lists are varbyte encoded d-gaps.
+//
+// Serialized as:
+//   uint64_t grams, block bytes, posting bytes,
+//   uint64_t block_offsets[blocks + 1], uint64_t posting_offsets[grams + 1],
+//   front-coded grams padded to 8, varbyte encoded ids padded to 8
+class kgram_index final {
+public:
+    using term_id = index::term_id;
+
+    static constexpr std::size_t k = 3U;
+    static constexpr char boundary = '$';
+
+    constexpr kgram_index() noexcept = default;
+    kgram_index(const char *, std::size_t);
+    constexpr kgram_index(const kgram_index &) noexcept = default;
+    constexpr kgram_index(kgram_index &&) noexcept = default;
+    constexpr kgram_index &operator=(const kgram_index &) noexcept = default;
+    constexpr kgram_index &operator=(kgram_index &&) noexcept = default;
+    constexpr ~kgram_index() noexcept = default;
+
+    // Builds the index of sorted unique terms, term ids being their positions.
+    static std::string encode(const std::vector<std::string_view> &);
+
+    // Appends the k-grams of a UTF-8 string, or the string itself when it is
+    // shorter than k code points and not empty or the lone boundary.
+    static void grams(std::string_view, std::vector<std::string_view> &);
+
+    // Stores the ids of the terms containing the gram.
+    void find(std::string_view, std::vector<term_id> &) const;
+
+    constexpr std::size_t size() const noexcept;
+
+private:
+    dictionary grams_{};
+    const std::uint64_t *posting_offsets_ = nullptr;
+    const char *postings_ = nullptr;
+};
+
+constexpr std::size_t kgram_index::size() const noexcept {
+    return grams_.size();
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SEARCH_ENGINE_LEVENSHTEIN_AUTOMATON_HPP
+#define SEARCH_ENGINE_LEVENSHTEIN_AUTOMATON_HPP
+
+#include <cstddef> // size_t
+
+#include <algorithm> // lower_bound, min, min_element, sort, unique
+#include <limits> // numeric_limits
+#include <string> // string, wstring
+#include <string_view> // wstring_view
+#include <unordered_map> // unordered_map
+#include <utility> // move
+#include <vector> // vector
+
+#include <search_engine/types.hpp>
+
+// Deterministic automaton accepting the words within a maximum Levenshtein
+// distance of a pattern. A state is a row of the edit distance matrix with
+// the values capped at distance + 1, so there are finitely many of them. The
+// DFA is built lazily: states are numbered as they are first reached and
+// their transitions are cached for every distinct character of the pattern
+// plus one class for all other characters.
+class levenshtein_automaton final {
+public:
+    using state = std::size_t;
+
+    static constexpr state dead = 0U;
+
+    inline levenshtein_automaton(std::wstring_view, uint);
+    levenshtein_automaton(const levenshtein_automaton &) = default;
+    levenshtein_automaton(levenshtein_automaton &&) noexcept = default;
+    levenshtein_automaton &operator=(const levenshtein_automaton &) = default;
+    levenshtein_automaton &operator=(levenshtein_automaton &&) noexcept =
+        default;
+    ~levenshtein_automaton() noexcept = default;
+
+    inline bool is_match(state) const noexcept;
+
+    static constexpr state start() noexcept;
+
+    inline state step(state, wchar_t);
+
+private:
+    static constexpr state unknown = std::numeric_limits<state>::max();
+
+    inline state insert(std::string &&);
+    inline std::size_t symbol(wchar_t) const noexcept;
+
+    std::wstring pattern_;
+    std::wstring alphabet_;
+    std::vector<std::string> rows_;
+    std::unordered_map<std::string, state> states_{};
+    std::vector<state> transitions_{};
+    std::size_t distance_;
+};
+
+inline levenshtein_automaton::levenshtein_automaton(
+    const std::wstring_view pattern,
+    const uint distance
+) : pattern_(pattern), alphabet_(pattern), rows_(1U),
+    distance_(std::min(distance, 254U)) {
+    using std::min, std::sort, std::string, std::unique;
+
+    sort(alphabet_.begin(), alphabet_.end());
+    alphabet_.erase(unique(alphabet_.begin(), alphabet_.end()),
+        alphabet_.end());
+    transitions_.assign(alphabet_.size() + 1U, dead);
+
+    string row(pattern_.size() + 1U, '\0');
+    for (std::size_t i = 0U; i < row.size(); ++i)
+        row[i] = static_cast<char>(min<std::size_t>(i, distance_ + 1U));
+    insert(std::move(row));
+}
+
+inline bool levenshtein_automaton::is_match(const state current
+) const noexcept {
+    return current != dead &&
+        static_cast<uchar>(rows_[current].back()) <= distance_;
+}
+
+constexpr auto levenshtein_automaton::start() noexcept -> state {
+    return 1U;
+}
+
+inline auto levenshtein_automaton::step(
+    const state current,
+    const wchar_t wc
+) -> state {
+    using std::min, std::string;
+
+    if (current == dead)
+        return dead;
+    const std::size_t transition =
+        current * (alphabet_.size() + 1U) + symbol(wc);
+    if (transitions_[transition] != unknown)
+        return transitions_[transition];
+
+    const string &row = rows_[current];
+    const uint cap = static_cast<uint>(distance_) + 1U;
+    string returns(row.size(), '\0');
+    returns[0] = static_cast<char>(min(static_cast<uchar>(row[0]) + 1U, cap));
+    for (std::size_t i = 1U; i < row.size(); ++i)
+        returns[i] = static_cast<char>(min({
+            static_cast<uchar>(row[i - 1U]) +
+                (pattern_[i - 1U] == wc ? 0U : 1U),
+            static_cast<uchar>(row[i]) + 1U,
+            static_cast<uchar>(returns[i - 1U]) + 1U,
+            cap
+        }));
+    return transitions_[transition] = insert(std::move(returns));
+}
+
+// Returns dead for rows that exceed the distance everywhere.
+inline auto levenshtein_automaton::insert(std::string &&row) -> state {
+    if (static_cast<uchar>(*std::min_element(row.cbegin(), row.cend())) >
+        distance_
+    ) return dead;
+    if (const auto iter = states_.find(row); iter != states_.end())
+        return iter->second;
+    const state returns = rows_.size();
+    states_.emplace(row, returns);
+    rows_.push_back(std::move(row));
+    transitions_.resize(transitions_.size() + alphabet_.size() + 1U, unknown);
+    return returns;
+}
+
+inline std::size_t levenshtein_automaton::symbol(const wchar_t wc
+) const noexcept {
+    const auto iter =
+        std::lower_bound(alphabet_.cbegin(), alphabet_.cend(), wc);
+    return iter != alphabet_.cend() && *iter == wc ?
+        static_cast<std::size_t>(iter - alphabet_.cbegin()) : alphabet_.size();
+}
+
+#endif
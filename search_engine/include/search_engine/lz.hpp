@@ -0,0 +1,147 @@
+#ifndef SEARCH_ENGINE_LZ_HPP
+#define SEARCH_ENGINE_LZ_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+#include <algorithm> // min
+#include <stdexcept> // logic_error
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/types.hpp>
+
+// Byte-oriented LZ77 compression in the manner of LZ4. A greedy parse finds
+// matches of at least lz_min_match bytes within the last lz_window bytes
+// through a hash table of 4-byte prefixes, and the output is a series of
+// sequences: a token holding 4 bits of the literal length and 4 bits of the
+// match length, the rest of the literal length, the literals, a 16-bit
+// little-endian offset and the rest of the match length. Lengths that do
+// not fit in their 4 bits continue in bytes, 255 meaning that another byte
+// follows. The last sequence ends after its literals. There is no entropy
+// coding, so decompression costs a few instructions per byte.
+
+inline constexpr std::size_t lz_min_match = 4U;
+inline constexpr std::size_t lz_window = 0xFFFFU;
+
+// Appends the compressed input to the output.
+inline void lz_compress(std::string_view, std::string &);
+
+// Replaces the output with the decompressed input, which must decompress to
+// exactly size bytes.
+inline void lz_decompress(std::string_view, std::size_t, std::string &);
+
+inline void lz_compress(const std::string_view input, std::string &output) {
+    using std::min, std::size_t, std::uint32_t, std::vector;
+    static constexpr uint hash_bits = 14U;
+
+    const auto load = [&input](const size_t i) noexcept -> uint32_t {
+        return static_cast<uint32_t>(static_cast<uchar>(input[i])) |
+            static_cast<uint32_t>(static_cast<uchar>(input[i + 1U])) << 8U |
+            static_cast<uint32_t>(static_cast<uchar>(input[i + 2U])) << 16U |
+            static_cast<uint32_t>(static_cast<uchar>(input[i + 3U])) << 24U;
+    };
+    const auto put_length = [&output](size_t length) -> void {
+        for (; length >= 0xFFU; length -= 0xFFU)
+            output.push_back(static_cast<char>(0xFFU));
+        output.push_back(static_cast<char>(length));
+    };
+    // A match length of 0 stands for the final sequence.
+    const auto put_sequence = [&](const size_t anchor, const size_t literals,
+        const size_t offset, const size_t length
+    ) -> void {
+        const size_t extra = length == 0U ? 0U : length - lz_min_match;
+        output.push_back(static_cast<char>(min<size_t>(literals, 15U) << 4U |
+            min<size_t>(extra, 15U)));
+        if (literals >= 15U)
+            put_length(literals - 15U);
+        output.append(input.substr(anchor, literals));
+        if (length == 0U)
+            return;
+        output.push_back(static_cast<char>(offset & 0xFFU));
+        output.push_back(static_cast<char>(offset >> 8U));
+        if (extra >= 15U)
+            put_length(extra - 15U);
+    };
+
+    // Positions plus one, so that zero marks an empty slot.
+    vector<uint32_t> table(size_t{1} << hash_bits, 0U);
+    size_t anchor = 0U, i = 0U;
+    while (i + lz_min_match <= input.size()) {
+        const uint32_t word = load(i);
+        uint32_t &slot = table[(word * 2654435761U) >> (32U - hash_bits)];
+        const size_t candidate = slot;
+        slot = static_cast<uint32_t>(i + 1U);
+        if (candidate == 0U || i + 1U - candidate > lz_window ||
+            load(candidate - 1U) != word
+        ) {
+            ++i;
+            continue;
+        }
+
+        const size_t match = candidate - 1U;
+        size_t length = lz_min_match;
+        while (i + length < input.size() &&
+            input[match + length] == input[i + length]
+        ) ++length;
+        put_sequence(anchor, i - anchor, i - match, length);
+        i += length;
+        anchor = i;
+    }
+    put_sequence(anchor, input.size() - anchor, 0U, 0U);
+}
+
+inline void lz_decompress(
+    const std::string_view input,
+    const std::size_t size,
+    std::string &output
+) {
+    using std::logic_error, std::size_t;
+    static constexpr const char *invalid = "lz_decompress: invalid data";
+
+    size_t i = 0U;
+    const auto get_length = [&input, &i](size_t length) -> size_t {
+        if (length != 15U)
+            return length;
+        for (uchar byte = 0xFFU; byte == 0xFFU; length += byte) {
+            if (i == input.size()) [[unlikely]]
+                throw logic_error(invalid);
+            byte = static_cast<uchar>(input[i++]);
+        }
+        return length;
+    };
+
+    output.clear();
+    output.reserve(size);
+    while (i < input.size()) {
+        const uchar token = static_cast<uchar>(input[i++]);
+        const size_t literals = get_length(token >> 4U);
+        if (literals > input.size() - i || literals > size - output.size())
+            [[unlikely]] throw logic_error(invalid);
+        output.append(input.substr(i, literals));
+        i += literals;
+        if (i == input.size())
+            break;
+
+        if (input.size() - i < 2U) [[unlikely]]
+            throw logic_error(invalid);
+        const size_t offset = static_cast<uchar>(input[i]) |
+            static_cast<size_t>(static_cast<uchar>(input[i + 1U])) << 8U;
+        i += 2U;
+        const size_t length = get_length(token & 0xFU) + lz_min_match;
+        if (offset == 0U || offset > output.size() ||
+            length > size - output.size()
+        ) [[unlikely]] throw logic_error(invalid);
+        // Byte by byte, as the match may overlap what it copies.
+        const size_t first = output.size();
+        output.resize(first + length);
+        char * const data = output.data();
+        for (size_t j = first; j < first + length; ++j)
+            data[j] = data[j - offset];
+    }
+    if (output.size() != size) [[unlikely]]
+        throw logic_error(invalid);
+}
+
+#endif
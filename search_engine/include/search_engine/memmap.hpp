@@ -11,21 +11,40 @@
 #include <string_view> // string_view
 #include <utility> // move, swap
 
+#include <search_engine/types.hpp>
+
+// Read-only shared memory map of a whole file. Options passed to open tell
+// the kernel how the map is going to be used; scans additionally report
+// their progress with advance, which keeps a window of readahead in front of
+// them and can drop what they have left behind from memory.
 class memmap final {
 public:
+    enum option : uint {
+        // MADV_SEQUENTIAL: aggressive readahead, early reclaim.
+        sequential = 1U,
+        // MAP_POPULATE: fault the whole file in at open.
+        populate = 2U,
+        // MADV_HUGEPAGE: back the map with huge pages where supported.
+        huge_pages = 4U
+    };
+
     memmap() noexcept;
-    inline explicit memmap(const char *);
+    inline explicit memmap(const char *, uint = 0U);
     constexpr memmap(const memmap &) noexcept = delete;
     memmap(memmap &&);
     constexpr memmap &operator=(const memmap &) noexcept = delete;
     memmap &operator=(memmap &&);
     ~memmap() noexcept;
 
+    // Requests the window bytes after offset with MADV_WILLNEED and, if
+    // release is set, drops the pages before offset from the process and
+    // from the page cache. Calls are cheap when the cursor moves little.
+    void advance(std::size_t, std::size_t, bool = false);
     void close();
     const char *data() const;
     constexpr bool empty() const;
     constexpr bool is_open() const noexcept;
-    void open(const char *);
+    void open(const char *, uint = 0U);
     inline explicit operator std::string_view() const;
     constexpr std::size_t size() const;
     constexpr void swap(memmap &) noexcept;
@@ -54,13 +73,19 @@ private:
 
     using size_limits = std::numeric_limits<size_t>;
 
+    // The map holds its own reference to the file, so the descriptor is
+    // only open while the file is being mapped.
     const void *addr_;
     std::size_t size_ = size_limits::max();
-    file file_{};
+    // End of the range already advised with MADV_WILLNEED.
+    std::size_t advised_ = 0U;
+    // End of the range already released.
+    std::size_t released_ = 0U;
 };
 
-inline memmap::memmap(const char * const filename) : memmap() {
-    open(filename);
+inline memmap::memmap(const char * const filename, const uint options)
+    : memmap() {
+    open(filename, options);
 }
 
 constexpr bool memmap::empty() const {
@@ -68,7 +93,7 @@ constexpr bool memmap::empty() const {
 }
 
 constexpr bool memmap::is_open() const noexcept {
-    return file_.is_open();
+    return size_ != size_limits::max();
 }
 
 inline memmap::operator std::string_view() const {
@@ -90,7 +115,8 @@ constexpr void memmap::swap(memmap &rhs) noexcept {
 
     swap(addr_, rhs.addr_);
     swap(size_, rhs.size_);
-    file_.swap(rhs.file_);
+    swap(advised_, rhs.advised_);
+    swap(released_, rhs.released_);
 }
 
 inline memmap::file::file(const char * const filename) {
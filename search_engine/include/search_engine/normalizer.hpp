@@ -52,7 +52,7 @@ private:
 
     static constexpr std::wstring_view possessive_affix = L"'s";
 
-    static constexpr std::array<std::wstring_view, 184U> stop_words = {
+    static constexpr std::array<std::wstring_view, 184U> stop_words = {{
         L"a", L"an", L"and", L"are", L"as", L"at", L"be", L"but", L"by", L"for",
         L"if", L"in", L"into", L"is", L"it", L"no", L"not", L"of", L"on", L"or",
         L"such", L"that", L"the", L"their", L"then", L"there", L"these",
@@ -77,7 +77,7 @@ private:
         L"ты", L"у", L"уж", L"уже", L"хорошо", L"хоть", L"чего", L"чем",
         L"через", L"что", L"чтоб", L"чтобы", L"чуть", L"эти", L"этого", L"этой",
         L"этом", L"этот", L"эту", L"я"
-    };
+    }};
     static_assert(
         std::is_sorted(stop_words.cbegin(), stop_words.cend()) &&
         std::adjacent_find(
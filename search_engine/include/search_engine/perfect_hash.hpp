@@ -0,0 +1,107 @@
+#ifndef SEARCH_ENGINE_PERFECT_HASH_HPP
+#define SEARCH_ENGINE_PERFECT_HASH_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <optional> // optional
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/index.hpp>
+#include <search_engine/types.hpp>
+
+// Read-only view of a minimal perfect hash over the term set (BBHash). Every
+// level is a bit array of about gamma bits per key still unplaced; a key sets
+// its bit on the first level where it does not collide, and its slot is the
+// rank of that bit. The few keys left after max_levels are stored in a sorted
+// fallback table. Each slot holds the term id and an 8-bit fingerprint of the
+// key, which rejects most absent terms without touching the dictionary.
+//
+// Serialized as uint64_t words:
+//   levels, fallbacks, offsets[levels + 1] (in words),
+//   bits[offsets[levels]], ranks[(offsets[levels] + 7) / 8],
+//   fallback (hash, slot) pairs, uint32_t ids[keys], uchar fingerprints[keys]
+class perfect_hash final {
+public:
+    using term_id = index::term_id;
+
+    constexpr perfect_hash() noexcept = default;
+    perfect_hash(const std::uint64_t *, std::size_t, std::size_t);
+    constexpr perfect_hash(const perfect_hash &) noexcept = default;
+    constexpr perfect_hash(perfect_hash &&) noexcept = default;
+    constexpr perfect_hash &operator=(const perfect_hash &) noexcept = default;
+    constexpr perfect_hash &operator=(perfect_hash &&) noexcept = default;
+    constexpr ~perfect_hash() noexcept = default;
+
+    // Builds the hash for unique terms, term ids being their positions.
+    static std::vector<std::uint64_t> encode(
+        const std::vector<std::string_view> &);
+
+    // Returns the id the term would have if present; absent terms yield
+    // either nothing or the id of another term.
+    std::optional<term_id> find(std::string_view) const noexcept;
+
+    constexpr std::size_t size() const noexcept;
+
+private:
+    // Level size in bits per key, as a fraction.
+    static constexpr std::size_t gamma_numerator = 3U;
+    static constexpr std::size_t gamma_denominator = 2U;
+    static constexpr std::size_t max_levels = 32U;
+    // Words of bits covered by one entry of ranks.
+    static constexpr std::size_t rank_words = 8U;
+
+    static constexpr uchar fingerprint(std::uint64_t) noexcept;
+    static constexpr std::uint64_t hash(std::string_view) noexcept;
+    static constexpr std::uint64_t mix(std::uint64_t) noexcept;
+    static constexpr std::size_t position(std::uint64_t, std::size_t,
+        std::size_t) noexcept;
+
+    std::optional<std::size_t> slot(std::uint64_t) const noexcept;
+
+    const std::uint64_t *offsets_ = nullptr;
+    const std::uint64_t *bits_ = nullptr;
+    const std::uint64_t *ranks_ = nullptr;
+    const std::uint64_t *fallback_ = nullptr;
+    const std::uint32_t *ids_ = nullptr;
+    const uchar *fingerprints_ = nullptr;
+    std::size_t levels_ = 0U;
+    std::size_t fallbacks_ = 0U;
+    std::size_t size_ = 0U;
+};
+
+constexpr std::size_t perfect_hash::size() const noexcept {
+    return size_;
+}
+
+constexpr uchar perfect_hash::fingerprint(const std::uint64_t value) noexcept {
+    return static_cast<uchar>(value >> 56U);
+}
+
+// FNV-1a followed by a finalizer, since the low bits pick the positions.
+constexpr std::uint64_t perfect_hash::hash(
+    const std::string_view str
+) noexcept {
+    std::uint64_t returns = 0xCBF29CE484222325U;
+    for (const char c : str)
+        returns = (returns ^ static_cast<uchar>(c)) * 0x100000001B3U;
+    return mix(returns);
+}
+
+constexpr std::uint64_t perfect_hash::mix(std::uint64_t value) noexcept {
+    value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9U;
+    value = (value ^ (value >> 27U)) * 0x94D049BB133111EBU;
+    return value ^ (value >> 31U);
+}
+
+constexpr std::size_t perfect_hash::position(
+    const std::uint64_t value,
+    const std::size_t level,
+    const std::size_t bits
+) noexcept {
+    return static_cast<std::size_t>(
+        mix(value + (level + 1U) * 0x9E3779B97F4A7C15U) % bits);
+}
+
+#endif
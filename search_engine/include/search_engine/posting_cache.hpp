@@ -0,0 +1,58 @@
+#ifndef SEARCH_ENGINE_POSTING_CACHE_HPP
+#define SEARCH_ENGINE_POSTING_CACHE_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <vector> // vector
+
+#include <search_engine/cache.hpp>
+#include <search_engine/index.hpp>
+
+// Second-level cache used by searcher below the result cache: decoded posting
+// lists of hot terms and materialized intersections of hot term pairs. Both
+// admit new entries by observed frequency, so the long tail of rare terms does
+// not push out the shared cores of popular queries.
+class posting_cache final {
+public:
+    using postings_type = std::vector<index::doc_id>;
+    using list_cache = cache<index::term_id, postings_type, true>;
+    using pair_cache = cache<std::uint64_t, postings_type, true>;
+
+    inline explicit posting_cache(std::size_t);
+    posting_cache(const posting_cache &) = delete;
+    posting_cache(posting_cache &&) = delete;
+    posting_cache &operator=(const posting_cache &) = delete;
+    posting_cache &operator=(posting_cache &&) = delete;
+    ~posting_cache() noexcept = default;
+
+    static constexpr std::uint64_t key(index::term_id, index::term_id) noexcept;
+
+    inline list_cache &lists() noexcept;
+
+    inline pair_cache &pairs() noexcept;
+
+private:
+    list_cache lists_;
+    pair_cache pairs_;
+};
+
+inline posting_cache::posting_cache(const std::size_t capacity)
+    : lists_(capacity / 2U), pairs_(capacity - capacity / 2U) {}
+
+constexpr std::uint64_t posting_cache::key(
+    const index::term_id lhs,
+    const index::term_id rhs
+) noexcept {
+    return lhs < rhs ? static_cast<std::uint64_t>(lhs) << 32U | rhs
+        : static_cast<std::uint64_t>(rhs) << 32U | lhs;
+}
+
+inline auto posting_cache::lists() noexcept -> list_cache & {
+    return lists_;
+}
+
+inline auto posting_cache::pairs() noexcept -> pair_cache & {
+    return pairs_;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SEARCH_ENGINE_POSTING_POOL_HPP
+#define SEARCH_ENGINE_POSTING_POOL_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <vector> // vector
+
+// Slab allocator for the posting lists of an index being built. A list is a
+// chain of blocks of document ids carved out of large slabs; each block is
+// as large as the list so far, between min_block and max_block ids, so the
+// blocks of a list grow geometrically and then stay bounded. A full block
+// ends with the position of the next one. Rare terms take a few bytes
+// instead of a heap allocation, and frequent terms never copy their ids.
+class posting_pool final {
+public:
+    using doc_id = std::uint32_t;
+
+    // The head of a list: where its first block starts and where its next
+    // id goes, in units of ids from the start of the first slab.
+    struct list final {
+        std::uint64_t first = 0U;
+        std::uint64_t tail = 0U;
+        std::uint32_t size = 0U;
+        // Ids that still fit in the last block.
+        std::uint32_t free = 0U;
+    };
+
+    static constexpr std::size_t min_block = 4U;
+    static constexpr std::size_t max_block = 1U << 10U;
+    static constexpr std::size_t slab_size = 1U << 20U;
+
+    posting_pool() = default;
+    posting_pool(const posting_pool &) = default;
+    posting_pool(posting_pool &&) noexcept = default;
+    posting_pool &operator=(const posting_pool &) = default;
+    posting_pool &operator=(posting_pool &&) noexcept = default;
+    ~posting_pool() noexcept = default;
+
+    inline void append(list &, doc_id);
+
+    // Bytes of the slabs allocated so far.
+    inline std::size_t capacity() const noexcept;
+
+    // Replaces the contents of the vector with the ids of a list.
+    void copy(const list &, std::vector<doc_id> &) const;
+
+    // The last id appended to a non-empty list.
+    inline doc_id back(const list &) const noexcept;
+
+private:
+    // Ids of the position of the next block at the end of a full one.
+    static constexpr std::size_t link_size = 2U;
+
+    // The number of ids of the block that follows size ids.
+    static constexpr std::size_t block_size(std::size_t) noexcept;
+
+    inline doc_id &at(std::uint64_t) noexcept;
+    inline const doc_id &at(std::uint64_t) const noexcept;
+
+    std::uint64_t allocate(std::size_t);
+    void grow(list &);
+
+    std::vector<std::vector<doc_id>> slabs_{};
+    std::size_t used_ = slab_size;
+};
+
+inline void posting_pool::append(list &postings, const doc_id id) {
+    if (postings.free == 0U) [[unlikely]]
+        grow(postings);
+    at(postings.tail++) = id;
+    --postings.free;
+    ++postings.size;
+}
+
+inline std::size_t posting_pool::capacity() const noexcept {
+    return slabs_.size() * slab_size * sizeof(doc_id);
+}
+
+inline auto posting_pool::back(const list &postings) const noexcept
+    -> doc_id {
+    return at(postings.tail - 1U);
+}
+
+constexpr std::size_t posting_pool::block_size(const std::size_t size)
+    noexcept {
+    return size < min_block ? min_block : size > max_block ? max_block : size;
+}
+
+inline auto posting_pool::at(const std::uint64_t position) noexcept
+    -> doc_id & {
+    return slabs_[position / slab_size][position % slab_size];
+}
+
+inline auto posting_pool::at(const std::uint64_t position) const noexcept
+    -> const doc_id & {
+    return slabs_[position / slab_size][position % slab_size];
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef SEARCH_ENGINE_RADIX_SORT_HPP
+#define SEARCH_ENGINE_RADIX_SORT_HPP
+
+#include <cstddef> // size_t
+
+#include <algorithm> // clamp, max, min
+#include <array> // array
+#include <thread> // jthread
+#include <type_traits> // invoke_result_t, is_unsigned_v, remove_cvref_t
+#include <vector> // vector
+
+// The fewest values worth a thread of their own.
+inline constexpr std::size_t radix_slice = 1U << 16U;
+
+// Stable least significant digit radix sort of values by an unsigned integer
+// key, one byte of the key per pass. The values are cut into one slice per
+// thread; a pass counts the digits of every slice and then every thread
+// scatters its slice to the positions that the counts give it, so passes
+// stream through memory without comparing anything. Passes over the bytes
+// that every key has in common, like the high bytes of small keys, are
+// skipped, so sorting by a term id takes as many passes as the id has
+// significant bytes.
+template<typename T, typename Key>
+void radix_sort(std::vector<T> &values, const Key key,
+    const std::size_t threads = 1U
+) {
+    using std::array, std::clamp, std::jthread, std::max, std::min,
+        std::size_t, std::vector;
+    using key_type =
+        std::remove_cvref_t<std::invoke_result_t<const Key &, const T &>>;
+    using counts = array<size_t, 256U>;
+    static_assert(std::is_unsigned_v<key_type>,
+        "radix_sort: keys must be unsigned integers");
+    static constexpr size_t passes = sizeof(key_type);
+
+    const size_t size = values.size(), workers =
+        clamp<size_t>(size / radix_slice, 1U, max<size_t>(threads, 1U)),
+        slice = (size + workers - 1U) / workers;
+    const auto parallel = [workers](const auto &work) -> void {
+        vector<jthread> running;
+        running.reserve(workers - 1U);
+        for (size_t worker = 1U; worker < workers; ++worker)
+            running.emplace_back(work, worker);
+        work(size_t{0U});
+    };
+    const auto digit = [&key](const T &value, const size_t pass) noexcept {
+        return static_cast<size_t>(key(value) >> pass * 8U) & 0xFFU;
+    };
+
+    // A byte that is the same in every key is set in all of them or in none.
+    vector<key_type> all(workers, static_cast<key_type>(~key_type{0U})),
+        any(workers, key_type{0U});
+    parallel([&](const size_t worker) noexcept -> void {
+        key_type in_all = all[worker], in_any = any[worker];
+        for (size_t i = min(size, worker * slice),
+            last = min(size, i + slice); i < last; ++i
+        ) {
+            const key_type current = key(values[i]);
+            in_all &= current;
+            in_any |= current;
+        }
+        all[worker] = in_all;
+        any[worker] = in_any;
+    });
+    for (size_t worker = 1U; worker < workers; ++worker) {
+        all.front() &= all[worker];
+        any.front() |= any[worker];
+    }
+    const auto varying = static_cast<key_type>(all.front() ^ any.front());
+
+    vector<T> scratch;
+    vector<counts> next(workers);
+    for (size_t pass = 0U; pass < passes; ++pass) {
+        if ((static_cast<size_t>(varying >> pass * 8U) & 0xFFU) == 0U)
+            continue;
+
+        parallel([&](const size_t worker) noexcept -> void {
+            counts &count = next[worker];
+            count.fill(0U);
+            for (size_t i = min(size, worker * slice),
+                last = min(size, i + slice); i < last; ++i
+            ) ++count[digit(values[i], pass)];
+        });
+        // Slices of a digit go in slice order, which keeps the sort stable.
+        for (size_t d = 0U, position = 0U; d < counts{}.size(); ++d)
+            for (counts &count : next) {
+                const size_t current = count[d];
+                count[d] = position;
+                position += current;
+            }
+
+        scratch.resize(size);
+        parallel([&](const size_t worker) noexcept -> void {
+            // A copy that stores to the values cannot alias.
+            counts position = next[worker];
+            T * const sorted = scratch.data();
+            for (size_t i = min(size, worker * slice),
+                last = min(size, i + slice); i < last; ++i
+            ) sorted[position[digit(values[i], pass)]++] = values[i];
+        });
+        values.swap(scratch);
+    }
+}
+
+#endif
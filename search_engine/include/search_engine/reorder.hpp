@@ -0,0 +1,37 @@
+#ifndef SEARCH_ENGINE_REORDER_HPP
+#define SEARCH_ENGINE_REORDER_HPP
+
+#include <cstddef> // size_t
+
+#include <vector> // vector
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index.hpp>
+#include <search_engine/index_view.hpp>
+
+// Offline document reordering. Ids are assigned in the order of texts.json,
+// which sorts articles by title, so the documents of a term are spread over
+// the whole id range. Recursive graph bisection (Dhulipala et al., KDD 2016)
+// splits the documents in two halves and swaps documents between them while
+// that lowers the estimated cost of the d-gaps of every term, a logarithmic
+// function of its degrees in both halves, then recurses into both halves.
+// Documents sharing terms end up with nearby ids, which shortens d-gaps and
+// makes intersections skip more.
+
+inline constexpr std::size_t default_bisection_iterations = 20U;
+
+// Returns the new order of the documents: the old id of the document that
+// gets new id i is at position i. Terms of a single document do not affect
+// the order and are ignored. The top levels of the recursion run on up to
+// the given number of threads.
+std::vector<index::doc_id> bisection_order(const index_view &, std::size_t,
+    std::size_t = default_bisection_iterations);
+
+// Rebuilds an index with the documents renumbered in the given order.
+class index reorder(const index_view &, const std::vector<index::doc_id> &);
+
+// Copies the documents of a store in the given order and finishes the copy.
+void reorder(const doc_store &, const std::vector<index::doc_id> &,
+    doc_store_writer &);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SEARCH_ENGINE_SEARCHER_HPP
+#define SEARCH_ENGINE_SEARCHER_HPP
+
+#include <cstddef> // size_t
+
+#include <memory> // shared_ptr
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/index.hpp>
+#include <search_engine/index_view.hpp>
+#include <search_engine/posting_cache.hpp>
+#include <search_engine/tombstones.hpp>
+#include <search_engine/types.hpp>
+
+// Evaluates conjunctive queries against an index_view. Query text runs through
+// the same analyzer configuration the index was built with. Words containing
+// '*' are wildcard patterns and words ending in '~' or '~N' are fuzzy terms
+// matching within edit distance N (1 by default, at most 2); each one matches
+// the union of the postings of up to max_expansions terms. An optional
+// posting_cache, shared between searchers, keeps hot posting lists and term
+// pair intersections decoded.
+class searcher final {
+public:
+    static constexpr std::size_t default_max_expansions = 1024U;
+
+    explicit searcher(const index_view &, posting_cache * = nullptr,
+        std::size_t = default_max_expansions);
+    searcher(const searcher &) noexcept = default;
+    searcher(searcher &&) noexcept = default;
+    searcher &operator=(const searcher &) noexcept = default;
+    searcher &operator=(searcher &&) noexcept = default;
+    ~searcher() noexcept = default;
+
+    std::vector<index::doc_id> operator()(std::string_view) const;
+
+    // Leaves out the documents deleted in the tombstones, if any, which
+    // cover the documents of the index.
+    std::vector<index::doc_id> evaluate(const std::vector<std::string> &,
+        const tombstones * = nullptr) const;
+
+    std::vector<std::string> terms(std::string_view) const;
+
+    inline const index_view &view() const noexcept;
+
+private:
+    using analyze_type = std::vector<std::string> (*)(std::string_view);
+    using postings_type = posting_cache::postings_type;
+
+    static constexpr uint default_distance = 1U;
+    static constexpr uint max_distance = 2U;
+    // Queries with more terms only look up the pair of the two rarest ones.
+    static constexpr std::size_t max_pair_terms = 8U;
+    // Expansions whose lists hold at least one posting per that many
+    // documents are unioned in a bitmap rather than merged.
+    static constexpr std::size_t dense_union = 8U;
+
+    postings_type expand(std::string_view, const tombstones *) const;
+
+    std::shared_ptr<const postings_type> intersect(
+        const std::vector<index::term_id> &, std::size_t &, std::size_t &
+    ) const;
+
+    std::string pattern(std::string_view) const;
+
+    std::shared_ptr<const postings_type> postings(index::term_id) const;
+
+    index_view view_;
+    analyze_type analyze_;
+    analyze_type suffix_;
+    posting_cache *cache_;
+    std::size_t max_expansions_;
+};
+
+inline const index_view &searcher::view() const noexcept {
+    return view_;
+}
+
+#endif
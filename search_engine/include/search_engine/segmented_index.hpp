@@ -0,0 +1,136 @@
+#ifndef SEARCH_ENGINE_SEGMENTED_INDEX_HPP
+#define SEARCH_ENGINE_SEGMENTED_INDEX_HPP
+
+#include <condition_variable> // condition_variable
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <exception> // exception_ptr
+#include <memory> // shared_ptr
+#include <mutex> // mutex
+#include <string> // string
+#include <string_view> // string_view
+#include <thread> // thread
+#include <unordered_set> // unordered_set
+#include <vector> // vector
+
+#include <search_engine/index.hpp>
+#include <search_engine/tombstones.hpp>
+
+// A directory of immutable index segments in the format of index::write,
+// listed in order by a manifest file. New documents are indexed in memory
+// and flushed as a new segment at the end; a background thread merges runs
+// of adjacent segments of the same size tier into one, so every document is
+// rewritten O(log n) times and the number of segments stays logarithmic.
+// Document ids are global, those of a segment following those of the
+// segments before it. Deleted documents are marked in a tombstone bitmap
+// per segment, skipped as queries intersect its postings and dropped by the
+// next merge of the segment, which renumbers the documents after them.
+// Tombstones are never rewritten in place: every change goes to a new file,
+// which the manifest lists next to its segment, so that one rename of the
+// manifest commits new segments and deletions together. Queries take a
+// snapshot of the segment list and fan out over it, so they never wait for a
+// merge; ids are only meaningful within the snapshot of the query that
+// returned them. One process at a time may open a directory.
+class segmented_index final {
+public:
+    using doc_id = index::doc_id;
+
+    // Segments merged at once; a segment of tier t holds at least
+    // merge_factor^t documents.
+    static constexpr std::size_t merge_factor = 4U;
+
+    // Opens the directory, creating it if needed; the flags are those of
+    // new segments and must match the existing ones.
+    explicit segmented_index(const char *,
+        std::uint32_t = index::stop_words | index::stem);
+    segmented_index(const segmented_index &) = delete;
+    segmented_index(segmented_index &&) = delete;
+    segmented_index &operator=(const segmented_index &) = delete;
+    segmented_index &operator=(segmented_index &&) = delete;
+    // Stops the merge thread once the merge in progress, if any, is done.
+    ~segmented_index() noexcept;
+
+    // Adds the documents as a new segment, deleting the older documents
+    // with the same titles in the same step, so that appending re-fetched
+    // articles updates them, and schedules merges.
+    void append(const class index &);
+    // Indexes texts files, see make_index, and appends them.
+    void append(const std::vector<std::string> &);
+
+    std::vector<doc_id> operator()(std::string_view) const;
+    // Also stores the titles of up to limit first results, looked up in the
+    // same snapshot as the query.
+    std::vector<doc_id> operator()(std::string_view, std::size_t,
+        std::vector<std::string> &) const;
+
+    inline std::uint32_t flags() const noexcept;
+
+    // Deletes the documents with any of the titles and returns their number.
+    std::size_t remove(const std::vector<std::string> &);
+
+    std::size_t segments() const;
+
+    // Number of documents that are not deleted.
+    std::size_t size() const;
+
+    std::string title(doc_id) const;
+
+    // Blocks until no merge is pending and rethrows the error of a failed
+    // one.
+    void wait();
+
+private:
+    struct segment;
+
+    // A segment and its tombstones, null while nothing in it is deleted,
+    // with the name of their file.
+    struct part final {
+        std::shared_ptr<const segment> file;
+        std::shared_ptr<const tombstones> deleted;
+        std::string deleted_name;
+    };
+
+    using snapshot = std::vector<part>;
+
+    // State of the merge thread; stopped is final.
+    enum class state {
+        idle, merging, stopped
+    };
+
+    static bool find_run(const snapshot &, std::size_t &) noexcept;
+    static std::size_t live(const part &) noexcept;
+    static std::size_t tier(std::size_t) noexcept;
+
+    std::size_t bury(snapshot &,
+        const std::unordered_set<std::string_view> &,
+        std::vector<std::string> &);
+    std::shared_ptr<const snapshot> current() const;
+    std::shared_ptr<const tombstones> load(const std::string &,
+        std::size_t) const;
+    void merge() noexcept;
+    std::string next_name(std::string_view, std::string_view);
+    void publish(const snapshot &);
+    void unlink(const std::vector<std::string> &) const noexcept;
+    std::string write(const tombstones &);
+
+    std::string directory_;
+    std::shared_ptr<const snapshot> segments_;
+    // Guards the state of appends and merges, which includes disk I/O.
+    mutable std::mutex mutex_{};
+    // Guards segments_ alone, so that queries never wait for the disk;
+    // segments_ only changes with both mutexes held.
+    mutable std::mutex snapshot_mutex_{};
+    std::condition_variable changed_{};
+    std::exception_ptr error_{};
+    std::thread thread_{};
+    std::uint64_t next_name_ = 0U;
+    std::uint32_t flags_;
+    state state_ = state::idle;
+};
+
+inline std::uint32_t segmented_index::flags() const noexcept {
+    return flags_;
+}
+
+#endif
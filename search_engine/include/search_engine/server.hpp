@@ -0,0 +1,86 @@
+#ifndef SEARCH_ENGINE_SERVER_HPP
+#define SEARCH_ENGINE_SERVER_HPP
+
+#include <atomic> // atomic
+#include <condition_variable> // condition_variable
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <deque> // deque
+#include <exception> // exception_ptr
+#include <functional> // function
+#include <mutex> // mutex
+#include <string> // string
+#include <string_view> // string_view
+#include <thread> // thread
+#include <unordered_map> // unordered_map
+#include <vector> // vector
+
+// Serves a line-based protocol on a Unix domain socket. Every '\n' terminated
+// request is passed to the handler on a worker thread and the text it appends
+// to the response is written back verbatim. Requests from one connection are
+// answered in order, requests from different connections run concurrently.
+class server final {
+public:
+    using handler = std::function<void(std::string_view, std::string &)>;
+
+    server(const char *, const handler &, std::size_t);
+    server(const server &) = delete;
+    server(server &&) = delete;
+    server &operator=(const server &) = delete;
+    server &operator=(server &&) = delete;
+    ~server() noexcept;
+
+    void run();
+    void stop() noexcept;
+
+private:
+    static constexpr std::size_t max_request_size = 1U << 16U;
+    static constexpr std::uint64_t listener_id = 0U, event_id = 1U,
+        first_id = 2U;
+
+    struct connection final {
+        std::string input{};
+        std::string output{};
+        int fildes = -1;
+        bool busy = false;
+        bool closing = false;
+        bool reading = true;
+        bool writing = false;
+    };
+
+    struct task final {
+        std::uint64_t id = 0U;
+        std::string text{};
+        std::exception_ptr error{};
+    };
+
+    void accept();
+    void close(std::uint64_t) noexcept;
+    void complete();
+    void dispatch(std::uint64_t, connection &);
+    bool flush(std::uint64_t, connection &);
+    void receive(std::uint64_t);
+    void release() noexcept;
+    void shutdown() noexcept;
+    bool update(std::uint64_t, connection &);
+    void work();
+
+    handler handler_;
+    std::string path_;
+    std::unordered_map<std::uint64_t, connection> connections_{};
+    std::deque<task> tasks_{};
+    std::vector<task> results_{};
+    std::vector<std::thread> workers_{};
+    std::mutex tasks_mutex_{};
+    std::mutex results_mutex_{};
+    std::condition_variable tasks_ready_{};
+    std::size_t concurrency_;
+    std::uint64_t next_id_ = first_id;
+    int epoll_ = -1;
+    int event_ = -1;
+    int listener_ = -1;
+    std::atomic<int> stopping_ = 0;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SEARCH_ENGINE_SNIPPETS_HPP
+#define SEARCH_ENGINE_SNIPPETS_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index.hpp>
+
+// Query-biased snippets: the windows of a document text that best cover the
+// terms of a query, as returned by searcher::terms. The text goes through
+// the analyzer chain of the index again, keeping the byte range of every
+// token, and a window of a fixed number of tokens slides over the result;
+// the best windows hold the most distinct query terms, then the most
+// matches. Only the first max_scan bytes of a text are analyzed, which
+// bounds the work per hit whatever the length of the document.
+class snippet_generator final {
+public:
+    static constexpr std::size_t default_window = 24U;
+    static constexpr std::size_t default_snippets = 2U;
+    static constexpr std::size_t default_max_scan = 1U << 15U;
+
+    // Takes the flags of the index; window is in tokens.
+    explicit snippet_generator(std::uint32_t,
+        std::size_t = default_window, std::size_t = default_snippets,
+        std::size_t = default_max_scan);
+    snippet_generator(const snippet_generator &) noexcept = default;
+    snippet_generator(snippet_generator &&) noexcept = default;
+    snippet_generator &operator=(const snippet_generator &) noexcept =
+        default;
+    snippet_generator &operator=(snippet_generator &&) noexcept = default;
+    ~snippet_generator() noexcept = default;
+
+    // Appends the windows in text order, separated by " ... ", with matched
+    // tokens between '[' and ']' and line breaks turned into spaces.
+    void operator()(std::string_view, const std::vector<std::string> &,
+        std::string &) const;
+
+    // Snippets of up to limit first documents, fetched from a store. Large
+    // batches are spread over up to the given number of threads.
+    std::vector<std::string> operator()(const doc_store &,
+        const std::vector<index::doc_id> &, std::size_t,
+        const std::vector<std::string> &, std::size_t) const;
+
+private:
+    // A token of the text and its term, empty for stop words.
+    struct token final {
+        std::size_t first;
+        std::size_t last;
+        std::string term;
+    };
+
+    using tokenize_type = void (*)(std::string_view, std::vector<token> &);
+
+    // Texts scanned in total below which threads do not pay off.
+    static constexpr std::size_t parallel_bytes = 1U << 16U;
+
+    template<bool StopWords, bool Stem>
+    static void tokenize(std::string_view, std::vector<token> &);
+
+    tokenize_type tokenize_;
+    std::size_t window_;
+    std::size_t snippets_;
+    std::size_t max_scan_;
+};
+
+#endif
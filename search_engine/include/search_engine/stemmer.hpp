@@ -45,7 +45,7 @@ private:
 
     static constexpr std::size_t size_before_suffix = 2U;
 
-    static constexpr std::array<std::wstring_view, 73U> suffixes = {
+    static constexpr std::array<std::wstring_view, 73U> suffixes = {{
         L"ing", L"eing", L"al", L"s", L"es", L"ness", L"ly",
 
         L"а", L"ила", L"ев", L"ьев", L"ив", L"ов", L"ёв", L"е", L"ее", L"ие",
@@ -55,7 +55,7 @@ private:
         L"ём", L"о", L"ого", L"ло", L"ило", L"у", L"ому", L"ах", L"их", L"ых",
         L"ях", L"иях", L"ьях", L"ы", L"ь", L"ившись", L"ывшись", L"ясь", L"ть",
         L"ишь", L"ю", L"ою", L"ую", L"ью", L"я", L"ая", L"ья"
-    };
+    }};
     static_assert(
         std::is_sorted(suffixes.cbegin(), suffixes.cend(),
             [](
@@ -2,7 +2,9 @@
 #define SEARCH_ENGINE_STR_PARSER_HPP
 
 #include <cassert> // assert
+#include <cstddef> // size_t
 
+#include <array> // array
 #include <stdexcept> // logic_error
 #include <string_view> // string_view
 #include <type_traits> // is_invocable_r_v
@@ -32,6 +34,18 @@ public:
         std::string_view::const_iterator
     );
 
+    // Parses a string that may be split across several ranges: the first
+    // call starts at the opening quote and the following ones continue where
+    // the previous range ended, even inside an escape sequence. Returns the
+    // iterator past the closing quote, or last if the string goes on.
+    constexpr std::string_view::const_iterator resume(
+        std::string_view::const_iterator,
+        std::string_view::const_iterator
+    );
+
+    // Whether resume stopped inside a string.
+    constexpr bool is_partial() const noexcept;
+
     constexpr const Invocable &invocable() const noexcept;
     constexpr Invocable &invocable() noexcept;
 
@@ -42,12 +56,18 @@ private:
 
     static constexpr uint hex_digit(char);
 
+    constexpr std::size_t escape_size() const noexcept;
+
     constexpr std::string_view::const_iterator parse_escape(
         std::string_view::const_iterator,
         std::string_view::const_iterator
     );
 
     Invocable invocable_{};
+    // Escape sequence cut by the end of a range, backslash included.
+    std::array<char, 6U> pending_{};
+    uchar pending_size_ = 0U;
+    bool is_partial_ = false;
 };
 
 template<typename Invocable>
@@ -94,6 +114,55 @@ constexpr std::string_view::const_iterator str_parser<Invocable>::operator()(
     return first + 1;
 }
 
+template<typename Invocable>
+constexpr std::string_view::const_iterator str_parser<Invocable>::resume(
+    std::string_view::const_iterator first,
+    const std::string_view::const_iterator last
+) {
+    using std::logic_error, std::string_view;
+
+    if (!is_partial_) {
+        if (first == last)
+            return first;
+        else if (*first != '\"') [[unlikely]]
+            throw logic_error("str_parser::resume: invalid string");
+        ++first;
+        is_partial_ = true;
+    }
+
+    if (pending_size_ != 0U) [[unlikely]] {
+        while (first < last && pending_size_ < escape_size())
+            pending_[pending_size_++] = *first++;
+        if (pending_size_ < escape_size())
+            return last;
+        const string_view escape(pending_.data(), pending_size_);
+        pending_size_ = 0U;
+        parse_escape(escape.cbegin() + 1, escape.cend());
+    }
+
+    while (first < last) {
+        if (*first == '\"') [[unlikely]] {
+            is_partial_ = false;
+            return first + 1;
+        } else if (*first == '\\') [[unlikely]] {
+            if (const auto size = last - first;
+                size > 1 && (first[1] != 'u' || size > 5)
+            ) [[likely]] first = parse_escape(first + 1, last);
+            else {
+                while (first < last)
+                    pending_[pending_size_++] = *first++;
+            }
+        } else [[likely]]
+            invocable_(*first++);
+    }
+    return last;
+}
+
+template<typename Invocable>
+constexpr bool str_parser<Invocable>::is_partial() const noexcept {
+    return is_partial_;
+}
+
 template<typename Invocable>
 constexpr const Invocable &str_parser<Invocable>::invocable() const noexcept {
     return invocable_;
@@ -116,6 +185,12 @@ constexpr uint str_parser<Invocable>::hex_digit(const char c) {
         throw logic_error("str_parser::hex_digit: invalid hex digit");
 }
 
+// Length of the pending escape sequence, known once its second character is.
+template<typename Invocable>
+constexpr std::size_t str_parser<Invocable>::escape_size() const noexcept {
+    return pending_size_ < 2U || pending_[1] != 'u' ? 2U : 6U;
+}
+
 template<typename Invocable>
 constexpr std::string_view::const_iterator str_parser<Invocable>::parse_escape(
     const std::string_view::const_iterator first,
@@ -0,0 +1,71 @@
+#ifndef SEARCH_ENGINE_STREAM_READER_HPP
+#define SEARCH_ENGINE_STREAM_READER_HPP
+
+#include <condition_variable> // condition_variable
+#include <cstddef> // size_t
+
+#include <array> // array
+#include <limits> // numeric_limits
+#include <mutex> // mutex
+#include <string_view> // string_view
+#include <thread> // thread
+#include <vector> // vector
+
+// Reads a pipe, a terminal or any other file descriptor that cannot be
+// mapped. A background thread fills a fixed ring of buffers with read(2)
+// while the consumer parses the previous ones, so memory use does not depend
+// on the input size and reading overlaps with parsing. A buffer is handed
+// over as soon as more input would block, so a slow writer does not hold up
+// the parser, and the thread waits for input with poll(2) on the descriptor
+// and on a pipe that the destructor writes to, so that it never blocks the
+// destruction of the reader.
+class stream_reader final {
+public:
+    static constexpr std::size_t default_buffers = 4U;
+    static constexpr std::size_t default_buffer_size = 1U << 22U;
+
+    // The descriptor stays owned by the caller.
+    explicit stream_reader(int, std::size_t = default_buffers,
+        std::size_t = default_buffer_size);
+    stream_reader(const stream_reader &) = delete;
+    stream_reader(stream_reader &&) = delete;
+    stream_reader &operator=(const stream_reader &) = delete;
+    stream_reader &operator=(stream_reader &&) = delete;
+    ~stream_reader() noexcept;
+
+    // Returns the next piece of input, valid until the following call, or
+    // an empty view at the end of the input. Rethrows read errors.
+    std::string_view next();
+
+private:
+    struct buffer final {
+        std::vector<char> data{};
+        std::size_t size = 0U;
+    };
+
+    using size_limits = std::numeric_limits<std::size_t>;
+
+    void fill() noexcept;
+
+    std::vector<buffer> buffers_;
+    std::mutex mutex_{};
+    std::condition_variable filled_{};
+    std::condition_variable emptied_{};
+    std::thread thread_{};
+    // Buffers handed out so far, buffers given back so far and buffers
+    // filled so far; the ring index is the count modulo the number of
+    // buffers. The consumer parses the last buffer handed out until its next
+    // call, which gives it back.
+    std::size_t consumed_ = 0U;
+    std::size_t released_ = 0U;
+    std::size_t produced_ = 0U;
+    // Buffers filled when the input ended or failed.
+    std::size_t end_ = size_limits::max();
+    // Read and write ends of the pipe that stops the thread.
+    std::array<int, 2> stop_{{-1, -1}};
+    int fildes_;
+    // errno of the failed read, or ECANCELED once the reader is destroyed.
+    int errnum_ = 0;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef SEARCH_ENGINE_TEXTS_PARSER_HPP
+#define SEARCH_ENGINE_TEXTS_PARSER_HPP
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+
+#include <stdexcept> // logic_error
+#include <string> // string
+#include <string_view> // string_view
+#include <type_traits> // is_invocable_r_v
+
+#include <search_engine/str_parser.hpp>
+
+// Push parser for the {"title": "text", ...} object of texts.json that takes
+// its input in pieces of any size, such as the chunks of
+// webcrawler/split.sh, keeping its state, and that of the string parsers,
+// between them. For every member it calls Title with the title, passes the
+// unescaped characters of the text to Text and then calls End.
+template<typename Title, typename Text, typename End>
+class texts_parser final {
+public:
+    constexpr texts_parser(const Title &, const Text &, const End &);
+    texts_parser(const texts_parser &) = delete;
+    texts_parser(texts_parser &&) = delete;
+    texts_parser &operator=(const texts_parser &) = delete;
+    texts_parser &operator=(texts_parser &&) = delete;
+    constexpr ~texts_parser() noexcept = default;
+
+    constexpr void operator()(std::string_view);
+
+    // Checks that the object is complete.
+    constexpr void finish() const;
+
+private:
+    static_assert(std::is_invocable_r_v<void, Title, const std::string &>,
+        "Title must have signature void(const string &)"
+    );
+    static_assert(std::is_invocable_r_v<void, End>,
+        "End must have signature void()"
+    );
+
+    static constexpr const char *invalid = "texts_parser: invalid JSON";
+
+    enum class state : std::size_t {
+        start, key, title, colon, value, text, next, end
+    };
+
+    class append final {
+    public:
+        constexpr explicit append(std::string &str) noexcept : str_(&str) {}
+
+        constexpr void operator()(const char c) const { str_->push_back(c); }
+
+    private:
+        std::string *str_;
+    };
+
+    std::string title_{};
+    str_parser<append> title_parser_;
+    str_parser<Text> text_parser_;
+    Title on_title_;
+    End on_end_;
+    state state_ = state::start;
+};
+
+template<typename Title, typename Text, typename End>
+constexpr texts_parser<Title, Text, End>::texts_parser(
+    const Title &on_title,
+    const Text &text,
+    const End &on_end
+) : title_parser_(append(title_)), text_parser_(text), on_title_(on_title),
+    on_end_(on_end) {}
+
+template<typename Title, typename Text, typename End>
+constexpr void texts_parser<Title, Text, End>::operator()(
+    const std::string_view input
+) {
+    using std::logic_error;
+
+    for (auto first = input.cbegin(), last = input.cend(); first < last; ) {
+        if (state_ != state::start && state_ != state::title &&
+            state_ != state::text && (*first == ' ' || *first == '\n' ||
+                *first == '\r' || *first == '\t')
+        ) {
+            ++first;
+            continue;
+        }
+        switch (state_) {
+            case state::start:
+                if (*first != '{') [[unlikely]]
+                    throw logic_error(invalid);
+                ++first;
+                state_ = state::key;
+                break;
+            case state::key:
+                if (*first == '}') {
+                    ++first;
+                    state_ = state::end;
+                } else {
+                    title_.clear();
+                    state_ = state::title;
+                }
+                break;
+            case state::title:
+                first = title_parser_.resume(first, last);
+                if (!title_parser_.is_partial())
+                    state_ = state::colon;
+                break;
+            case state::colon:
+                if (*first != ':') [[unlikely]]
+                    throw logic_error(invalid);
+                else if (title_.empty()) [[unlikely]]
+                    throw logic_error("texts_parser: empty title");
+                ++first;
+                state_ = state::value;
+                break;
+            case state::value:
+                on_title_(title_);
+                state_ = state::text;
+                break;
+            case state::text:
+                first = text_parser_.resume(first, last);
+                if (!text_parser_.is_partial()) {
+                    on_end_();
+                    state_ = state::next;
+                }
+                break;
+            case state::next:
+                if (*first == ',')
+                    state_ = state::key;
+                else if (*first == '}')
+                    state_ = state::end;
+                else [[unlikely]]
+                    throw logic_error(invalid);
+                ++first;
+                break;
+            case state::end:
+                return;
+            default:
+                assert(false);
+        }
+    }
+}
+
+template<typename Title, typename Text, typename End>
+constexpr void texts_parser<Title, Text, End>::finish() const {
+    using std::logic_error;
+
+    // Any character of a non-empty input leaves the start state or throws.
+    if (state_ == state::start) [[unlikely]]
+        throw logic_error("texts_parser: input is empty");
+    else if (state_ != state::end) [[unlikely]]
+        throw logic_error(invalid);
+}
+
+#endif
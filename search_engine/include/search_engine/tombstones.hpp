@@ -0,0 +1,94 @@
+#ifndef SEARCH_ENGINE_TOMBSTONES_HPP
+#define SEARCH_ENGINE_TOMBSTONES_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <bit> // popcount
+#include <stdexcept> // out_of_range
+#include <utility> // move
+#include <vector> // vector
+
+#include <search_engine/index.hpp>
+
+// Deletion bitmap of an index segment: bit i of word i / 64 is set once
+// document i is deleted. A lookup is one shift and one mask of a word, cheap
+// enough to test every posting of a result.
+class tombstones final {
+public:
+    using doc_id = index::doc_id;
+
+    inline explicit tombstones(std::size_t);
+    // Takes the words as stored in a file.
+    inline tombstones(std::size_t, std::vector<std::uint64_t> &&);
+    tombstones(const tombstones &) = default;
+    tombstones(tombstones &&) noexcept = default;
+    tombstones &operator=(const tombstones &) = default;
+    tombstones &operator=(tombstones &&) noexcept = default;
+    ~tombstones() noexcept = default;
+
+    constexpr bool contains(doc_id) const noexcept;
+
+    constexpr std::size_t count() const noexcept;
+
+    inline void insert(doc_id);
+
+    // Number of documents covered.
+    constexpr std::size_t size() const noexcept;
+
+    constexpr const std::vector<std::uint64_t> &words() const noexcept;
+
+private:
+    std::vector<std::uint64_t> words_;
+    std::size_t size_;
+    std::size_t count_ = 0U;
+};
+
+inline tombstones::tombstones(const std::size_t documents)
+    : words_((documents + 63U) / 64U, 0U), size_(documents) {}
+
+inline tombstones::tombstones(
+    const std::size_t documents,
+    std::vector<std::uint64_t> &&words
+) : words_(std::move(words)), size_(documents) {
+    using std::out_of_range, std::popcount;
+
+    if (words_.size() != (documents + 63U) / 64U ||
+        (documents % 64U != 0U && !words_.empty() &&
+            words_.back() >> (documents % 64U) != 0U)
+    ) [[unlikely]] throw out_of_range(
+        "tombstones::tombstones: bitmap does not match the documents");
+    for (const std::uint64_t word : words_)
+        count_ += static_cast<std::size_t>(popcount(word));
+}
+
+constexpr bool tombstones::contains(const doc_id id) const noexcept {
+    return id < size_ && (words_[id / 64U] >> (id % 64U) & 1U) != 0U;
+}
+
+constexpr std::size_t tombstones::count() const noexcept {
+    return count_;
+}
+
+inline void tombstones::insert(const doc_id id) {
+    using std::out_of_range;
+
+    if (id >= size_) [[unlikely]]
+        throw out_of_range("tombstones::insert: document is out of range");
+    const std::uint64_t bit = std::uint64_t{1} << (id % 64U);
+    if ((words_[id / 64U] & bit) == 0U) {
+        words_[id / 64U] |= bit;
+        ++count_;
+    }
+}
+
+constexpr std::size_t tombstones::size() const noexcept {
+    return size_;
+}
+
+constexpr const std::vector<std::uint64_t> &tombstones::words()
+    const noexcept {
+    return words_;
+}
+
+#endif
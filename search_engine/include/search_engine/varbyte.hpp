@@ -0,0 +1,43 @@
+#ifndef SEARCH_ENGINE_VARBYTE_HPP
+#define SEARCH_ENGINE_VARBYTE_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+#include <stdexcept> // logic_error
+
+#include <search_engine/types.hpp>
+
+template<class OutputIter>
+constexpr OutputIter varbyte_encode(std::uint32_t value, OutputIter out) {
+    for (; value >= 0x80U; value >>= 7U)
+        *out++ = static_cast<char>((value & 0x7FU) | 0x80U);
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+constexpr std::size_t varbyte_size(std::uint32_t value) noexcept {
+    std::size_t size = 1U;
+    for (; value >= 0x80U; value >>= 7U)
+        ++size;
+    return size;
+}
+
+constexpr const char *varbyte_decode(
+    const char *first,
+    const char * const last,
+    std::uint32_t &value
+) {
+    using std::logic_error, std::uint32_t;
+
+    value = 0U;
+    for (uint shift = 0U; first < last && shift < 35U; shift += 7U) {
+        const uchar byte = static_cast<uchar>(*first++);
+        value |= static_cast<uint32_t>(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0U) [[likely]]
+            return first;
+    }
+    throw logic_error("varbyte_decode: invalid value");
+}
+
+#endif
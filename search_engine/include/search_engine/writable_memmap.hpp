@@ -0,0 +1,49 @@
+#ifndef SEARCH_ENGINE_WRITABLE_MEMMAP_HPP
+#define SEARCH_ENGINE_WRITABLE_MEMMAP_HPP
+
+#include <cstddef> // size_t
+
+#include <limits> // numeric_limits
+
+// Shared read-write memory map of a new file of a known size, the output
+// counterpart of memmap. The file is created or truncated and its blocks are
+// allocated up front, so that running out of disk space is reported by the
+// constructor rather than as SIGBUS on a store into the map. Nothing is
+// guaranteed to be on disk until sync returns.
+class writable_memmap final {
+public:
+    writable_memmap(const char *, std::size_t);
+    writable_memmap(const writable_memmap &) = delete;
+    writable_memmap(writable_memmap &&) = delete;
+    writable_memmap &operator=(const writable_memmap &) = delete;
+    writable_memmap &operator=(writable_memmap &&) = delete;
+    ~writable_memmap() noexcept;
+
+    // Unmaps the file without waiting for writeback.
+    void close();
+    char *data() const;
+    constexpr bool is_open() const noexcept;
+    constexpr std::size_t size() const noexcept;
+    // Writes the dirty pages back with msync, returning once they are on
+    // disk along with the metadata needed to read them, as fdatasync does.
+    // The descriptor is closed after mapping, so there is no fsync.
+    void sync() const;
+
+private:
+    using size_limits = std::numeric_limits<std::size_t>;
+
+    // The map holds its own reference to the file, so the descriptor is
+    // only open while the file is being mapped.
+    void *addr_;
+    std::size_t size_;
+};
+
+constexpr bool writable_memmap::is_open() const noexcept {
+    return size_ != size_limits::max();
+}
+
+constexpr std::size_t writable_memmap::size() const noexcept {
+    return size_;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstdlib> // free, malloc
+
+#include <new> // bad_alloc, get_new_handler, new_handler
+
+#include <search_engine/allocations.hpp>
+
+static thread_local std::uint64_t count = 0U;
+
+std::uint64_t allocations() noexcept {
+    return count;
+}
+
+// The array, nothrow and sized forms of the standard library forward here.
+void *operator new(const std::size_t size) {
+    using std::bad_alloc, std::get_new_handler, std::malloc, std::new_handler;
+
+    ++count;
+    for (;;) {
+        if (void * const ptr = malloc(size == 0U ? 1U : size)) [[likely]]
+            return ptr;
+        const new_handler handler = get_new_handler();
+        if (handler == nullptr) [[unlikely]]
+            throw bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void * const ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * const ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,156 @@
+#include <cstdint> // uint32_t, uint64_t
+
+#include <algorithm> // mismatch
+#include <iterator> // back_inserter
+#include <ranges> // iota_view
+#include <stdexcept> // logic_error, out_of_range
+
+#include <search_engine/algorithm.hpp>
+#include <search_engine/dictionary.hpp>
+#include <search_engine/varbyte.hpp>
+
+using std::logic_error, std::optional, std::size_t, std::string,
+    std::string_view, std::uint32_t, std::uint64_t, std::vector;
+
+dictionary::dictionary(
+    const uint64_t * const offsets,
+    const char * const blocks,
+    const size_t size
+) : offsets_(offsets), blocks_(blocks), size_(size) {
+    const size_t count = dictionary::blocks(size);
+    if (offsets_[0] != 0U) [[unlikely]]
+        throw logic_error("dictionary::dictionary: invalid dictionary");
+    for (size_t i = 1U; i <= count; ++i)
+        if (offsets_[i] <= offsets_[i - 1U]) [[unlikely]]
+            throw logic_error("dictionary::dictionary: invalid dictionary");
+}
+
+void dictionary::encode(
+    const vector<string_view> &terms,
+    vector<uint64_t> &offsets,
+    string &blocks
+) {
+    using std::back_inserter, std::mismatch;
+
+    offsets.assign(1U, 0U);
+    blocks.clear();
+    for (size_t i = 0U; i < terms.size(); ++i) {
+        const string_view term = terms[i];
+        uint32_t shared = 0U;
+        if (i % block_terms != 0U) {
+            const string_view previous = terms[i - 1U];
+            shared = static_cast<uint32_t>(mismatch(
+                term.cbegin(), term.cend(), previous.cbegin(), previous.cend()
+            ).first - term.cbegin());
+        } else if (i != 0U)
+            offsets.push_back(blocks.size());
+        varbyte_encode(shared, back_inserter(blocks));
+        varbyte_encode(static_cast<uint32_t>(term.size() - shared),
+            back_inserter(blocks));
+        blocks.append(term.substr(shared));
+    }
+    if (!terms.empty())
+        offsets.push_back(blocks.size());
+}
+
+auto dictionary::begin() const -> iterator {
+    return iterator(*this, 0U);
+}
+
+auto dictionary::end() const -> iterator {
+    return iterator(*this, static_cast<term_id>(size_));
+}
+
+optional<dictionary::term_id> dictionary::find(const string_view term) const {
+    const iterator iter = lower_bound(term);
+    if (iter == end() || *iter != term)
+        return {};
+    return iter.id();
+}
+
+auto dictionary::lower_bound(const string_view term) const -> iterator {
+    using std::ranges::iota_view;
+
+    // A block is equivalent to every term between its header and the header
+    // of the next block, so binary_search finds the only block that can hold
+    // the term.
+    class block_less final {
+    public:
+        explicit block_less(const dictionary &dict) noexcept
+            : dictionary_(dict), count_(blocks(dict.size())) {}
+
+        bool operator()(const term_id lhs, const string_view rhs) const {
+            return lhs + 1U < count_ && dictionary_.header(lhs + 1U) <= rhs;
+        }
+
+        bool operator()(const string_view lhs, const term_id rhs) const {
+            return lhs < dictionary_.header(rhs);
+        }
+
+    private:
+        const dictionary &dictionary_;
+        size_t count_;
+    };
+
+    const iota_view<term_id, term_id> ids(0U,
+        static_cast<term_id>(blocks(size_)));
+    const auto block =
+        ::binary_search(ids.begin(), ids.end(), term, block_less(*this));
+    if (block == ids.end())
+        return begin();
+    iterator returns(*this, static_cast<term_id>(*block * block_terms));
+    for (const iterator last = end(); returns != last && *returns < term; )
+        ++returns;
+    return returns;
+}
+
+string dictionary::term(const term_id id) const {
+    if (id >= size_) [[unlikely]]
+        throw std::out_of_range("dictionary::term: term is out of range");
+    return *iterator(*this, id);
+}
+
+string_view dictionary::header(const size_t block) const {
+    const char *first = blocks_ + offsets_[block];
+    const char * const last = blocks_ + offsets_[block + 1U];
+    uint32_t shared, length;
+    first = varbyte_decode(varbyte_decode(first, last, shared), last, length);
+    if (shared != 0U || length > static_cast<size_t>(last - first))
+        [[unlikely]] throw logic_error("dictionary::header: invalid block");
+    return string_view(first, length);
+}
+
+auto dictionary::iterator::operator++() -> iterator & {
+    if (++id_ < size_)
+        decode();
+    else
+        term_.clear();
+    return *this;
+}
+
+dictionary::iterator::iterator(const dictionary &dict, const term_id id)
+    : size_(static_cast<term_id>(dict.size())) {
+    if (id >= size_) {
+        id_ = size_;
+        return;
+    }
+    const size_t block = id / block_terms;
+    first_ = dict.blocks_ + dict.offsets_[block];
+    last_ = dict.blocks_ + dict.offsets_[blocks(dict.size())];
+    id_ = static_cast<term_id>(block * block_terms);
+    decode();
+    while (id_ < id)
+        ++*this;
+}
+
+void dictionary::iterator::decode() {
+    uint32_t shared, length;
+    first_ = varbyte_decode(varbyte_decode(first_, last_, shared), last_,
+        length);
+    if (shared > term_.size() ||
+        length > static_cast<size_t>(last_ - first_)
+    ) [[unlikely]] throw logic_error("dictionary::iterator: invalid term");
+    term_.resize(shared);
+    term_.append(first_, length);
+    first_ += length;
+}
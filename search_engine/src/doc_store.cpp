@@ -0,0 +1,186 @@
+#include <cstdint> // uint32_t, uint64_t, uintptr_t
+#include <cstring> // memcmp
+
+#include <iterator> // back_inserter
+#include <limits> // numeric_limits
+#include <stdexcept> // length_error, logic_error, out_of_range
+#include <utility> // move
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/lz.hpp>
+#include <search_engine/varbyte.hpp>
+
+using std::logic_error, std::make_shared, std::numeric_limits,
+    std::shared_ptr, std::size_t, std::string, std::string_view,
+    std::uint32_t, std::uint64_t;
+
+static constexpr uint64_t align(const uint64_t offset) noexcept {
+    return (offset + 7U) & ~static_cast<uint64_t>(7U);
+}
+
+doc_store::doc_store(const char * const filename, const size_t cache_size)
+    : map_(filename), blocks_(cache_size) {
+    using std::memcmp, std::uintptr_t;
+    static constexpr const char *what = "doc_store::doc_store: invalid store";
+
+    const string_view data(map_);
+    if (data.size() < sizeof(header) ||
+        reinterpret_cast<uintptr_t>(data.data()) % alignof(uint64_t) != 0U
+    ) [[unlikely]] throw logic_error(what);
+    header_ = reinterpret_cast<const header *>(data.data());
+    if (memcmp(header_->magic.data(), magic.data(), magic.size()) != 0 ||
+        header_->size != data.size() ||
+        header_->block_offsets > header_->locations ||
+        header_->locations > header_->size ||
+        (header_->block_offsets | header_->locations) % 8U != 0U ||
+        (header_->locations - header_->block_offsets) <
+            (header_->blocks + 1U) * sizeof(uint64_t) +
+            header_->blocks * sizeof(uint32_t) ||
+        (header_->size - header_->locations) / sizeof(location) <
+            header_->documents
+    ) [[unlikely]] throw logic_error(what);
+
+    block_offsets_ = reinterpret_cast<const uint64_t *>(
+        data.data() + header_->block_offsets);
+    block_sizes_ = reinterpret_cast<const uint32_t *>(
+        block_offsets_ + header_->blocks + 1U);
+    locations_ = reinterpret_cast<const location *>(
+        data.data() + header_->locations);
+    if (block_offsets_[0] != sizeof(header) ||
+        block_offsets_[header_->blocks] > header_->block_offsets
+    ) [[unlikely]] throw logic_error(what);
+}
+
+stored_document doc_store::get(const doc_id id) const {
+    using std::out_of_range;
+    static constexpr const char *what = "doc_store::get: invalid document";
+
+    if (id >= size()) [[unlikely]]
+        throw out_of_range("doc_store::get: document is out of range");
+    const location where = locations_[id];
+    if (where.block >= header_->blocks) [[unlikely]]
+        throw logic_error(what);
+
+    stored_document returns{block(where.block)};
+    const string &data = *returns.block;
+    if (where.offset >= data.size()) [[unlikely]]
+        throw logic_error(what);
+    const char *first = data.data() + where.offset;
+    const char * const last = data.data() + data.size();
+    uint32_t size = 0U;
+    first = varbyte_decode(first, last, size);
+    if (size > static_cast<size_t>(last - first)) [[unlikely]]
+        throw logic_error(what);
+    returns.title = string_view(first, size);
+    first = varbyte_decode(first + size, last, size);
+    if (size > static_cast<size_t>(last - first)) [[unlikely]]
+        throw logic_error(what);
+    returns.text = string_view(first, size);
+    return returns;
+}
+
+cache_statistics doc_store::stats() const {
+    return blocks_.stats();
+}
+
+shared_ptr<const string> doc_store::block(const uint32_t number) const {
+    shared_ptr<const string> returns = blocks_.find(number);
+    if (returns != nullptr)
+        return returns;
+
+    const uint64_t first = block_offsets_[number],
+        last = block_offsets_[number + 1U];
+    if (first > last || last > header_->block_offsets) [[unlikely]]
+        throw logic_error("doc_store::block: invalid block");
+    auto block = make_shared<string>();
+    lz_decompress(string_view(map_).substr(first, last - first),
+        block_sizes_[number], *block);
+    returns = move(block);
+    blocks_.insert(number, returns, returns->size());
+    return returns;
+}
+
+doc_store_writer::doc_store_writer(
+    const char * const filename,
+    const size_t block_size
+) : file_(), block_offsets_{sizeof(doc_store::header)},
+    block_size_(block_size) {
+    using std::ofstream;
+
+    file_.exceptions(ofstream::failbit | ofstream::badbit);
+    file_.open(filename, ofstream::binary | ofstream::trunc);
+    // Reserves the header, written by finish.
+    const doc_store::header empty{};
+    file_.write(reinterpret_cast<const char *>(&empty), sizeof(empty));
+}
+
+void doc_store_writer::add(const string_view title, const string_view text) {
+    using std::back_inserter, std::length_error;
+
+    if (!file_.is_open()) [[unlikely]]
+        throw logic_error("doc_store_writer::add: store is finished");
+    if (locations_.size() == numeric_limits<uint32_t>::max() ||
+        title.size() > numeric_limits<uint32_t>::max() ||
+        text.size() > numeric_limits<uint32_t>::max() - title.size()
+    ) [[unlikely]] throw length_error("doc_store_writer::add: too large");
+
+    const size_t record = varbyte_size(static_cast<uint32_t>(title.size())) +
+        title.size() + varbyte_size(static_cast<uint32_t>(text.size())) +
+        text.size();
+    if (!block_.empty() && block_.size() + record > block_size_)
+        flush();
+    locations_.push_back({static_cast<uint32_t>(block_sizes_.size()),
+        static_cast<uint32_t>(block_.size())});
+    varbyte_encode(static_cast<uint32_t>(title.size()),
+        back_inserter(block_));
+    block_.append(title);
+    varbyte_encode(static_cast<uint32_t>(text.size()), back_inserter(block_));
+    block_.append(text);
+}
+
+void doc_store_writer::finish() {
+    if (!file_.is_open()) [[unlikely]]
+        throw logic_error("doc_store_writer::finish: store is finished");
+    if (!block_.empty())
+        flush();
+
+    const auto pad = [this](const uint64_t offset) -> uint64_t {
+        static constexpr std::array<char, 8> zeros{};
+        const uint64_t aligned = align(offset);
+        file_.write(zeros.data(),
+            static_cast<std::streamsize>(aligned - offset));
+        return aligned;
+    };
+    doc_store::header head{};
+    head.magic = doc_store::magic;
+    head.documents = static_cast<uint32_t>(locations_.size());
+    head.block_size = static_cast<uint32_t>(block_size_);
+    head.blocks = block_sizes_.size();
+    head.block_offsets = pad(block_offsets_.back());
+    file_.write(reinterpret_cast<const char *>(block_offsets_.data()),
+        static_cast<std::streamsize>(block_offsets_.size() * sizeof(uint64_t)));
+    file_.write(reinterpret_cast<const char *>(block_sizes_.data()),
+        static_cast<std::streamsize>(block_sizes_.size() * sizeof(uint32_t)));
+    head.locations = pad(head.block_offsets +
+        block_offsets_.size() * sizeof(uint64_t) +
+        block_sizes_.size() * sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char *>(locations_.data()),
+        static_cast<std::streamsize>(
+            locations_.size() * sizeof(doc_store::location)));
+    head.size = head.locations +
+        locations_.size() * sizeof(doc_store::location);
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char *>(&head), sizeof(head));
+    file_.close();
+}
+
+void doc_store_writer::flush() {
+    compressed_.clear();
+    lz_compress(block_, compressed_);
+    file_.write(compressed_.data(),
+        static_cast<std::streamsize>(compressed_.size()));
+    block_offsets_.push_back(block_offsets_.back() + compressed_.size());
+    block_sizes_.push_back(static_cast<uint32_t>(block_.size()));
+    block_.clear();
+}
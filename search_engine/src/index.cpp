@@ -1,24 +1,364 @@
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+#include <algorithm> // copy_n, max, sort
+#include <array> // array
+#include <iterator> // back_inserter
+#include <limits> // numeric_limits
+#include <stdexcept> // length_error
+#include <utility> // pair
+
+#include <search_engine/bitmap.hpp>
+#include <search_engine/dictionary.hpp>
 #include <search_engine/index.hpp>
+#include <search_engine/kgram_index.hpp>
+#include <search_engine/perfect_hash.hpp>
+#include <search_engine/varbyte.hpp>
+#include <search_engine/writable_memmap.hpp>
+
+using std::array, std::numeric_limits, std::ostream, std::size_t,
+    std::string, std::string_view, std::uint32_t, std::uint64_t, std::vector;
+
+static constexpr uint64_t align(uint64_t);
+static index::container choose(const vector<index::doc_id> &, size_t,
+    uint64_t, uint64_t &);
+template<class OutputIter>
+static OutputIter encode_gaps(const vector<index::doc_id> &, OutputIter);
+template<class OutputIter>
+static OutputIter encode_postings(const vector<index::doc_id> &,
+    index::container, size_t, uint64_t, OutputIter);
+template<class OutputIter>
+static OutputIter encode_runs(const vector<index::doc_id> &, OutputIter);
+static void pad(ostream &, uint64_t);
+template<typename T>
+static char *place(char *, const T *, size_t);
+template<typename T>
+static char *place(char *, const vector<T> &);
+template<typename T>
+static void write(ostream &, const vector<T> &);
 
-using std::istream, std::ostream, std::string_view;
+index::doc_id index::insert_document(const string_view title) {
+    using std::length_error;
 
-index::doc_id index::insert_document(const std::string_view view) {
+    if (size() >= numeric_limits<doc_id>::max()) [[unlikely]]
+        throw length_error("index::insert_document: too many documents");
+    titles.append(title);
+    title_offsets.push_back(titles.size());
+    return static_cast<doc_id>(size() - 1U);
 }
 
-std::string_view index::insert_term(const std::string_view &) {
-    if (false) [[unlikely]]
-        ;
-    const size_t capacity = dictionary.capacity();
-    assert(capacity == 0 || (capacity & capacity - 1) == 0);
-    if (dictionary.size() + max_term_size > capacity);
-        dictionary.reserve(max(max_term_size, capacity * 2));
-    return ;
+void index::insert_postings(
+    const string_view term,
+    const vector<doc_id> &ids,
+    const doc_id base
+) {
+    if (ids.empty())
+        return;
+    assert(base + ids.back() < size());
+
+    posting_pool::list *found = posting.find(term);
+    if (found == nullptr)
+        found = &posting.insert(insert_string(term));
+    assert(found->size == 0U || pool.back(*found) < base + ids.front());
+    for (const doc_id id : ids)
+        pool.append(*found, base + id);
 }
 
-istream &operator>>(istream &stream, index &) {
-    return stream;
+void index::insert_term(const doc_id id, const string_view term) {
+    assert(id < size());
+
+    posting_pool::list *found = posting.find(term);
+    if (found == nullptr) [[unlikely]]
+        found = &posting.insert(insert_string(term));
+    assert(found->size == 0U || pool.back(*found) <= id);
+    if (found->size == 0U || pool.back(*found) != id)
+        pool.append(*found, id);
 }
 
-ostream &operator<<(ostream &stream, const index &) {
+string_view index::insert_string(const string_view str) {
+    using std::max;
+
+    if (dictionary.empty() ||
+        dictionary.back().capacity() - dictionary.back().size() < str.size()
+    ) {
+        dictionary.emplace_back();
+        dictionary.back().reserve(max(block_size, str.size()));
+    }
+    vector<char> &block = dictionary.back();
+    const size_t offset = block.size();
+    block.insert(block.cend(), str.cbegin(), str.cend());
+    return string_view(block.data() + offset, str.size());
+}
+
+// The sections of the on-disk layout, ready to be copied out, except for the
+// d-gaps, which are encoded straight into their destination.
+struct index::sections final {
+    std::vector<std::pair<string_view, const posting_pool::list *>> terms{};
+    vector<uint64_t> title_offsets{0U};
+    vector<uint64_t> block_offsets{};
+    string blocks{};
+    vector<uint64_t> hash{};
+    string grams{};
+    vector<uint64_t> posting_offsets{0U};
+    vector<uint32_t> frequencies{};
+    vector<container> containers{};
+    header head{};
+};
+
+void index::write(const char * const filename) const {
+    sections parts;
+    prepare(parts);
+
+    writable_memmap map(filename, parts.head.size);
+    char * const data = map.data();
+    place(data, &parts.head, 1U);
+    place(place(data + parts.head.titles, parts.title_offsets),
+        titles.data(), titles.size());
+    place(place(data + parts.head.dictionary, parts.block_offsets),
+        parts.blocks.data(), parts.blocks.size());
+    place(place(data + parts.head.hash, parts.hash),
+        parts.grams.data(), parts.grams.size());
+    place(place(data + parts.head.postings, parts.posting_offsets),
+        parts.frequencies);
+    char *postings = data + parts.head.size - parts.posting_offsets.back();
+    vector<doc_id> ids;
+    for (size_t i = 0U; i < parts.terms.size(); ++i) {
+        pool.copy(*parts.terms[i].second, ids);
+        postings = encode_postings(ids, parts.containers[i], size(),
+            parts.posting_offsets[i], postings);
+    }
+    assert(postings == data + parts.head.size);
+    map.sync();
+    map.close();
+}
+
+ostream &operator<<(ostream &stream, const index &idx) {
+    using std::back_inserter;
+
+    index::sections parts;
+    idx.prepare(parts);
+    const index::header &header = parts.head;
+
+    uint64_t position = sizeof(header);
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    pad(stream, header.titles - position);
+    write(stream, parts.title_offsets);
+    stream.write(idx.titles.data(),
+        static_cast<std::streamsize>(idx.titles.size()));
+    position = header.titles +
+        parts.title_offsets.size() * sizeof(uint64_t) + idx.titles.size();
+
+    pad(stream, header.dictionary - position);
+    write(stream, parts.block_offsets);
+    stream.write(parts.blocks.data(),
+        static_cast<std::streamsize>(parts.blocks.size()));
+    position = header.dictionary +
+        parts.block_offsets.size() * sizeof(uint64_t) + parts.blocks.size();
+
+    pad(stream, header.hash - position);
+    write(stream, parts.hash);
+    stream.write(parts.grams.data(),
+        static_cast<std::streamsize>(parts.grams.size()));
+    position = header.postings;
+
+    pad(stream, header.postings - position);
+    write(stream, parts.posting_offsets);
+    write(stream, parts.frequencies);
+    position = header.postings +
+        parts.posting_offsets.size() * sizeof(uint64_t) +
+        parts.frequencies.size() * sizeof(uint32_t);
+    pad(stream, align(position) - position);
+    string encoded;
+    vector<index::doc_id> ids;
+    for (size_t i = 0U; i < parts.terms.size(); ++i) {
+        encoded.clear();
+        idx.pool.copy(*parts.terms[i].second, ids);
+        encode_postings(ids, parts.containers[i], idx.size(),
+            parts.posting_offsets[i], back_inserter(encoded));
+        stream.write(encoded.data(),
+            static_cast<std::streamsize>(encoded.size()));
+    }
+
     return stream;
 }
+
+void index::prepare(sections &parts) const {
+    using std::length_error, std::sort;
+
+    parts.terms.reserve(posting.size());
+    for (const auto &[term, postings] : posting)
+        parts.terms.emplace_back(term, &postings);
+    sort(parts.terms.begin(), parts.terms.end());
+    if (parts.terms.size() > numeric_limits<term_id>::max()) [[unlikely]]
+        throw length_error("index::prepare: too many terms");
+
+    parts.title_offsets.insert(parts.title_offsets.cend(),
+        title_offsets.cbegin(), title_offsets.cend()
+    );
+    vector<string_view> sorted;
+    sorted.reserve(parts.terms.size());
+    for (const auto &[term, postings] : parts.terms)
+        sorted.push_back(term);
+    dictionary::encode(sorted, parts.block_offsets, parts.blocks);
+    parts.hash = perfect_hash::encode(sorted);
+    parts.grams = kgram_index::encode(sorted);
+    parts.frequencies.reserve(parts.terms.size());
+    parts.containers.reserve(parts.terms.size());
+    parts.posting_offsets.reserve(parts.terms.size() + 1U);
+    vector<doc_id> ids;
+    for (uint64_t offset = 0U; const auto &[term, postings] : parts.terms) {
+        parts.frequencies.push_back(postings->size);
+        pool.copy(*postings, ids);
+        uint64_t bytes = 0U;
+        parts.containers.push_back(choose(ids, size(), offset, bytes));
+        offset += bytes;
+        parts.posting_offsets.push_back(offset);
+    }
+
+    header &head = parts.head;
+    head.magic = magic;
+    head.flags = flags();
+    head.documents = static_cast<uint32_t>(size());
+    head.terms = parts.terms.size();
+    head.titles = align(sizeof(header));
+    head.dictionary = align(head.titles +
+        parts.title_offsets.size() * sizeof(uint64_t) + titles.size());
+    head.hash = align(head.dictionary +
+        parts.block_offsets.size() * sizeof(uint64_t) + parts.blocks.size());
+    head.grams = head.hash + parts.hash.size() * sizeof(uint64_t);
+    head.postings = head.grams + parts.grams.size();
+    head.size = align(head.postings +
+        parts.posting_offsets.size() * sizeof(uint64_t) +
+        parts.frequencies.size() * sizeof(uint32_t)) +
+        parts.posting_offsets.back();
+}
+
+static constexpr uint64_t align(const uint64_t offset) {
+    return (offset + 7U) & ~static_cast<uint64_t>(7U);
+}
+
+// Returns the container that stores the list at offset in the postings in
+// the fewest bytes and its size, container byte included, preferring gaps,
+// then runs, on ties. A bitmap starts 8-byte aligned; the postings are.
+static index::container choose(
+    const vector<index::doc_id> &ids,
+    const size_t documents,
+    const uint64_t offset,
+    uint64_t &bytes
+) {
+    uint64_t gaps = 1U, runs = 1U;
+    for (index::doc_id previous = 0U; const index::doc_id id : ids) {
+        gaps += varbyte_size(id - previous);
+        previous = id;
+    }
+    for (size_t i = 0U, end = 0U; i < ids.size(); ) {
+        size_t last = i;
+        while (last + 1U < ids.size() && ids[last + 1U] == ids[last] + 1U)
+            ++last;
+        runs += varbyte_size(static_cast<uint32_t>(ids[i] - end)) +
+            varbyte_size(static_cast<uint32_t>(last - i));
+        end = ids[last] + 1U;
+        i = last + 1U;
+    }
+    const uint64_t bitmap = align(offset + 1U) - offset +
+        bitmap_words(documents) * sizeof(uint64_t);
+
+    if (bitmap < gaps && bitmap < runs) {
+        bytes = bitmap;
+        return index::bitmap;
+    }
+    if (runs < gaps) {
+        bytes = runs;
+        return index::runs;
+    }
+    bytes = gaps;
+    return index::gaps;
+}
+
+template<class OutputIter>
+static OutputIter encode_gaps(
+    const vector<index::doc_id> &ids,
+    OutputIter out
+) {
+    for (index::doc_id previous = 0U; const index::doc_id id : ids) {
+        out = varbyte_encode(id - previous, out);
+        previous = id;
+    }
+    return out;
+}
+
+// Writes the container byte and the container of a list that starts at
+// offset in the postings.
+template<class OutputIter>
+static OutputIter encode_postings(
+    const vector<index::doc_id> &ids,
+    const index::container kind,
+    const size_t documents,
+    const uint64_t offset,
+    OutputIter out
+) {
+    using std::copy_n;
+
+    *out++ = static_cast<char>(kind);
+    if (kind == index::gaps)
+        return encode_gaps(ids, out);
+    else if (kind == index::runs)
+        return encode_runs(ids, out);
+
+    for (uint64_t position = offset + 1U; position % 8U != 0U; ++position)
+        *out++ = '\0';
+    vector<uint64_t> words(bitmap_words(documents), 0U);
+    for (const index::doc_id id : ids)
+        words[id / 64U] |= uint64_t{1} << (id % 64U);
+    return copy_n(reinterpret_cast<const char *>(words.data()),
+        words.size() * sizeof(uint64_t), out);
+}
+
+template<class OutputIter>
+static OutputIter encode_runs(
+    const vector<index::doc_id> &ids,
+    OutputIter out
+) {
+    for (size_t i = 0U, end = 0U; i < ids.size(); ) {
+        size_t last = i;
+        while (last + 1U < ids.size() && ids[last + 1U] == ids[last] + 1U)
+            ++last;
+        out = varbyte_encode(static_cast<uint32_t>(ids[i] - end), out);
+        out = varbyte_encode(static_cast<uint32_t>(last - i), out);
+        end = ids[last] + 1U;
+        i = last + 1U;
+    }
+    return out;
+}
+
+static void pad(ostream &stream, const uint64_t count) {
+    static constexpr array<char, 8> zeros{};
+    assert(count < zeros.size());
+
+    stream.write(zeros.data(), static_cast<std::streamsize>(count));
+}
+
+template<typename T>
+static char *place(
+    char * const out,
+    const T * const values,
+    const size_t size
+) {
+    using std::copy_n;
+
+    return copy_n(reinterpret_cast<const char *>(values), size * sizeof(T),
+        out);
+}
+
+template<typename T>
+static char *place(char * const out, const vector<T> &values) {
+    return place(out, values.data(), values.size());
+}
+
+template<typename T>
+static void write(ostream &stream, const vector<T> &values) {
+    stream.write(reinterpret_cast<const char *>(values.data()),
+        static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
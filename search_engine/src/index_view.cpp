@@ -0,0 +1,384 @@
+#include <cassert> // assert
+#include <cstdint> // uint32_t, uint64_t, uintptr_t
+#include <cstring> // memcmp
+
+#include <algorithm> // min, mismatch, set_intersection
+#include <bit> // bit_width
+#include <functional> // greater
+#include <iterator> // back_inserter
+#include <queue> // priority_queue
+#include <stdexcept> // logic_error, out_of_range
+
+#include <search_engine/bitmap.hpp>
+#include <search_engine/char_encoder.hpp>
+#include <search_engine/index_view.hpp>
+#include <search_engine/levenshtein_automaton.hpp>
+#include <search_engine/varbyte.hpp>
+
+using std::optional, std::out_of_range, std::size_t, std::string,
+    std::string_view, std::uint32_t, std::uint64_t, std::vector,
+    std::wstring;
+
+static const uint64_t *bitmap_of(const char *, const char *, size_t);
+static bool matches(string_view, string_view) noexcept;
+static void widen(string_view, wstring &, vector<size_t> &);
+
+index_view::index_view(const string_view data) {
+    using std::logic_error, std::memcmp, std::uintptr_t;
+    static constexpr const char *what = "index_view::index_view: invalid index";
+
+    if (data.size() < sizeof(index::header) ||
+        reinterpret_cast<uintptr_t>(data.data()) % alignof(uint64_t) != 0U
+    ) [[unlikely]] throw logic_error(what);
+    const auto * const header =
+        reinterpret_cast<const index::header *>(data.data());
+    if (memcmp(header->magic.data(), index::magic.data(), index::magic.size())
+        != 0 || header->size != data.size() ||
+        header->titles > header->dictionary ||
+        header->dictionary > header->hash ||
+        header->hash > header->grams ||
+        header->grams > header->postings ||
+        header->postings > header->size ||
+        (header->titles | header->dictionary | header->hash |
+            header->grams | header->postings) % 8U != 0U ||
+        (header->dictionary - header->titles) / sizeof(uint64_t) <=
+            header->documents ||
+        (header->hash - header->dictionary) / sizeof(uint64_t) <=
+            ::dictionary::blocks(header->terms) ||
+        (header->size - header->postings) <
+            (header->terms + 1U) * sizeof(uint64_t) +
+            header->terms * sizeof(uint32_t)
+    ) [[unlikely]] throw logic_error(what);
+
+    const char * const first = data.data();
+    title_offsets_ =
+        reinterpret_cast<const uint64_t *>(first + header->titles);
+    titles_ = reinterpret_cast<const char *>(
+        title_offsets_ + header->documents + 1U);
+    const auto * const block_offsets =
+        reinterpret_cast<const uint64_t *>(first + header->dictionary);
+    const char * const blocks = reinterpret_cast<const char *>(
+        block_offsets + ::dictionary::blocks(header->terms) + 1U);
+    posting_offsets_ =
+        reinterpret_cast<const uint64_t *>(first + header->postings);
+    frequencies_ = reinterpret_cast<const uint32_t *>(
+        posting_offsets_ + header->terms + 1U);
+    const uint64_t postings = (header->postings +
+        (header->terms + 1U) * sizeof(uint64_t) +
+        header->terms * sizeof(uint32_t) + 7U) & ~static_cast<uint64_t>(7U);
+    postings_ = first + postings;
+
+    if (titles_ + title_offsets_[header->documents] >
+            first + header->dictionary ||
+        block_offsets[::dictionary::blocks(header->terms)] >
+            static_cast<uint64_t>(first + header->hash - blocks) ||
+        postings > header->size ||
+        posting_offsets_[header->terms] != header->size - postings
+    ) [[unlikely]] throw logic_error(what);
+    dictionary_ = ::dictionary(block_offsets, blocks, header->terms);
+    hash_ = perfect_hash(
+        reinterpret_cast<const uint64_t *>(first + header->hash),
+        (header->grams - header->hash) / sizeof(uint64_t), header->terms);
+    grams_ = kgram_index(first + header->grams,
+        header->postings - header->grams);
+    header_ = header;
+}
+
+const uint64_t *index_view::bitmap(const term_id id) const {
+    if (id >= terms()) [[unlikely]]
+        throw out_of_range("index_view::bitmap: term is out of range");
+    const char * const first = postings_ + posting_offsets_[id];
+    if (first == postings_ + posting_offsets_[id + 1U] ||
+        static_cast<uchar>(*first) != index::bitmap)
+        return nullptr;
+    return bitmap_of(first, postings_ + posting_offsets_[id + 1U], size());
+}
+
+void index_view::expand(
+    const string_view pattern,
+    const size_t limit,
+    vector<term_id> &ids
+) const {
+    using std::back_inserter, std::set_intersection;
+
+    ids.clear();
+    const size_t star = pattern.find('*');
+    if (star == string_view::npos) {
+        if (const auto id = find(pattern); id.has_value() && limit > 0U)
+            ids.push_back(*id);
+        return;
+    }
+
+    // Grams of the fragments between stars; boundaries anchor the first and
+    // the last fragment to the ends of the term.
+    string padded(1U, kgram_index::boundary);
+    padded.append(pattern).push_back(kgram_index::boundary);
+    vector<string_view> grams;
+    for (size_t first = 0U; first <= padded.size(); ) {
+        size_t last = padded.find('*', first);
+        if (last == string::npos)
+            last = padded.size();
+        kgram_index::grams(string_view(padded).substr(first, last - first),
+            grams);
+        first = last + 1U;
+    }
+
+    // Every fragment with a character has a gram, short fragments one of
+    // fewer than k code points. A pure prefix is resolved by a scan of the
+    // dictionary range of its prefix, as is a pattern of stars alone.
+    const string_view prefix = pattern.substr(0U, star);
+    if (star + 1U == pattern.size() || grams.empty()) {
+        for (auto iter = dictionary_.lower_bound(prefix);
+            ids.size() < limit && iter != dictionary_.end() &&
+                iter->starts_with(prefix);
+            ++iter
+        ) if (matches(pattern, *iter))
+            ids.push_back(iter.id());
+        return;
+    }
+
+    vector<term_id> candidates, current, intersection;
+    grams_.find(grams.front(), candidates);
+    for (auto iter = grams.cbegin() + 1;
+        iter != grams.cend() && !candidates.empty(); ++iter
+    ) {
+        grams_.find(*iter, current);
+        intersection.clear();
+        set_intersection(candidates.cbegin(), candidates.cend(),
+            current.cbegin(), current.cend(), back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+    for (auto iter = candidates.cbegin();
+        ids.size() < limit && iter != candidates.cend(); ++iter
+    ) if (matches(pattern, dictionary_.term(*iter)))
+        ids.push_back(*iter);
+}
+
+// The perfect hash answers in O(1); its candidate is checked against the
+// dictionary, which also resolves the rare keys whose 64-bit hashes collide.
+optional<index_view::term_id> index_view::find(const string_view term) const {
+    const optional<term_id> id = hash_.find(term);
+    if (!id.has_value())
+        return {};
+    if (dictionary_.term(*id) == term) [[likely]]
+        return id;
+    return dictionary_.find(term);
+}
+
+uint32_t index_view::frequency(const term_id id) const {
+    if (id >= terms()) [[unlikely]]
+        throw out_of_range("index_view::frequency: term is out of range");
+    return frequencies_[id];
+}
+
+// Walks the sorted dictionary in lockstep with a Levenshtein automaton. The
+// states of the prefix shared with the previous term are reused, and once a
+// prefix leads to the dead state every term starting with it is skipped.
+void index_view::fuzzy(
+    const string_view term,
+    const uint distance,
+    const size_t limit,
+    vector<term_id> &ids
+) const {
+    using std::min, std::mismatch;
+
+    ids.clear();
+    wstring previous, current;
+    vector<size_t> ends;
+    widen(term, current, ends);
+    levenshtein_automaton automaton(current, distance);
+    vector<levenshtein_automaton::state> states{automaton.start()};
+    current.clear();
+    for (auto iter = dictionary_.begin(), last = dictionary_.end();
+        iter != last && ids.size() < limit;
+    ) {
+        widen(*iter, current, ends);
+        const size_t shared = static_cast<size_t>(mismatch(
+            previous.cbegin(), previous.cend(), current.cbegin(), current.cend()
+        ).first - previous.cbegin());
+        states.resize(min(shared + 1U, states.size()));
+        while (states.size() <= current.size()) {
+            const auto next =
+                automaton.step(states.back(), current[states.size() - 1U]);
+            if (next == levenshtein_automaton::dead)
+                break;
+            states.push_back(next);
+        }
+        previous.swap(current);
+
+        if (states.size() > previous.size()) {
+            if (automaton.is_match(states.back()))
+                ids.push_back(iter.id());
+            ++iter;
+            continue;
+        }
+        string prefix = iter->substr(0U, ends[states.size() - 1U]);
+        if (++iter == last || !iter->starts_with(prefix))
+            continue;
+        while (!prefix.empty() && static_cast<uchar>(prefix.back()) == 0xFFU)
+            prefix.pop_back();
+        if (prefix.empty())
+            break;
+        ++prefix.back();
+        iter = dictionary_.lower_bound(prefix);
+    }
+}
+
+void index_view::postings(const term_id id, vector<doc_id> &ids) const {
+    using std::logic_error;
+
+    if (id >= terms()) [[unlikely]]
+        throw out_of_range("index_view::postings: term is out of range");
+
+    ids.clear();
+    ids.reserve(frequencies_[id]);
+    const char *first = postings_ + posting_offsets_[id];
+    const char * const last = postings_ + posting_offsets_[id + 1U];
+    if (first == last) [[unlikely]]
+        throw logic_error("index_view::postings: invalid posting list");
+    const auto kind = static_cast<uchar>(*first++);
+    if (kind == index::gaps)
+        for (doc_id current = 0U; first < last; ids.push_back(current)) {
+            uint32_t gap;
+            first = varbyte_decode(first, last, gap);
+            current += gap;
+        }
+    else if (kind == index::runs)
+        for (doc_id end = 0U; first < last; ) {
+            uint32_t gap, length;
+            first = varbyte_decode(first, last, gap);
+            first = varbyte_decode(first, last, length);
+            if (size() - end < gap || size() - end - gap <= length)
+                [[unlikely]] throw logic_error(
+                    "index_view::postings: invalid posting list");
+            for (end += gap; length-- > 0U; )
+                ids.push_back(end++);
+            ids.push_back(end++);
+        }
+    else if (kind == index::bitmap)
+        bitmap_extract(bitmap_of(first - 1, last, size()),
+            bitmap_words(size()), ids);
+    else [[unlikely]]
+        throw logic_error("index_view::postings: invalid posting list");
+    assert(ids.size() == frequencies_[id]);
+}
+
+index_statistics index_view::stats(const size_t top) const {
+    using std::bit_width, std::greater, std::pair, std::priority_queue;
+
+    index_statistics returns;
+    if (header_ == nullptr) [[unlikely]]
+        return returns;
+    returns.documents = size();
+    returns.terms = terms();
+    returns.header_bytes = header_->titles;
+    returns.title_bytes = header_->dictionary - header_->titles;
+    returns.dictionary_bytes = header_->hash - header_->dictionary;
+    returns.hash_bytes = header_->grams - header_->hash;
+    returns.gram_bytes = header_->postings - header_->grams;
+    returns.posting_bytes = posting_offsets_[terms()];
+    returns.posting_table_bytes =
+        header_->size - header_->postings - returns.posting_bytes;
+
+    // Min-heap of the longest lists seen so far.
+    priority_queue<pair<uint32_t, term_id>, vector<pair<uint32_t, term_id>>,
+        greater<>> longest;
+    for (term_id id = 0U; id < terms(); ++id) {
+        const uint32_t frequency = frequencies_[id];
+        returns.postings += frequency;
+        const size_t bucket = frequency == 0U ? 0U :
+            static_cast<size_t>(bit_width(frequency)) - 1U;
+        if (returns.lengths.size() <= bucket)
+            returns.lengths.resize(bucket + 1U, 0U);
+        ++returns.lengths[bucket];
+        if (posting_offsets_[id] != posting_offsets_[id + 1U]) {
+            const auto kind =
+                static_cast<uchar>(postings_[posting_offsets_[id]]);
+            if (kind < returns.containers.size()) {
+                container_statistics &container = returns.containers[kind];
+                ++container.lists;
+                container.postings += frequency;
+                container.bytes +=
+                    posting_offsets_[id + 1U] - posting_offsets_[id];
+            }
+        }
+        if (longest.size() < top)
+            longest.emplace(frequency, id);
+        else if (top != 0U && longest.top().first < frequency) {
+            longest.pop();
+            longest.emplace(frequency, id);
+        }
+    }
+    for (const string &word : dictionary_)
+        returns.term_bytes += word.size();
+
+    returns.longest.resize(longest.size());
+    for (size_t i = longest.size(); i-- > 0U; longest.pop())
+        returns.longest[i] = {term(longest.top().second), longest.top().first};
+    return returns;
+}
+
+string index_view::term(const term_id id) const {
+    if (id >= terms()) [[unlikely]]
+        throw out_of_range("index_view::term: term is out of range");
+    return dictionary_.term(id);
+}
+
+string_view index_view::title(const doc_id id) const {
+    if (id >= size()) [[unlikely]]
+        throw out_of_range("index_view::title: document is out of range");
+    return string_view(titles_ + title_offsets_[id],
+        title_offsets_[id + 1U] - title_offsets_[id]);
+}
+
+// The words of the bitmap container whose container byte is at first; the
+// postings start 8-byte aligned, so the padding aligns the words in memory.
+static const uint64_t *bitmap_of(
+    const char * const first,
+    const char * const last,
+    const size_t documents
+) {
+    using std::logic_error, std::uintptr_t;
+
+    const auto address = reinterpret_cast<uintptr_t>(first + 1);
+    const char * const words = first + 1 + (8U - address % 8U) % 8U;
+    if (words > last || static_cast<size_t>(last - words) !=
+        bitmap_words(documents) * sizeof(uint64_t)
+    ) [[unlikely]] throw logic_error(
+        "index_view::postings: invalid posting list");
+    return reinterpret_cast<const uint64_t *>(words);
+}
+
+static bool matches(const string_view pattern, const string_view str) noexcept {
+    size_t i = 0U, j = 0U, star = string_view::npos, mark = 0U;
+    while (j < str.size())
+        if (i < pattern.size() && pattern[i] == '*') {
+            star = i++;
+            mark = j;
+        } else if (i < pattern.size() && pattern[i] == str[j]) {
+            ++i;
+            ++j;
+        } else if (star != string_view::npos) {
+            i = star + 1U;
+            j = ++mark;
+        } else
+            return false;
+    while (i < pattern.size() && pattern[i] == '*')
+        ++i;
+    return i == pattern.size();
+}
+
+static void widen(const string_view str, wstring &wcs, vector<size_t> &ends) {
+    size_t position = 0U;
+    auto push_back = [&wcs, &ends, &position](const wchar_t wc) -> void {
+        wcs.push_back(wc);
+        ends.push_back(position);
+    };
+    wcs.clear();
+    ends.clear();
+    char_encoder<char, wchar_t, decltype(push_back)> encoder(push_back);
+    for (const char c : str) {
+        ++position;
+        encoder(c);
+    }
+}
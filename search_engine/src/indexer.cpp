@@ -1,74 +1,376 @@
 #include <cassert> // assert
-#include <clocale> // LC_ALL, setlocale
 #include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
 
+#include <cerrno> // errno
+
+#include <algorithm> // max
+#include <chrono> // duration_cast, nanoseconds, steady_clock
+#include <functional> // ref
 #include <stdexcept> // logic_error, runtime_error
 #include <string> // string, wstring
+#include <string_view> // string_view
+#include <system_error> // generic_category, system_error
+#include <thread> // thread
+#include <vector> // vector
+
+#include <fcntl.h> // O_RDONLY, open
+#include <sys/stat.h> // S_ISREG, stat
+#include <time.h> // CLOCK_THREAD_CPUTIME_ID, clock_gettime, timespec
+#include <unistd.h> // STDIN_FILENO, close
 
-#include <search_engine/char_encoder.hpp>
-// #include <search_engine/index.hpp>
+#include <search_engine/analyzer.hpp>
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index.hpp>
 #include <search_engine/indexer.hpp>
+#include <search_engine/inverter.hpp>
 #include <search_engine/memmap.hpp>
-#include <search_engine/normalizer.hpp>
-#include <search_engine/stemmer.hpp>
-#include <search_engine/str_encoder.hpp>
-#include <search_engine/str_parser.hpp>
-#include <search_engine/tokenizer.hpp>
-
-template<bool StopWords = false, bool Stem = false>
-const char *make_index(const char * const texts_file) {
-    using std::logic_error, std::runtime_error, std::setlocale, std::size_t,
-        std::string, std::wstring;
-    static constexpr const char
-        *invalid = "make_index: invalid JSON"; //, *empty = "make_index: empty string";
-
-    if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
-        throw runtime_error("make_index: unable to set locale");
-
-    const memmap map(texts_file);
-    const char *first = map.data();
-    const char * const last = first + map.size();
-    if (first == last) [[unlikely]]
-        throw logic_error("make_index: file is empty");
-    else if (*first != '{') [[unlikely]]
-        throw logic_error(invalid);
-    ++first;
-
-    // size_t pos;
-    string title;
-    str_parser title_parser(bind(&string::push_back, &title, std::placeholders::_1));
-/*
-    str_encoder<wchar_t, char>(
-        [pos, &counts](const string &str) constexpr noexcept -> void {
-            ++counts[std::hash<string>()(str) % counts.size()];
+#include <search_engine/stream_reader.hpp>
+#include <search_engine/texts_parser.hpp>
+
+// Reads both clocks at stage boundaries and charges the time since the
+// previous boundary to the stage that just ended.
+class stage_clock final {
+public:
+    explicit stage_clock(index_profile &);
+
+    void lap(index_profile::stage);
+
+private:
+    static std::uint64_t cpu_now();
+    static std::uint64_t wall_now() noexcept;
+
+    index_profile &profile_;
+    std::uint64_t wall_ = 0U;
+    std::uint64_t cpu_ = 0U;
+};
+
+// Bytes parsed between two calls to memmap::advance, and the readahead.
+static constexpr std::size_t scan_slice = 1U << 20U,
+    scan_window = 1U << 23U;
+
+template<bool StopWords, bool Stem>
+static constexpr std::uint32_t flags() noexcept;
+
+static std::size_t inversion_threads() noexcept;
+
+template<typename Parser>
+static void parse_files(const std::vector<std::string> &, Parser &);
+
+template<typename Parser>
+static void parse_stream(int, Parser &);
+
+index_profile &index_profile::operator+=(const index_profile &other) noexcept {
+    for (std::size_t i = 0U; i < stages.size(); ++i) {
+        stages[i].wall_time += other.stages[i].wall_time;
+        stages[i].cpu_time += other.stages[i].cpu_time;
+        stages[i].bytes += other.stages[i].bytes;
+        stages[i].tokens += other.stages[i].tokens;
+    }
+    return *this;
+}
+
+template<bool StopWords, bool Stem>
+class index make_index(const char * const texts_file, const inversion mode) {
+    using std::string, std::vector;
+
+    return make_index<StopWords, Stem>(vector<string>{texts_file}, mode);
+}
+
+template<bool StopWords, bool Stem>
+class index make_index(
+    const std::vector<std::string> &texts_files,
+    const inversion mode
+) {
+    using std::ref, std::string;
+
+    index returns(flags<StopWords, Stem>());
+    inverter records(returns, inversion_threads());
+    index::doc_id id = 0U;
+    const bool sorted = mode == inversion::sort;
+    auto insert_term = [&](const string &term) -> void {
+        if (sorted)
+            records.insert_term(id, term);
+        else
+            returns.insert_term(id, term);
+    };
+    analyzer<decltype(insert_term), StopWords, Stem> text_analyzer(insert_term);
+
+    const auto insert_document = [&returns, &id](const string &title) {
+        id = returns.insert_document(title);
+    };
+    const auto flush = [&text_analyzer]() -> void { text_analyzer.flush(); };
+    texts_parser parser(insert_document, ref(text_analyzer), flush);
+    parse_files(texts_files, parser);
+    records.finish();
+    return returns;
+}
+
+template<bool StopWords, bool Stem>
+class index make_index(
+    const std::vector<std::string> &texts_files,
+    doc_store_writer &store,
+    const inversion mode
+) {
+    using std::string;
+
+    index returns(flags<StopWords, Stem>());
+    inverter records(returns, inversion_threads());
+    index::doc_id id = 0U;
+    const bool sorted = mode == inversion::sort;
+    auto insert_term = [&](const string &term) -> void {
+        if (sorted)
+            records.insert_term(id, term);
+        else
+            returns.insert_term(id, term);
+    };
+    analyzer<decltype(insert_term), StopWords, Stem> text_analyzer(insert_term);
+
+    string title, text;
+    const auto insert_document = [&](const string &current) {
+        id = returns.insert_document(current);
+        title = current;
+        text.clear();
+    };
+    const auto push_char = [&text_analyzer, &text](const char c) -> void {
+        text.push_back(c);
+        text_analyzer(c);
+    };
+    const auto flush = [&]() -> void {
+        text_analyzer.flush();
+        store.add(title, text);
+    };
+    texts_parser parser(insert_document, push_char, flush);
+    parse_files(texts_files, parser);
+    store.finish();
+    records.finish();
+    return returns;
+}
+
+template<bool StopWords, bool Stem>
+class index make_index(
+    const std::vector<std::string> &texts_files,
+    index_profile &profile,
+    const inversion mode
+) {
+    using std::logic_error, std::size_t, std::string, std::vector,
+        std::wstring;
+    using stage = index_profile::stage;
+
+    string text;
+    wstring wide;
+    vector<wstring> tokens, terms;
+    vector<string> encoded;
+    const auto push_wide = [&wide](const wchar_t wc) -> void {
+        wide.push_back(wc);
+    };
+    char_encoder<char, wchar_t, decltype(push_wide)> decoder(push_wide);
+    tokenizer splitter([&tokens](const wstring &token) -> void {
+        tokens.push_back(token);
+    });
+    const auto push_term = [&terms](size_t, const wstring &term) -> void {
+        terms.push_back(term);
+    };
+    normalizer<decltype(push_term), StopWords> normalize(push_term);
+    stemmer stem([&tokens](const wstring &term) -> void {
+        tokens.push_back(term);
+    });
+    const auto push_encoded = [&encoded](const string &term) -> void {
+        encoded.push_back(term);
+    };
+    str_encoder<wchar_t, char, decltype(push_encoded)> encoder(push_encoded);
+
+    index returns(flags<StopWords, Stem>());
+    inverter records(returns, inversion_threads());
+    const bool sorted = mode == inversion::sort;
+    index::doc_id id = 0U;
+    stage_clock clock(profile);
+    const auto insert_document = [&returns, &id, &text](const string &title) {
+        id = returns.insert_document(title);
+        text.clear();
+    };
+    const auto push_text = [&text](const char c) -> void {
+        text.push_back(c);
+    };
+    texts_parser parser(insert_document, push_text,
+        [&]() -> void {
+            clock.lap(stage::unescape);
+
+            wide.clear();
+            for (const char c : text)
+                decoder(c);
+            if (!decoder.is_init_state()) [[unlikely]] {
+                decoder.clear_state();
+                throw logic_error(
+                    "make_index: incomplete multibyte sequence");
+            }
+            clock.lap(stage::decode);
+
+            tokens.clear();
+            for (const wchar_t wc : wide)
+                splitter(wc);
+            splitter.flush_buffer();
+            clock.lap(stage::tokenize);
+            for (stage_statistics &stats : profile.stages) {
+                stats.bytes += text.size();
+                stats.tokens += tokens.size();
+            }
+
+            terms.clear();
+            for (wstring &token : tokens)
+                normalize(token);
+            normalize.reset_position();
+            clock.lap(stage::normalize);
+
+            if constexpr (Stem) {
+                tokens.clear();
+                for (wstring &term : terms)
+                    stem(term);
+                terms.swap(tokens);
+            }
+            clock.lap(stage::stem);
+
+            encoded.clear();
+            for (const wstring &term : terms)
+                encoder(term);
+            clock.lap(stage::encode);
+
+            for (const string &term : encoded) {
+                if (sorted)
+                    records.insert_term(id, term);
+                else
+                    returns.insert_term(id, term);
+            }
+            clock.lap(stage::insert);
         }
     );
-    str_parser(char_encoder(tokenizer(normalizer(
-        [&pos](const size_t position, wstring &wcs) constexpr noexcept -> void {
-            pos = position;
-            text_stemmer(wcs);
+    parse_files(texts_files, parser);
+    clock.lap(stage::unescape);
+    records.finish();
+    clock.lap(stage::invert);
+    return returns;
+}
+
+stage_clock::stage_clock(index_profile &profile)
+    : profile_(profile), wall_(wall_now()), cpu_(cpu_now()) {}
+
+void stage_clock::lap(const index_profile::stage current) {
+    const std::uint64_t wall = wall_now(), cpu = cpu_now();
+    profile_.stages[current].wall_time += wall - wall_;
+    profile_.stages[current].cpu_time += cpu - cpu_;
+    wall_ = wall;
+    cpu_ = cpu;
+}
+
+std::uint64_t stage_clock::cpu_now() {
+    using std::runtime_error;
+
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) [[unlikely]]
+        throw runtime_error("stage_clock::cpu_now: clock_gettime failed");
+    return static_cast<std::uint64_t>(now.tv_sec) * 1000000000U +
+        static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+// steady_clock reads the timestamp counter through the vDSO on Linux.
+std::uint64_t stage_clock::wall_now() noexcept {
+    using std::chrono::duration_cast, std::chrono::nanoseconds,
+        std::chrono::steady_clock;
+
+    return static_cast<std::uint64_t>(duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count());
+}
+
+template<bool StopWords, bool Stem>
+static constexpr std::uint32_t flags() noexcept {
+    return (StopWords ? static_cast<std::uint32_t>(index::stop_words) : 0U) |
+        (Stem ? static_cast<std::uint32_t>(index::stem) : 0U);
+}
+
+static std::size_t inversion_threads() noexcept {
+    using std::max, std::thread;
+
+    return max(thread::hardware_concurrency(), 1U);
+}
+
+// Maps the files one at a time and feeds them to the parser as one stream,
+// slice by slice, keeping readahead in front of the parser and dropping the
+// pages it is done with, so that a scan of the corpus neither stalls on page
+// faults nor evicts the rest of the page cache. "-" stands for the standard
+// input, which, like pipes and other files that cannot be mapped, is read
+// through a stream_reader.
+template<typename Parser>
+static void parse_files(
+    const std::vector<std::string> &texts_files,
+    Parser &parser
+) {
+    using std::generic_category, std::size_t, std::string, std::string_view,
+        std::system_error;
+
+    for (const string &texts_file : texts_files) {
+        if (texts_file == "-") {
+            parse_stream(STDIN_FILENO, parser);
+            continue;
+        } else if (struct stat info{}; stat(texts_file.c_str(), &info) == 0 &&
+            !S_ISREG(info.st_mode)
+        ) {
+            const int fildes = open(texts_file.c_str(), O_RDONLY);
+            if (fildes == -1) [[unlikely]] throw system_error(errno,
+                generic_category(), "parse_files: unable to open file");
+            try {
+                parse_stream(fildes, parser);
+            } catch (...) {
+                close(fildes);
+                throw;
+            }
+            close(fildes);
+            continue;
+        }
+
+        memmap map(texts_file.c_str(), memmap::sequential);
+        const string_view texts(map);
+        for (size_t offset = 0U; offset < texts.size(); offset += scan_slice) {
+            map.advance(offset, scan_window, true);
+            parser(texts.substr(offset, scan_slice));
         }
-    ))));
-    while (first < last && *first != '}') {
-        title_parser(first, last);
-        if (first == last || *first != ':') [[unlikely]]
-            throw logic_error(invalid);
-        else if (buf.empty()) [[unlikely]] throw logic_error(empty);
-        ++first;
-        // const index::doc_id id = returns.insert_document(buf);
-
-        first = parse_string(first, last, buf); // TODO
-        // lambda insert to index
-        if (first == last || *first != ',') [[unlikely]]
-            throw logic_error(invalid);
-        else if (buf.empty()) [[unlikely]] throw logic_error(empty);
-        ++first;
     }
-    assert(first <= last);
-    if (first == last) [[unlikely]] throw logic_error(invalid);
-    assert(*first == '}');
+    parser.finish();
+}
 
-    return returns;
-*/
-    return first;
+template<typename Parser>
+static void parse_stream(const int fildes, Parser &parser) {
+    using std::string_view;
+
+    stream_reader reader(fildes);
+    for (string_view piece; piece = reader.next(), !piece.empty(); )
+        parser(piece);
 }
+
+template class index make_index<false, false>(const char *, inversion);
+template class index make_index<false, true>(const char *, inversion);
+template class index make_index<true, false>(const char *, inversion);
+template class index make_index<true, true>(const char *, inversion);
+template class index make_index<false, false>(
+    const std::vector<std::string> &, inversion);
+template class index make_index<false, true>(
+    const std::vector<std::string> &, inversion);
+template class index make_index<true, false>(
+    const std::vector<std::string> &, inversion);
+template class index make_index<true, true>(
+    const std::vector<std::string> &, inversion);
+template class index make_index<false, false>(
+    const std::vector<std::string> &, index_profile &, inversion);
+template class index make_index<false, false>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+template class index make_index<false, true>(
+    const std::vector<std::string> &, index_profile &, inversion);
+template class index make_index<false, true>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+template class index make_index<true, false>(
+    const std::vector<std::string> &, index_profile &, inversion);
+template class index make_index<true, false>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
+template class index make_index<true, true>(
+    const std::vector<std::string> &, index_profile &, inversion);
+template class index make_index<true, true>(
+    const std::vector<std::string> &, doc_store_writer &, inversion);
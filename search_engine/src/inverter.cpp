@@ -0,0 +1,70 @@
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <algorithm> // max
+#include <limits> // numeric_limits
+#include <stdexcept> // length_error
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <search_engine/inverter.hpp>
+#include <search_engine/radix_sort.hpp>
+
+using std::size_t, std::string_view, std::uint64_t, std::vector;
+
+void inverter::finish() {
+    radix_sort(records_, [](const uint64_t record) noexcept -> term_id {
+        return static_cast<term_id>(record >> 32U);
+    }, threads_);
+
+    index_->reserve(terms_.size());
+    vector<doc_id> ids;
+    for (size_t i = 0U; i < records_.size(); ) {
+        const uint64_t id = records_[i] >> 32U;
+        ids.clear();
+        for (; i < records_.size() && records_[i] >> 32U == id; ++i)
+            ids.push_back(static_cast<doc_id>(records_[i]));
+        index_->insert_postings(terms_[id], ids, 0U);
+    }
+
+    ids_.clear();
+    terms_.clear();
+    strings_.clear();
+    vector<uint64_t>().swap(records_);
+}
+
+void inverter::insert_term(const doc_id id, const string_view str) {
+    using std::length_error, std::numeric_limits;
+
+    assert(id < index_->size());
+
+    term *found = ids_.find(str);
+    if (found == nullptr) [[unlikely]] {
+        if (terms_.size() > numeric_limits<term_id>::max()) [[unlikely]]
+            throw length_error("inverter::insert_term: too many terms");
+        terms_.push_back(insert_string(str));
+        found = &ids_.insert(terms_.back(),
+            {static_cast<term_id>(terms_.size() - 1U)});
+    }
+    assert(found->last == numeric_limits<doc_id>::max() || found->last <= id);
+    if (found->last != id) {
+        found->last = id;
+        records_.push_back(uint64_t{found->id} << 32U | id);
+    }
+}
+
+string_view inverter::insert_string(const string_view str) {
+    using std::max;
+
+    if (strings_.empty() ||
+        strings_.back().capacity() - strings_.back().size() < str.size()
+    ) {
+        strings_.emplace_back();
+        strings_.back().reserve(max(block_size, str.size()));
+    }
+    vector<char> &block = strings_.back();
+    const size_t offset = block.size();
+    block.insert(block.cend(), str.cbegin(), str.cend());
+    return string_view(block.data() + offset, str.size());
+}
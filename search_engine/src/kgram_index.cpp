@@ -0,0 +1,147 @@
+#include <cstdint> // uint32_t, uint64_t, uintptr_t
+
+#include <algorithm> // sort
+#include <iterator> // back_inserter
+#include <stdexcept> // logic_error
+#include <unordered_map> // unordered_map
+#include <utility> // pair
+
+#include <search_engine/kgram_index.hpp>
+#include <search_engine/types.hpp>
+#include <search_engine/varbyte.hpp>
+
+using std::size_t, std::string, std::string_view, std::uint32_t,
+    std::uint64_t, std::vector;
+
+static constexpr size_t align(size_t) noexcept;
+static void append(string &, const vector<uint64_t> &);
+static void ngrams(string_view, size_t, vector<string_view> &);
+
+kgram_index::kgram_index(const char * const data, const size_t size) {
+    using std::logic_error, std::uintptr_t;
+    static constexpr const char *what = "kgram_index::kgram_index: invalid "
+        "index";
+
+    if (size < 3U * sizeof(uint64_t) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0U
+    ) [[unlikely]] throw logic_error(what);
+    const auto * const words = reinterpret_cast<const uint64_t *>(data);
+    const uint64_t count = words[0], block_size = words[1],
+        posting_size = words[2];
+    if (count > size || block_size > size || posting_size > size ||
+        size != (3U + dictionary::blocks(count) + 1U + count + 1U) *
+            sizeof(uint64_t) + align(block_size) + align(posting_size)
+    ) [[unlikely]] throw logic_error(what);
+
+    const uint64_t * const block_offsets = words + 3U;
+    posting_offsets_ = block_offsets + dictionary::blocks(count) + 1U;
+    const char * const blocks =
+        reinterpret_cast<const char *>(posting_offsets_ + count + 1U);
+    postings_ = blocks + align(block_size);
+    if (block_offsets[dictionary::blocks(count)] != block_size ||
+        posting_offsets_[count] != posting_size
+    ) [[unlikely]] throw logic_error(what);
+    for (size_t i = 1U; i <= count; ++i)
+        if (posting_offsets_[i] < posting_offsets_[i - 1U]) [[unlikely]]
+            throw logic_error(what);
+    grams_ = dictionary(block_offsets, blocks, count);
+}
+
+string kgram_index::encode(const vector<string_view> &terms) {
+    using std::back_inserter, std::pair, std::sort, std::unordered_map;
+
+    unordered_map<string, vector<term_id>> postings;
+    vector<string_view> current;
+    string padded;
+    for (size_t i = 0U; i < terms.size(); ++i) {
+        padded.assign(1U, boundary).append(terms[i]).push_back(boundary);
+        current.clear();
+        for (size_t n = 1U; n <= k; ++n)
+            ngrams(padded, n, current);
+        for (const string_view gram : current) {
+            if (gram.size() == 1U && gram.front() == boundary)
+                continue;
+            vector<term_id> &ids = postings[string(gram)];
+            if (ids.empty() || ids.back() != i)
+                ids.push_back(static_cast<term_id>(i));
+        }
+    }
+
+    vector<pair<string_view, const vector<term_id> *>> sorted;
+    sorted.reserve(postings.size());
+    for (const auto &[gram, ids] : postings)
+        sorted.emplace_back(gram, &ids);
+    sort(sorted.begin(), sorted.end());
+    vector<string_view> keys;
+    keys.reserve(sorted.size());
+    vector<uint64_t> block_offsets, posting_offsets{0U};
+    string blocks, encoded;
+    for (const auto &[gram, ids] : sorted) {
+        keys.push_back(gram);
+        for (term_id previous = 0U; const term_id id : *ids) {
+            varbyte_encode(id - previous, back_inserter(encoded));
+            previous = id;
+        }
+        posting_offsets.push_back(encoded.size());
+    }
+    dictionary::encode(keys, block_offsets, blocks);
+
+    const vector<uint64_t> header = {
+        sorted.size(), blocks.size(), encoded.size()
+    };
+    string returns;
+    append(returns, header);
+    append(returns, block_offsets);
+    append(returns, posting_offsets);
+    returns.append(blocks).resize(returns.size() +
+        align(blocks.size()) - blocks.size());
+    returns.append(encoded).resize(returns.size() +
+        align(encoded.size()) - encoded.size());
+    return returns;
+}
+
+void kgram_index::grams(const string_view str, vector<string_view> &out) {
+    const size_t size = out.size();
+    ngrams(str, k, out);
+    if (out.size() == size && !str.empty() &&
+        str != string_view(&boundary, 1U)
+    ) out.push_back(str);
+}
+
+void kgram_index::find(const string_view gram, vector<term_id> &ids) const {
+    ids.clear();
+    const auto id = grams_.find(gram);
+    if (!id.has_value())
+        return;
+    const char *first = postings_ + posting_offsets_[*id];
+    const char * const last = postings_ + posting_offsets_[*id + 1U];
+    for (term_id current = 0U; first < last; ids.push_back(current)) {
+        uint32_t gap;
+        first = varbyte_decode(first, last, gap);
+        current += gap;
+    }
+}
+
+static constexpr size_t align(const size_t size) noexcept {
+    return (size + 7U) & ~static_cast<size_t>(7U);
+}
+
+static void append(string &str, const vector<uint64_t> &words) {
+    str.append(reinterpret_cast<const char *>(words.data()),
+        words.size() * sizeof(uint64_t));
+}
+
+// Appends the grams of n code points of a UTF-8 string.
+static void ngrams(
+    const string_view str,
+    const size_t n,
+    vector<string_view> &out
+) {
+    vector<size_t> starts;
+    for (size_t i = 0U; i < str.size(); ++i)
+        if ((static_cast<uchar>(str[i]) & 0xC0U) != 0x80U)
+            starts.push_back(i);
+    starts.push_back(str.size());
+    for (size_t i = 0U; i + n < starts.size(); ++i)
+        out.push_back(str.substr(starts[i], starts[i + n] - starts[i]));
+}
@@ -1,18 +1,73 @@
 #include <cassert> // assert
+#include <cerrno> // errno
+#include <clocale> // LC_ALL, setlocale
+#include <csignal> // SIGINT, SIGTERM, signal
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstdio> // rename
 #include <cstdlib> // EXIT_FAILURE, EXIT_SUCCESS, exit
-#include <cstring> // strcmp
+#include <cstring> // strcmp, strlen
 
+#include <algorithm> // max, min
+#include <array> // array
+#include <charconv> // from_chars
+#include <chrono> // duration_cast, milliseconds, nanoseconds, steady_clock
 #include <exception> // exception
-#include <fstream> // ofstream
 #include <iostream> // cerr, cin, cout, ios_base
+#include <memory> // make_shared
+#include <optional> // optional
+#include <stdexcept> // runtime_error
+#include <string> // getline, string, to_string
+#include <string_view> // string_view
+#include <system_error> // errc, generic_category, system_error
+#include <thread> // thread
+#include <vector> // vector
 
+#include <glob.h> // GLOB_NOCHECK, glob, glob_t, globfree
+#include <sys/resource.h> // RUSAGE_SELF, getrusage, rusage
+#include <sys/stat.h> // S_ISDIR, stat
 #include <unistd.h> // getopt
 
+#include <search_engine/allocations.hpp>
+#include <search_engine/cache.hpp>
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index_view.hpp>
 #include <search_engine/indexer.hpp>
+#include <search_engine/memmap.hpp>
+#include <search_engine/posting_cache.hpp>
+#include <search_engine/reorder.hpp>
+#include <search_engine/searcher.hpp>
+#include <search_engine/segmented_index.hpp>
+#include <search_engine/server.hpp>
+#include <search_engine/snippets.hpp>
+
+using result_cache = cache<std::string, std::vector<index::doc_id>>;
+
+static constexpr std::size_t default_cache_size = 1U << 26U,
+    reorder_cache_size = 1U << 30U,
+    default_posting_cache_size = 1U << 26U, default_longest = 10U,
+    max_results = 10U;
+
+static server *running = nullptr;
+
+static void answer(const searcher &, result_cache &, const doc_store *,
+    std::size_t, std::string_view, std::string &);
+static void answer(const segmented_index &, std::string_view, std::string &);
+static void append_line(std::string &, std::string_view);
+static void glob_files(const char *, std::vector<std::string> &);
+static void replace(const std::string &, const char *);
+static bool is_directory(const char *) noexcept;
+static void on_signal(int) noexcept;
+static bool parse_size(const char *, std::size_t &);
+static void print(const char *, const cache_statistics &);
+static void print(const index_profile &, std::chrono::nanoseconds);
+static void print(const index_statistics &);
 
 int main(const int argc, char ** const argv) {
     using std::cerr, std::cin, std::cout, std::exception, std::exit,
-        std::ios_base, std::ofstream, std::strcmp;
+        std::ios_base, std::max, std::runtime_error, std::setlocale,
+        std::signal, std::size_t, std::strcmp, std::string, std::string_view,
+        std::optional, std::thread, std::vector, std::chrono::steady_clock;
     ios_base::sync_with_stdio(false);
     cerr.tie(nullptr);
     cin.tie(nullptr);
@@ -22,14 +77,34 @@ int main(const int argc, char ** const argv) {
         exit(EXIT_FAILURE);
     } else if (strcmp(argv[1], "--help") == 0) {
         cout << "Usage:\n"
-            << "  " << argv[0] << " -i -f FILE -t FILE\n"
-            << "  " << argv[0] << " -s -f FILE\n";
+            << "  " << argv[0] << " -i -f FILE [-d FILE] [-R] -t FILE...\n"
+            << "  " << argv[0] << " -I -f FILE [-R] -t FILE...\n"
+            << "  " << argv[0] << " -a -f DIR -t FILE...\n"
+            << "  " << argv[0] << " -r -f DIR\n"
+            << "  " << argv[0] << " -b -f FILE [-d FILE]\n"
+            << "  " << argv[0]
+            << " -s -f FILE [-d FILE] [-c BYTES] [-e COUNT] [-p BYTES] [-P]\n"
+            << "  " << argv[0] << " -S -f FILE -u SOCKET [-d FILE] [-c BYTES]"
+            << " [-e COUNT] [-p BYTES] [-P]\n"
+            << "  " << argv[0] << " -s -f DIR\n"
+            << "  " << argv[0] << " -S -f DIR -u SOCKET\n"
+            << "  " << argv[0] << " -x -f FILE [-n COUNT]\n";
         exit(EXIT_SUCCESS);
     }
 
     int command = 0;
-    const char *index_file = nullptr, *texts_file = nullptr;
-    for (int opt; opt = getopt(argc, argv, "f:ist:"), opt != -1; ) {
+    size_t cache_size = default_cache_size,
+        posting_cache_size = default_posting_cache_size,
+        max_expansions = searcher::default_max_expansions,
+        longest = default_longest;
+    const char *index_file = nullptr, *socket_file = nullptr,
+        *store_file = nullptr;
+    vector<string> texts_files;
+    uint map_options = 0U;
+    inversion mode = inversion::append;
+    for (int opt;
+        opt = getopt(argc, argv, "abc:d:e:f:IiSn:Pp:Rrst:u:x"), opt != -1;
+    ) {
         switch (opt) {
             case ':':
                 command = -1;
@@ -39,20 +114,63 @@ int main(const int argc, char ** const argv) {
             case '?':
                 command = -1;
                 break;
+            case 'c':
+            case 'p':
+                if (!parse_size(optarg,
+                        opt == 'c' ? cache_size : posting_cache_size)
+                ) {
+                    command = -1;
+                    cerr << argv[0] << ": invalid cache size -- " << optarg
+                        << '\n';
+                }
+                break;
+            case 'd':
+                store_file = optarg;
+                break;
+            case 'e':
+                if (!parse_size(optarg, max_expansions)) {
+                    command = -1;
+                    cerr << argv[0] << ": invalid expansion count -- "
+                        << optarg << '\n';
+                }
+                break;
+            case 'P':
+                map_options = memmap::populate | memmap::huge_pages;
+                break;
+            case 'R':
+                mode = inversion::sort;
+                break;
+            case 'n':
+                if (!parse_size(optarg, longest)) {
+                    command = -1;
+                    cerr << argv[0] << ": invalid count -- " << optarg
+                        << '\n';
+                }
+                break;
             case 'f':
                 index_file = optarg;
                 break;
+            case 'a':
+            case 'b':
+            case 'I':
             case 'i':
+            case 'r':
+            case 'S':
             case 's':
+            case 'x':
                 if (command != 0) {
                     command = -1;
                     cerr << argv[0] << ": You may not specify more than one "
-                        "'-i' or '-s' option\n";
+                        "'-a', '-b', '-i', '-I', '-r', '-s', '-S' or '-x' "
+                        "option\n";
                 } else
                     command = opt;
                 break;
             case 't':
-                texts_file = optarg;
+                glob_files(optarg, texts_files);
+                break;
+            case 'u':
+                socket_file = optarg;
                 break;
             default:
                 assert(false);
@@ -65,23 +183,178 @@ int main(const int argc, char ** const argv) {
         cerr << argv[0] << ": missing command\n";
     else if (command != -1 && !index_file)
         cerr << argv[0] << ": option requires an argument -- f\n";
-    else if (command == 'i' && !texts_file)
-        cerr << argv[0] << ": option requires an argument -- t\n";
-    if (command <= 0 || !index_file || (command == 'i' && !texts_file)) {
+    else if ((command == 'a' || command == 'i' || command == 'I') &&
+        texts_files.empty()
+    ) cerr << argv[0] << ": option requires an argument -- t\n";
+    else if (command == 'S' && !socket_file)
+        cerr << argv[0] << ": option requires an argument -- u\n";
+    if (command <= 0 || !index_file ||
+        ((command == 'a' || command == 'i' || command == 'I') &&
+            texts_files.empty()) ||
+        (command == 'S' && !socket_file)
+    ) {
         cerr << "Try '" << argv[0] << " --help' for more information.\n";
         exit(EXIT_FAILURE);
     }
 
     try {
+        if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
+            throw runtime_error("main: unable to set locale");
+
+        // A directory holds a segmented index, see -a.
+        if ((command == 's' || command == 'S') && is_directory(index_file))
+            command = command == 's' ? 'd' : 'D';
         switch (command) {
+            case 'a': {
+                segmented_index segments(index_file);
+                segments.append(texts_files);
+                segments.wait();
+                break;
+            }
+            case 'r': {
+                vector<string> titles;
+                for (string title; getline(cin, title); )
+                    titles.push_back(title);
+                segmented_index segments(index_file);
+                cout << segments.remove(titles) << '\n';
+                segments.wait();
+                break;
+            }
             case 'i':
-                ofstream(
-                    index_file,
-                    ios_base::binary | ios_base::out | ios_base::trunc
-                ) << make_index(texts_file);
+                if (store_file) {
+                    doc_store_writer store(store_file);
+                    make_index<true, true>(texts_files, store, mode)
+                        .write(index_file);
+                } else
+                    make_index<true, true>(texts_files, mode)
+                        .write(index_file);
                 break;
-            case 's':
+            case 'I': {
+                index_profile profile;
+                const class index built =
+                    make_index<true, true>(texts_files, profile, mode);
+                const auto start = steady_clock::now();
+                built.write(index_file);
+                print(profile, steady_clock::now() - start);
+                break;
+            }
+            case 'S': {
+                const memmap map(index_file, map_options);
+                posting_cache postings(posting_cache_size);
+                const searcher search(
+                    index_view(static_cast<string_view>(map)), &postings,
+                    max_expansions);
+                result_cache results(cache_size);
+                optional<doc_store> store;
+                if (store_file)
+                    store.emplace(store_file);
+                // Workers already answer queries in parallel.
+                server instance(socket_file,
+                    [&search, &results, &store](
+                        const string_view query,
+                        string &response
+                    ) -> void {
+                        answer(search, results, store ? &*store : nullptr, 1U,
+                            query, response);
+                    },
+                    max(thread::hardware_concurrency(), 1U)
+                );
+                running = &instance;
+                signal(SIGINT, on_signal);
+                signal(SIGTERM, on_signal);
+                instance.run();
+                running = nullptr;
+                print("cache", results.stats());
+                print("postings", postings.lists().stats());
+                print("pairs", postings.pairs().stats());
+                break;
+            }
+            case 's': {
+                const memmap map(index_file, map_options);
+                posting_cache postings(posting_cache_size);
+                const searcher search(
+                    index_view(static_cast<string_view>(map)), &postings,
+                    max_expansions);
+                result_cache results(cache_size);
+                optional<doc_store> store;
+                if (store_file)
+                    store.emplace(store_file);
+                const size_t threads = max(thread::hardware_concurrency(), 1U);
+                for (string query, response; getline(cin, query); ) {
+                    response.clear();
+                    answer(search, results, store ? &*store : nullptr,
+                        threads, query, response);
+                    cout << response;
+                }
+                cout.flush();
+                print("cache", results.stats());
+                print("postings", postings.lists().stats());
+                print("pairs", postings.pairs().stats());
+                break;
+            }
+            case 'D': {
+                const segmented_index segments(index_file);
+                server instance(socket_file,
+                    [&segments](
+                        const string_view query,
+                        string &response
+                    ) -> void {
+                        answer(segments, query, response);
+                    },
+                    max(thread::hardware_concurrency(), 1U)
+                );
+                running = &instance;
+                signal(SIGINT, on_signal);
+                signal(SIGTERM, on_signal);
+                instance.run();
+                running = nullptr;
+                break;
+            }
+            case 'd': {
+                const segmented_index segments(index_file);
+                for (string query, response; getline(cin, query); ) {
+                    response.clear();
+                    answer(segments, query, response);
+                    cout << response;
+                }
+                cout.flush();
+                break;
+            }
+            case 'b': {
+                const memmap map(index_file);
+                const index_view view(static_cast<string_view>(map));
+                const vector<index::doc_id> order = bisection_order(view,
+                    max(thread::hardware_concurrency(), 1U));
+                const string temporary = string(index_file) + ".tmp",
+                    copy = store_file ? string(store_file) + ".tmp" : "";
+                reorder(view, order).write(temporary.c_str());
+                const memmap reordered(temporary.c_str());
+                cerr << "index: " << map.size() << " -> "
+                    << reordered.size() << " bytes\n";
+                // The index and the store are only renamed once both are
+                // written, so that a failed write leaves the old pair in
+                // place. The two renames are not atomic together: if the
+                // second one fails, the reordered store is left in its
+                // temporary file and the index no longer matches the store
+                // until that file is renamed.
+                if (store_file) {
+                    // Documents are read out of order, so the cache should
+                    // hold most of the decompressed blocks.
+                    const doc_store store(store_file, reorder_cache_size);
+                    doc_store_writer writer(copy.c_str());
+                    reorder(store, order, writer);
+                }
+                replace(temporary, index_file);
+                if (store_file)
+                    replace(copy, store_file);
+                break;
+            }
+            case 'x': {
+                const memmap map(index_file);
+                print(index_view(static_cast<string_view>(map)).stats(
+                    longest));
                 break;
+            }
             default:
                 assert(false);
         }
@@ -92,3 +365,215 @@ int main(const int argc, char ** const argv) {
 
     return 0;
 }
+
+// A response holds the number of matches, the titles of the first
+// max_results of them and an empty line that ends it, which no title can
+// be. With a store, every title is followed by a line holding a tab and the
+// snippets of the document.
+static void answer(
+    const searcher &search,
+    result_cache &results,
+    const doc_store * const store,
+    const std::size_t threads,
+    const std::string_view query,
+    std::string &response
+) {
+    using std::make_shared, std::min, std::size_t, std::string,
+        std::to_string, std::vector;
+
+    const vector<string> terms = search.terms(query);
+    string key;
+    for (const string &term : terms)
+        key.append(term).push_back(' ');
+    auto ids = results.find(key);
+    if (ids == nullptr) {
+        ids = make_shared<const vector<index::doc_id>>(search.evaluate(terms));
+        results.insert(key, ids,
+            sizeof(index::doc_id) * ids->size() + key.size());
+    }
+
+    response.append(to_string(ids->size())).push_back('\n');
+    if (store == nullptr) {
+        for (size_t i = 0U; i < min(ids->size(), max_results); ++i)
+            append_line(response, search.view().title((*ids)[i]));
+        response.push_back('\n');
+        return;
+    }
+    const vector<string> snippets = snippet_generator(search.view().flags())(
+        *store, *ids, max_results, terms, threads);
+    for (size_t i = 0U; i < snippets.size(); ++i) {
+        append_line(response, search.view().title((*ids)[i]));
+        response.append(1U, '\t').append(snippets[i]).push_back('\n');
+    }
+    response.push_back('\n');
+}
+
+// Segments are searched without caches: both are keyed by ids that are local
+// to an index file. The response has the format of the one above.
+static void answer(
+    const segmented_index &segments,
+    const std::string_view query,
+    std::string &response
+) {
+    using std::string, std::to_string, std::vector;
+
+    vector<string> titles;
+    const vector<index::doc_id> ids = segments(query, max_results, titles);
+    response.append(to_string(ids.size())).push_back('\n');
+    for (const string &title : titles)
+        append_line(response, title);
+    response.push_back('\n');
+}
+
+// Line breaks and tabs become spaces, as in snippets, so that a title cannot
+// end its line or the response early.
+static void append_line(std::string &response, const std::string_view line) {
+    for (const char c : line)
+        response.push_back(c == '\n' || c == '\r' || c == '\t' ? ' ' : c);
+    response.push_back('\n');
+}
+
+// Appends the files matching a pattern in sorted order, which is the order
+// of the pieces written by split, or the pattern itself if nothing matches.
+static void glob_files(const char * const pattern,
+    std::vector<std::string> &files
+) {
+    glob_t matches{};
+    if (glob(pattern, GLOB_NOCHECK, nullptr, &matches) == 0) [[likely]]
+        files.insert(files.end(), matches.gl_pathv,
+            matches.gl_pathv + matches.gl_pathc);
+    else
+        files.emplace_back(pattern);
+    globfree(&matches);
+}
+
+// Renames a complete temporary file over the file it replaces.
+static void replace(const std::string &temporary, const char * const file) {
+    using std::generic_category, std::rename, std::system_error;
+
+    if (rename(temporary.c_str(), file) == -1) [[unlikely]]
+        throw system_error(errno, generic_category(),
+            "replace: unable to rename file");
+}
+
+static bool is_directory(const char * const path) noexcept {
+    struct stat info{};
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static void on_signal(int) noexcept {
+    if (running != nullptr)
+        running->stop();
+}
+
+static bool parse_size(const char * const str, std::size_t &size) {
+    using std::errc, std::from_chars, std::strlen;
+
+    const char * const last = str + strlen(str);
+    const auto [ptr, errnum] = from_chars(str, last, size);
+    return ptr == last && errnum == errc();
+}
+
+static void print(const char * const name, const cache_statistics &stats) {
+    using std::cerr;
+
+    const std::size_t lookups = stats.hits + stats.misses;
+    cerr << name << ": " << stats.hits << " hits, " << stats.misses
+        << " misses, " << stats.rejections << " rejections, "
+        << stats.evictions << " evictions, "
+        << (lookups == 0U ? 0U : stats.hits * 100U / lookups) << "% hit rate, "
+        << stats.entries << " entries, " << stats.size << " bytes\n";
+}
+
+// Wall and CPU time with the rates of every stage, then the whole run.
+static void print(
+    const index_profile &profile,
+    const std::chrono::nanoseconds write_time
+) {
+    using std::cerr, std::chrono::duration_cast, std::chrono::milliseconds,
+        std::size_t, std::uint64_t;
+
+    stage_statistics total{};
+    for (size_t i = 0U; i < profile.stages.size(); ++i) {
+        const stage_statistics &stats = profile.stages[i];
+        const uint64_t wall = stats.wall_time == 0U ? 1U : stats.wall_time;
+        cerr << index_profile::names[i] << ": "
+            << stats.wall_time / 1000000U << " ms wall, "
+            << stats.cpu_time / 1000000U << " ms cpu, "
+            << stats.bytes * 1000U / wall << " MB/s, "
+            << stats.tokens * 1000000000U / wall << " tokens/s\n";
+        total.wall_time += stats.wall_time;
+        total.cpu_time += stats.cpu_time;
+    }
+    cerr << "write: " << duration_cast<milliseconds>(write_time).count()
+        << " ms wall\n" << "total: " << total.wall_time / 1000000U
+        << " ms wall, " << total.cpu_time / 1000000U << " ms cpu\n";
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    cerr << "memory: " << usage.ru_maxrss << " KiB peak RSS, "
+        << allocations() << " allocations\n";
+}
+
+static void print(const index_statistics &stats) {
+    using std::array, std::cout, std::size_t, std::uint64_t;
+
+    // In the order of index::container.
+    static constexpr array<const char *, 3U> container_names = {{
+        "d-gaps", "runs", "bitmaps"
+    }};
+
+    cout << "documents: " << stats.documents << '\n'
+        << "terms: " << stats.terms << '\n'
+        << "postings: " << stats.postings << '\n'
+        << "posting list lengths:\n";
+    for (size_t i = 0U; i < stats.lengths.size(); ++i) {
+        const uint64_t low = uint64_t{1} << i, high = (low << 1U) - 1U;
+        cout << "  " << low;
+        if (high != low)
+            cout << '-' << high;
+        cout << ": " << stats.lengths[i] << '\n';
+    }
+
+    const uint64_t total = stats.header_bytes + stats.title_bytes +
+        stats.dictionary_bytes + stats.hash_bytes + stats.gram_bytes +
+        stats.posting_table_bytes + stats.posting_bytes;
+    cout << "bytes:\n"
+        << "  header: " << stats.header_bytes << '\n'
+        << "  titles: " << stats.title_bytes << '\n'
+        << "  dictionary: " << stats.dictionary_bytes << '\n'
+        << "  hash: " << stats.hash_bytes << '\n'
+        << "  grams: " << stats.gram_bytes << '\n'
+        << "  posting table: " << stats.posting_table_bytes << '\n'
+        << "  postings: " << stats.posting_bytes << '\n'
+        << "  total: " << total << '\n';
+
+    const auto ratio = [](const uint64_t raw, const uint64_t stored) {
+        return stored == 0U ? 0.0 :
+            static_cast<double>(raw) / static_cast<double>(stored);
+    };
+    cout << "front coding: " << stats.term_bytes << " term bytes in "
+        << stats.dictionary_bytes << " bytes, ratio "
+        << ratio(stats.term_bytes, stats.dictionary_bytes) << '\n'
+        << "posting lists: " << stats.postings << " postings in "
+        << stats.posting_bytes << " bytes, "
+        << ratio(stats.posting_bytes * 8U, stats.postings)
+        << " bits per posting, ratio "
+        << ratio(stats.postings * sizeof(index::doc_id), stats.posting_bytes)
+        << '\n';
+    for (size_t i = 0U; i < stats.containers.size(); ++i) {
+        const container_statistics &container = stats.containers[i];
+        cout << "  " << container_names[i] << ": " << container.lists
+            << " lists, " << container.postings << " postings in "
+            << container.bytes << " bytes, "
+            << ratio(container.bytes * 8U, container.postings)
+            << " bits per posting, ratio "
+            << ratio(container.postings * sizeof(index::doc_id),
+                container.bytes)
+            << '\n';
+    }
+
+    cout << "longest posting lists:\n";
+    for (const auto &[term, frequency] : stats.longest)
+        cout << "  " << term << ": " << frequency << '\n';
+}
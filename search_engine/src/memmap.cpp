@@ -1,17 +1,20 @@
-#include <cerrno> // errno
+#include <cerrno> // EINVAL, errno
 
+#include <algorithm> // max, min
 #include <system_error> // generic_category, system_error
 
 #include <fcntl.h> // O_RDONLY, open
-#include <sys/mman.h> // MAP_FAILED, MAP_SHARED, PROT_READ, mmap, munmap
+#include <sys/mman.h> // MADV_*, MAP_*, PROT_READ, madvise, mmap, munmap
 #include <sys/stat.h> // fstat
-#include <unistd.h> // close
+#include <unistd.h> // _SC_PAGESIZE, close, sysconf
 
 #include <search_engine/memmap.hpp>
 
 using std::cerr, std::endl, std::exception, std::generic_category,
     std::logic_error, std::size_t, std::system_error;
 
+static size_t page_size() noexcept;
+
 memmap::memmap() noexcept : addr_(MAP_FAILED) {}
 
 memmap::memmap(memmap &&rhs) : memmap() {
@@ -20,8 +23,7 @@ memmap::memmap(memmap &&rhs) : memmap() {
     *this = move(rhs);
     assert(
         rhs.addr_ == MAP_FAILED &&
-        rhs.size_ == size_limits::max() &&
-        !rhs.file_.is_open()
+        rhs.size_ == size_limits::max()
     );
 }
 
@@ -30,8 +32,7 @@ memmap &memmap::operator=(memmap &&rhs) {
         close();
     assert(
         addr_ == MAP_FAILED &&
-        size_ == size_limits::max() &&
-        !file_.is_open()
+        size_ == size_limits::max()
     );
 
     swap(rhs);
@@ -49,11 +50,49 @@ memmap::~memmap() noexcept {
         }
     assert(
         addr_ == MAP_FAILED &&
-        size_ == size_limits::max() &&
-        !file_.is_open()
+        size_ == size_limits::max()
     );
 }
 
+void memmap::advance(
+    const size_t offset,
+    const size_t window,
+    const bool release
+) {
+    using std::max, std::min;
+
+    if (!is_open()) [[unlikely]]
+        throw logic_error("memmap::advance: memory map is not open");
+    if (addr_ == MAP_FAILED) [[unlikely]]
+        return;
+
+    // Advise again once half of the window has been consumed.
+    const size_t page = page_size(), first = min(offset, size_) / page * page,
+        last = min(size_, offset + window);
+    if (const size_t from = max(advised_ / page * page, first);
+        last > advised_ && last - from >= window / 2U
+    ) {
+        if (madvise(const_cast<char *>(data()) + from, last - from,
+                MADV_WILLNEED) == -1
+        ) [[unlikely]] throw system_error(errno, generic_category(),
+            "memmap::advance");
+        advised_ = last;
+    }
+
+    // Release in steps of a window as well. MADV_PAGEOUT reclaims the pages
+    // from the page cache where nothing else maps them; kernels before 5.4
+    // reject it, and then the pages are only unmapped.
+    if (release && first >= released_ + max(window, page)) {
+        void * const from = const_cast<char *>(data()) + released_;
+        if ((madvise(from, first - released_, MADV_PAGEOUT) == -1 &&
+                errno != EINVAL) ||
+            madvise(from, first - released_, MADV_DONTNEED) == -1
+        ) [[unlikely]] throw system_error(errno, generic_category(),
+            "memmap::advance");
+        released_ = first;
+    }
+}
+
 void memmap::close() {
     if (!is_open()) [[unlikely]]
         throw logic_error("memmap::close: memory map is not open");
@@ -61,33 +100,15 @@ void memmap::close() {
         (addr_ == MAP_FAILED && size_ == 0) ||
         (addr_ != MAP_FAILED && size_ > 0)
     );
-    assert(size_ != size_limits::max() && file_.is_open());
+    assert(size_ != size_limits::max());
 
-    int errnum = 0;
-    if (addr_ != MAP_FAILED && munmap(const_cast<void *>(addr_), size_) == -1)
-        [[unlikely]] errnum = errno;
+    const int returns = addr_ == MAP_FAILED ? 0 :
+        munmap(const_cast<void *>(addr_), size_);
     addr_ = MAP_FAILED;
     size_ = size_limits::max();
-
-    try {
-        file_.close();
-    } catch (const exception &except) {
-        if (errnum == 0)
-            errnum = errno;
-        else {
-#           ifndef NDEBUG
-            cerr << except.what() << endl;
-#           endif
-        }
-    }
-    assert(
-        addr_ == MAP_FAILED &&
-        size_ == size_limits::max() &&
-        !file_.is_open()
-    );
-
-    if (errnum != 0) [[unlikely]]
-        throw system_error(errnum, generic_category(), "memmap::close");
+    advised_ = released_ = 0U;
+    if (returns == -1) [[unlikely]]
+        throw system_error(errno, generic_category(), "memmap::close");
 }
 
 const char *memmap::data() const {
@@ -96,31 +117,37 @@ const char *memmap::data() const {
     return addr_ == MAP_FAILED ? nullptr : static_cast<const char *>(addr_);
 }
 
-void memmap::open(const char * const filename) {
+void memmap::open(const char * const filename, const uint options) {
     if (is_open()) [[unlikely]]
         throw logic_error("memmap::open: memory map is already open");
     assert(
         addr_ == MAP_FAILED &&
-        size_ == size_limits::max() &&
-        !file_.is_open()
+        size_ == size_limits::max()
     );
 
-    file_.open(filename);
-    size_ = 0;
-
-    if (const size_t len = file_.size(); len != 0) {
-        assert(len != size_limits::max());
-        addr_ = mmap(nullptr, len, PROT_READ, MAP_SHARED, file_.fildes(), 0);
+    const file mapped(filename);
+    const size_t len = mapped.size();
+    assert(len != size_limits::max());
+    if (len != 0) {
+        addr_ = mmap(nullptr, len, PROT_READ,
+            MAP_SHARED | ((options & populate) != 0U ? MAP_POPULATE : 0),
+            mapped.fildes(), 0);
         if (addr_ == MAP_FAILED) [[unlikely]]
             throw system_error(errno, generic_category(), "memmap::open");
-        size_ = len;
+
+        // Advice that the kernel does not support is not an error.
+        if ((options & sequential) != 0U)
+            madvise(const_cast<void *>(addr_), len, MADV_SEQUENTIAL);
+        if ((options & huge_pages) != 0U)
+            madvise(const_cast<void *>(addr_), len, MADV_HUGEPAGE);
     }
+    size_ = len;
 
     assert(
         (addr_ == MAP_FAILED && size_ == 0) ||
         (addr_ != MAP_FAILED && size_ > 0)
     );
-    assert(size_ != size_limits::max() && file_.is_open());
+    assert(size_ != size_limits::max());
 }
 
 void memmap::file::close() {
@@ -155,3 +182,8 @@ size_t memmap::file::size() const {
     else
         return static_cast<size_t>(buf.st_size);
 }
+
+static size_t page_size() noexcept {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
@@ -0,0 +1,181 @@
+#include <algorithm> // max, sort
+#include <bit> // popcount
+#include <numeric> // iota
+#include <ranges> // iota_view
+#include <stdexcept> // logic_error
+#include <utility> // move, pair
+
+#include <search_engine/algorithm.hpp>
+#include <search_engine/perfect_hash.hpp>
+
+using std::optional, std::size_t, std::string_view, std::uint32_t,
+    std::uint64_t, std::vector;
+
+perfect_hash::perfect_hash(
+    const uint64_t * const words,
+    const size_t count,
+    const size_t keys
+) : size_(keys) {
+    using std::logic_error;
+    static constexpr const char *what = "perfect_hash::perfect_hash: invalid "
+        "hash";
+
+    if (count < 3U || words[0] > max_levels || words[1] > keys ||
+        count < 3U + words[0]
+    ) [[unlikely]] throw logic_error(what);
+    levels_ = words[0];
+    fallbacks_ = words[1];
+    offsets_ = words + 2U;
+    if (offsets_[0] != 0U) [[unlikely]]
+        throw logic_error(what);
+    for (size_t i = 1U; i <= levels_; ++i)
+        if (offsets_[i] < offsets_[i - 1U] ||
+            offsets_[i] > count
+        ) [[unlikely]] throw logic_error(what);
+
+    const size_t bits = offsets_[levels_];
+    if (count != 3U + levels_ + bits + (bits + rank_words - 1U) / rank_words +
+        2U * fallbacks_ + (keys + 1U) / 2U + (keys + 7U) / 8U
+    ) [[unlikely]] throw logic_error(what);
+    bits_ = offsets_ + levels_ + 1U;
+    ranks_ = bits_ + bits;
+    fallback_ = ranks_ + (bits + rank_words - 1U) / rank_words;
+    ids_ = reinterpret_cast<const uint32_t *>(fallback_ + 2U * fallbacks_);
+    fingerprints_ = reinterpret_cast<const uchar *>(
+        reinterpret_cast<const uint64_t *>(ids_) + (keys + 1U) / 2U);
+}
+
+vector<uint64_t> perfect_hash::encode(const vector<string_view> &terms) {
+    using std::iota, std::max, std::move, std::pair, std::popcount, std::sort;
+
+    vector<uint64_t> hashes(terms.size());
+    for (size_t i = 0U; i < terms.size(); ++i)
+        hashes[i] = hash(terms[i]);
+
+    vector<vector<uint64_t>> levels;
+    vector<uint32_t> remaining(terms.size()), next;
+    iota(remaining.begin(), remaining.end(), 0U);
+    while (!remaining.empty() && levels.size() < max_levels) {
+        const size_t words = max<size_t>(1U, (remaining.size() *
+            gamma_numerator / gamma_denominator + 63U) / 64U);
+        vector<uint64_t> seen(words), collided(words);
+        for (const uint32_t key : remaining) {
+            const size_t bit =
+                position(hashes[key], levels.size(), words * 64U);
+            const uint64_t mask = uint64_t{1U} << (bit % 64U);
+            (seen[bit / 64U] & mask ? collided : seen)[bit / 64U] |= mask;
+        }
+        next.clear();
+        for (const uint32_t key : remaining) {
+            const size_t bit =
+                position(hashes[key], levels.size(), words * 64U);
+            if (collided[bit / 64U] >> (bit % 64U) & 1U)
+                next.push_back(key);
+        }
+        for (size_t i = 0U; i < words; ++i)
+            seen[i] &= ~collided[i];
+        levels.push_back(move(seen));
+        remaining.swap(next);
+    }
+
+    vector<pair<uint64_t, uint32_t>> fallback;
+    fallback.reserve(remaining.size());
+    for (const uint32_t key : remaining)
+        fallback.emplace_back(hashes[key], key);
+    sort(fallback.begin(), fallback.end());
+
+    vector<uint64_t> returns{levels.size(), fallback.size(), 0U};
+    for (const vector<uint64_t> &level : levels)
+        returns.push_back(returns.back() + level.size());
+    const size_t bits = returns.back();
+    for (const vector<uint64_t> &level : levels)
+        returns.insert(returns.cend(), level.cbegin(), level.cend());
+    size_t placed = 0U;
+    for (size_t i = 0U; i < bits; ++i) {
+        if (i % rank_words == 0U)
+            returns.push_back(placed);
+        placed += static_cast<size_t>(popcount(
+            returns[3U + levels.size() + i]));
+    }
+    for (const auto &[value, key] : fallback)
+        returns.insert(returns.cend(), {value, placed++});
+    const size_t first = returns.size();
+    returns.resize(first + (terms.size() + 1U) / 2U +
+        (terms.size() + 7U) / 8U);
+
+    auto * const ids = reinterpret_cast<uint32_t *>(returns.data() + first);
+    auto * const fingerprints = reinterpret_cast<uchar *>(
+        returns.data() + first + (terms.size() + 1U) / 2U);
+    for (size_t i = 0U; i < fallback.size(); ++i) {
+        const size_t slot = terms.size() - fallback.size() + i;
+        ids[slot] = fallback[i].second;
+        fingerprints[slot] = fingerprint(fallback[i].first);
+    }
+    const perfect_hash view(returns.data(), returns.size(), terms.size());
+    for (size_t i = 0U, j = 0U; i < terms.size(); ++i) {
+        if (j < remaining.size() && remaining[j] == i) {
+            ++j;
+            continue;
+        }
+        const size_t slot = *view.slot(hashes[i]);
+        ids[slot] = static_cast<uint32_t>(i);
+        fingerprints[slot] = fingerprint(hashes[i]);
+    }
+    return returns;
+}
+
+optional<perfect_hash::term_id> perfect_hash::find(
+    const string_view term
+) const noexcept {
+    const uint64_t value = hash(term);
+    const optional<size_t> found = slot(value);
+    if (!found.has_value() || *found >= size_ ||
+        fingerprints_[*found] != fingerprint(value) || ids_[*found] >= size_
+    ) return {};
+    return ids_[*found];
+}
+
+optional<size_t> perfect_hash::slot(const uint64_t value) const noexcept {
+    using std::popcount, std::ranges::iota_view;
+
+    for (size_t level = 0U; level < levels_; ++level) {
+        const size_t bits = (offsets_[level + 1U] - offsets_[level]) * 64U;
+        if (bits == 0U) [[unlikely]]
+            continue;
+        const size_t bit = position(value, level, bits),
+            word = offsets_[level] + bit / 64U;
+        const uint64_t mask = uint64_t{1U} << (bit % 64U);
+        if ((bits_[word] & mask) == 0U)
+            continue;
+        size_t returns = ranks_[word / rank_words];
+        for (size_t i = word / rank_words * rank_words; i < word; ++i)
+            returns += static_cast<size_t>(popcount(bits_[i]));
+        return returns +
+            static_cast<size_t>(popcount(bits_[word] & (mask - 1U)));
+    }
+
+    class fallback_less final {
+    public:
+        explicit fallback_less(const uint64_t *fallback) noexcept
+            : fallback_(fallback) {}
+
+        bool operator()(const uint32_t lhs, const uint64_t rhs) const {
+            return fallback_[2U * lhs] < rhs;
+        }
+
+        bool operator()(const uint64_t lhs, const uint32_t rhs) const {
+            return lhs < fallback_[2U * rhs];
+        }
+
+    private:
+        const uint64_t *fallback_;
+    };
+
+    const iota_view<uint32_t, uint32_t> ids(0U,
+        static_cast<uint32_t>(fallbacks_));
+    const auto iter = ::binary_search(ids.begin(), ids.end(), value,
+        fallback_less(fallback_));
+    if (iter == ids.end())
+        return {};
+    return fallback_[2U * *iter + 1U];
+}
@@ -0,0 +1,46 @@
+#include <algorithm> // copy_n, min
+
+#include <search_engine/posting_pool.hpp>
+
+using std::size_t, std::uint64_t, std::vector;
+
+void posting_pool::copy(const list &postings, vector<doc_id> &ids) const {
+    using std::copy_n, std::min;
+
+    ids.resize(postings.size);
+    uint64_t position = postings.first;
+    for (size_t copied = 0U; copied < postings.size; ) {
+        const size_t block = block_size(copied),
+            count = min<size_t>(block, postings.size - copied);
+        copy_n(&at(position), count, ids.data() + copied);
+        copied += count;
+        if (copied < postings.size)
+            position = uint64_t{at(position + block)} |
+                uint64_t{at(position + block + 1U)} << 32U;
+    }
+}
+
+uint64_t posting_pool::allocate(const size_t size) {
+    if (used_ + size > slab_size) {
+        slabs_.emplace_back(slab_size);
+        used_ = 0U;
+    }
+    const uint64_t returns = (slabs_.size() - 1U) * slab_size + used_;
+    used_ += size;
+    return returns;
+}
+
+// Starts the next block of a list; when the list is not empty, its tail is
+// at the link of its full last block.
+void posting_pool::grow(list &postings) {
+    const size_t block = block_size(postings.size);
+    const uint64_t position = allocate(block + link_size);
+    if (postings.size == 0U)
+        postings.first = position;
+    else {
+        at(postings.tail) = static_cast<doc_id>(position);
+        at(postings.tail + 1U) = static_cast<doc_id>(position >> 32U);
+    }
+    postings.tail = position;
+    postings.free = static_cast<std::uint32_t>(block);
+}
@@ -0,0 +1,233 @@
+#include <cassert> // assert
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstdlib> // EXIT_FAILURE, EXIT_SUCCESS, exit
+#include <cstring> // strcmp, strlen
+
+#include <algorithm> // max
+#include <array> // array
+#include <atomic> // atomic
+#include <charconv> // from_chars
+#include <chrono> // duration, duration_cast, nanoseconds, steady_clock
+#include <exception> // exception, exception_ptr
+#include <fstream> // ifstream
+#include <iostream> // cerr, cout, ios_base
+#include <stdexcept> // runtime_error
+#include <string> // getline, string
+#include <string_view> // string_view
+#include <system_error> // errc
+#include <thread> // sleep_until, thread
+#include <vector> // vector
+
+#include <unistd.h> // getopt
+
+#include <search_engine/histogram.hpp>
+#include <search_engine/index_view.hpp>
+#include <search_engine/memmap.hpp>
+#include <search_engine/posting_cache.hpp>
+#include <search_engine/searcher.hpp>
+
+// Replays a query file against an index. Closed loop: every thread issues
+// its next query as soon as the previous one returns, which measures peak
+// throughput. Open loop: query i is due at start + i / rate whatever the
+// state of the threads, and its latency counts from that moment, so queuing
+// behind slow queries shows in the tail instead of lowering the load.
+
+enum query_type : std::size_t { boolean, wildcard, fuzzy };
+
+static constexpr std::array<std::string_view, 3U> type_names = {{
+    "boolean", "wildcard", "fuzzy"
+}};
+
+using latencies = std::array<histogram, type_names.size()>;
+
+static constexpr std::size_t default_posting_cache_size = 1U << 26U;
+
+static bool parse_size(const char *, std::size_t &);
+static void print(std::string_view, const histogram &);
+static query_type type(std::string_view) noexcept;
+
+int main(const int argc, char ** const argv) {
+    using std::atomic, std::cerr, std::cout, std::exception,
+        std::exception_ptr, std::exit, std::getline, std::ifstream,
+        std::ios_base, std::max, std::runtime_error, std::setlocale,
+        std::size_t, std::strcmp, std::string, std::string_view, std::thread,
+        std::uint64_t, std::vector, std::chrono::duration,
+        std::chrono::duration_cast, std::chrono::nanoseconds,
+        std::chrono::steady_clock;
+    ios_base::sync_with_stdio(false);
+    cerr.tie(nullptr);
+
+    if (argc < 2) {
+        cerr << argv[0] << ": not enough arguments\n";
+        exit(EXIT_FAILURE);
+    } else if (strcmp(argv[1], "--help") == 0) {
+        cout << "Usage:\n"
+            << "  " << argv[0] << " -f FILE -q FILE [-e COUNT] [-j THREADS]"
+            << " [-n COUNT] [-p BYTES] [-r RATE]\n";
+        exit(EXIT_SUCCESS);
+    }
+
+    bool failed = false;
+    size_t max_expansions = searcher::default_max_expansions,
+        posting_cache_size = default_posting_cache_size, rate = 0U,
+        threads = max(thread::hardware_concurrency(), 1U), total = 0U;
+    const char *index_file = nullptr, *queries_file = nullptr;
+    for (int opt; opt = getopt(argc, argv, "e:f:j:n:p:q:r:"), opt != -1; ) {
+        switch (opt) {
+            case ':':
+            case '?':
+                failed = true;
+                break;
+            case 'e':
+            case 'j':
+            case 'n':
+            case 'p':
+            case 'r':
+                if (!parse_size(optarg,
+                        opt == 'e' ? max_expansions :
+                        opt == 'j' ? threads :
+                        opt == 'n' ? total :
+                        opt == 'p' ? posting_cache_size : rate) ||
+                    (opt == 'j' && threads == 0U)
+                ) {
+                    failed = true;
+                    cerr << argv[0] << ": invalid number -- " << optarg
+                        << '\n';
+                }
+                break;
+            case 'f':
+                index_file = optarg;
+                break;
+            case 'q':
+                queries_file = optarg;
+                break;
+            default:
+                assert(false);
+        }
+    }
+    if (!failed && !index_file) {
+        failed = true;
+        cerr << argv[0] << ": option requires an argument -- f\n";
+    } else if (!failed && !queries_file) {
+        failed = true;
+        cerr << argv[0] << ": option requires an argument -- q\n";
+    }
+    if (failed) {
+        cerr << "Try '" << argv[0] << " --help' for more information.\n";
+        exit(EXIT_FAILURE);
+    }
+
+    try {
+        if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
+            throw runtime_error("main: unable to set locale");
+
+        vector<string> queries;
+        ifstream input(queries_file);
+        if (!input) [[unlikely]]
+            throw runtime_error("main: unable to open query file");
+        for (string query; getline(input, query); )
+            if (!query.empty())
+                queries.push_back(query);
+        if (queries.empty()) [[unlikely]]
+            throw runtime_error("main: no queries");
+        if (total == 0U)
+            total = queries.size();
+
+        const memmap map(index_file);
+        posting_cache postings(posting_cache_size);
+        const searcher search(index_view(static_cast<string_view>(map)),
+            &postings, max_expansions);
+
+        atomic<size_t> next = 0U;
+        vector<latencies> results(threads);
+        vector<exception_ptr> errors(threads);
+        const auto start = steady_clock::now();
+        const auto due = [start, rate](const size_t i) noexcept {
+            return start + duration_cast<nanoseconds>(duration<double>(
+                static_cast<double>(i) / static_cast<double>(rate)));
+        };
+        const auto run = [&](const size_t id) noexcept -> void {
+            try {
+                for (size_t i; i = next++, i < total; ) {
+                    const string &query = queries[i % queries.size()];
+                    auto issued = steady_clock::now();
+                    if (rate != 0U) {
+                        issued = due(i);
+                        std::this_thread::sleep_until(issued);
+                    }
+                    static_cast<void>(search(query));
+                    results[id][type(query)].record(static_cast<uint64_t>(
+                        duration_cast<nanoseconds>(
+                            steady_clock::now() - issued).count()));
+                }
+            } catch (...) {
+                errors[id] = std::current_exception();
+            }
+        };
+        vector<thread> workers;
+        for (size_t i = 1U; i < threads; ++i)
+            workers.emplace_back(run, i);
+        run(0U);
+        for (thread &worker : workers)
+            worker.join();
+        const double seconds =
+            duration<double>(steady_clock::now() - start).count();
+        for (const exception_ptr &error : errors)
+            if (error != nullptr) [[unlikely]]
+                std::rethrow_exception(error);
+
+        latencies merged;
+        histogram all;
+        for (const latencies &thread_results : results)
+            for (size_t i = 0U; i < merged.size(); ++i)
+                merged[i] += thread_results[i];
+        for (size_t i = 0U; i < merged.size(); ++i) {
+            all += merged[i];
+            if (merged[i].count() != 0U)
+                print(type_names[i], merged[i]);
+        }
+        print("all", all);
+        cout << (rate == 0U ? "closed" : "open") << " loop, " << threads
+            << " threads, " << total << " queries in " << seconds << " s, "
+            << static_cast<double>(total) / seconds << " queries/s\n";
+    } catch (const exception &except) {
+        cerr << except.what() << '\n';
+        exit(EXIT_FAILURE);
+    }
+
+    return 0;
+}
+
+static bool parse_size(const char * const str, std::size_t &size) {
+    using std::errc, std::from_chars, std::strlen;
+
+    const char * const last = str + strlen(str);
+    const auto [ptr, errnum] = from_chars(str, last, size);
+    return ptr == last && errnum == errc();
+}
+
+// Latencies are recorded in nanoseconds and printed in microseconds.
+static void print(const std::string_view name, const histogram &values) {
+    using std::cout;
+
+    cout << name << ": " << values.count() << " queries, mean "
+        << values.mean() / 1e3 << " us, p50 "
+        << static_cast<double>(values.quantile(0.5)) / 1e3 << " us, p90 "
+        << static_cast<double>(values.quantile(0.9)) / 1e3 << " us, p99 "
+        << static_cast<double>(values.quantile(0.99)) / 1e3 << " us, p99.9 "
+        << static_cast<double>(values.quantile(0.999)) / 1e3 << " us, max "
+        << static_cast<double>(values.max()) / 1e3 << " us\n";
+}
+
+static query_type type(const std::string_view query) noexcept {
+    using std::string_view;
+
+    if (query.find('*') != string_view::npos)
+        return wildcard;
+    else if (query.find('~') != string_view::npos)
+        return fuzzy;
+    else
+        return boolean;
+}
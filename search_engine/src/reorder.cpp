@@ -0,0 +1,240 @@
+#include <cstdint> // uint32_t, uint64_t
+
+#include <algorithm> // min, sort
+#include <cmath> // log2
+#include <exception> // current_exception, exception_ptr, rethrow_exception
+#include <span> // span
+#include <thread> // jthread
+#include <utility> // pair
+
+#include <search_engine/reorder.hpp>
+
+using std::size_t, std::span, std::uint32_t, std::uint64_t, std::vector;
+
+using doc_id = index::doc_id;
+
+// Documents with their terms, as compact ids of the terms kept, in CSR form.
+struct forward_index final {
+    vector<uint64_t> offsets{};
+    vector<uint32_t> terms{};
+    size_t term_count = 0U;
+};
+
+// Degrees of the terms in both halves of the range being split, the gains
+// of moving a document that holds them, and the terms touched, which are
+// the only entries reset after a pass.
+struct workspace final {
+    explicit workspace(size_t terms)
+        : left(terms, 0U), right(terms, 0U), left_gain(terms, 0.0),
+        right_gain(terms, 0.0) {}
+
+    vector<uint32_t> left;
+    vector<uint32_t> right;
+    vector<double> left_gain;
+    vector<double> right_gain;
+    vector<uint32_t> touched{};
+    vector<std::pair<double, doc_id>> moves{};
+};
+
+static void bisect(const forward_index &, span<doc_id>, size_t, size_t,
+    workspace &);
+static double cost(double, double) noexcept;
+
+vector<doc_id> bisection_order(
+    const index_view &view,
+    const size_t threads,
+    const size_t iterations
+) {
+    forward_index documents;
+    vector<uint32_t> compact(view.terms(), 0U);
+    vector<doc_id> ids;
+    documents.offsets.assign(view.size() + 1U, 0U);
+    for (auto iter = view.dictionary().begin();
+        iter != view.dictionary().end();
+        ++iter
+    ) {
+        if (view.frequency(iter.id()) < 2U)
+            continue;
+        compact[iter.id()] = static_cast<uint32_t>(documents.term_count++);
+        view.postings(iter.id(), ids);
+        for (const doc_id id : ids)
+            ++documents.offsets[id + 1U];
+    }
+    for (size_t i = 1U; i < documents.offsets.size(); ++i)
+        documents.offsets[i] += documents.offsets[i - 1U];
+    documents.terms.resize(documents.offsets.back());
+    vector<uint64_t> next(documents.offsets.cbegin(),
+        documents.offsets.cend() - 1);
+    for (auto iter = view.dictionary().begin();
+        iter != view.dictionary().end();
+        ++iter
+    ) {
+        if (view.frequency(iter.id()) < 2U)
+            continue;
+        view.postings(iter.id(), ids);
+        for (const doc_id id : ids)
+            documents.terms[next[id]++] = compact[iter.id()];
+    }
+
+    vector<doc_id> order(view.size());
+    for (size_t i = 0U; i < order.size(); ++i)
+        order[i] = static_cast<doc_id>(i);
+    size_t parallel_depth = 0U;
+    while ((size_t{2} << parallel_depth) <= threads)
+        ++parallel_depth;
+    workspace space(documents.term_count);
+    bisect(documents, order, iterations, parallel_depth, space);
+    return order;
+}
+
+class index reorder(const index_view &view, const vector<doc_id> &order) {
+    using std::sort;
+
+    index returns(view.flags());
+    returns.reserve(view.terms());
+    vector<doc_id> renumbered(view.size());
+    for (const doc_id id : order)
+        renumbered[id] = returns.insert_document(view.title(id));
+    vector<doc_id> ids;
+    for (auto iter = view.dictionary().begin();
+        iter != view.dictionary().end();
+        ++iter
+    ) {
+        view.postings(iter.id(), ids);
+        for (doc_id &id : ids)
+            id = renumbered[id];
+        sort(ids.begin(), ids.end());
+        returns.insert_postings(*iter, ids, 0U);
+    }
+    return returns;
+}
+
+void reorder(
+    const doc_store &store,
+    const vector<doc_id> &order,
+    doc_store_writer &writer
+) {
+    for (const doc_id id : order) {
+        const stored_document document = store.get(id);
+        writer.add(document.title, document.text);
+    }
+    writer.finish();
+}
+
+// Splits the documents in two halves, improves the split by swapping the
+// documents with the highest combined gains until no pair gains anything,
+// and recurses. Ties are broken by id, so the order is deterministic.
+static void bisect(
+    const forward_index &documents,
+    const span<doc_id> range,
+    const size_t iterations,
+    const size_t parallel_depth,
+    workspace &space
+) {
+    using std::current_exception, std::exception_ptr, std::jthread,
+        std::min, std::rethrow_exception, std::sort;
+    static constexpr size_t leaf = 16U;
+
+    if (range.size() <= leaf)
+        return;
+    const span<doc_id> left = range.first(range.size() / 2U),
+        right = range.subspan(range.size() / 2U);
+    const auto terms = [&documents](const doc_id id) -> span<const uint32_t> {
+        return span(documents.terms).subspan(documents.offsets[id],
+            documents.offsets[id + 1U] - documents.offsets[id]);
+    };
+    const auto sorted_gains = [&](const span<doc_id> half,
+        const vector<double> &gains
+    ) -> void {
+        space.moves.clear();
+        for (const doc_id id : half) {
+            double gain = 0.0;
+            for (const uint32_t term : terms(id))
+                gain += gains[term];
+            space.moves.emplace_back(-gain, id);
+        }
+        sort(space.moves.begin(), space.moves.end());
+    };
+
+    for (size_t iteration = 0U; iteration < iterations; ++iteration) {
+        space.touched.clear();
+        for (const doc_id id : left)
+            for (const uint32_t term : terms(id)) {
+                if (space.left[term]++ == 0U && space.right[term] == 0U)
+                    space.touched.push_back(term);
+            }
+        for (const doc_id id : right)
+            for (const uint32_t term : terms(id)) {
+                if (space.right[term]++ == 0U && space.left[term] == 0U)
+                    space.touched.push_back(term);
+            }
+        const auto left_size = static_cast<double>(left.size()),
+            right_size = static_cast<double>(right.size());
+        for (const uint32_t term : space.touched) {
+            const auto in_left = static_cast<double>(space.left[term]),
+                in_right = static_cast<double>(space.right[term]);
+            const double before = cost(in_left, left_size) +
+                cost(in_right, right_size);
+            space.left_gain[term] = space.left[term] == 0U ? 0.0 : before -
+                cost(in_left - 1.0, left_size) -
+                cost(in_right + 1.0, right_size);
+            space.right_gain[term] = space.right[term] == 0U ? 0.0 : before -
+                cost(in_left + 1.0, left_size) -
+                cost(in_right - 1.0, right_size);
+        }
+
+        sorted_gains(left, space.left_gain);
+        vector<std::pair<double, doc_id>> left_moves;
+        left_moves.swap(space.moves);
+        sorted_gains(right, space.right_gain);
+        size_t swapped = 0U;
+        for (size_t i = 0U; i < min(left_moves.size(), space.moves.size()) &&
+            -left_moves[i].first - space.moves[i].first > 0.0; ++i
+        ) {
+            left[i] = space.moves[i].second;
+            right[i] = left_moves[i].second;
+            ++swapped;
+        }
+        // Rewrites the rest of both halves in the order of the moves, which
+        // keeps every document exactly once.
+        for (size_t i = swapped; i < left_moves.size(); ++i)
+            left[i] = left_moves[i].second;
+        for (size_t i = swapped; i < space.moves.size(); ++i)
+            right[i] = space.moves[i].second;
+        space.moves.swap(left_moves);
+
+        for (const uint32_t term : space.touched)
+            space.left[term] = space.right[term] = 0U;
+        if (swapped == 0U)
+            break;
+    }
+
+    if (parallel_depth == 0U) {
+        bisect(documents, left, iterations, 0U, space);
+        bisect(documents, right, iterations, 0U, space);
+        return;
+    }
+    exception_ptr error;
+    {
+        const jthread worker([&]() noexcept -> void {
+            try {
+                workspace own(documents.term_count);
+                bisect(documents, right, iterations, parallel_depth - 1U,
+                    own);
+            } catch (...) {
+                error = current_exception();
+            }
+        });
+        bisect(documents, left, iterations, parallel_depth - 1U, space);
+    }
+    if (error != nullptr)
+        rethrow_exception(error);
+}
+
+// Estimated bits of the d-gaps of a term with degree documents in a range of
+// size documents: degree * log2(size / (degree + 1)).
+static double cost(const double degree, const double size) noexcept {
+    using std::log2;
+
+    return degree * log2(size / (degree + 1.0));
+}
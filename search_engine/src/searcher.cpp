@@ -0,0 +1,354 @@
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <algorithm> // copy_if, pop_heap, push_heap, set_intersection, ...
+#include <iterator> // back_inserter
+#include <memory> // make_shared, shared_ptr
+#include <utility> // move, pair
+#include <vector> // erase_if
+
+#include <search_engine/analyzer.hpp>
+#include <search_engine/bitmap.hpp>
+#include <search_engine/searcher.hpp>
+
+using std::shared_ptr, std::size_t, std::string, std::string_view,
+    std::uint64_t, std::vector;
+
+template<bool StopWords, bool Stem>
+static vector<string> analyze(string_view);
+
+searcher::searcher(
+    const index_view &view,
+    posting_cache * const postings,
+    const size_t max_expansions
+) : view_(view), analyze_(nullptr), suffix_(nullptr), cache_(postings),
+    max_expansions_(max_expansions) {
+    const bool stop_words = (view.flags() & index::stop_words) != 0U,
+        stem = (view.flags() & index::stem) != 0U;
+    if (stop_words)
+        analyze_ = stem ? analyze<true, true> : analyze<true, false>;
+    else
+        analyze_ = stem ? analyze<false, true> : analyze<false, false>;
+    suffix_ = stem ? analyze<false, true> : analyze<false, false>;
+}
+
+vector<index::doc_id> searcher::operator()(const string_view query) const {
+    return evaluate(terms(query));
+}
+
+// Deleted documents are dropped from the list the evaluation starts from,
+// so the intersections that follow only see live ones; the union of a
+// wildcard or fuzzy term drops them on the way.
+vector<index::doc_id> searcher::evaluate(
+    const vector<string> &query,
+    const tombstones * const deleted
+) const {
+    using std::back_inserter, std::copy_if, std::erase_if,
+        std::set_intersection, std::sort;
+
+    vector<index::term_id> ids;
+    vector<postings_type> unions;
+    for (const string &term : query)
+        if (term.find_first_of("*~") != string::npos) {
+            unions.push_back(expand(term, deleted));
+            if (unions.back().empty())
+                return {};
+        } else if (const auto id = view_.find(term); id.has_value())
+            ids.push_back(*id);
+        else
+            return {};
+    if (ids.empty() && unions.empty())
+        return {};
+    sort(ids.begin(), ids.end(),
+        [this](const index::term_id lhs, const index::term_id rhs) -> bool {
+            return view_.frequency(lhs) < view_.frequency(rhs);
+        }
+    );
+    sort(unions.begin(), unions.end(),
+        [](const postings_type &lhs, const postings_type &rhs) -> bool {
+            return lhs.size() < rhs.size();
+        }
+    );
+
+    // Terms stored as bitmaps are the most frequent ones. Alone they are
+    // intersected word by word; otherwise they filter what the rarer terms
+    // leave, one bit test per document.
+    vector<const uint64_t *> bitmaps;
+    while (!ids.empty())
+        if (const auto *words = view_.bitmap(ids.back()); words != nullptr) {
+            bitmaps.push_back(words);
+            ids.pop_back();
+        } else
+            break;
+    vector<index::doc_id> returns, intersection;
+    if (ids.empty() && unions.empty()) {
+        const size_t size = bitmap_words(view_.size());
+        vector<uint64_t> words(bitmaps.back(), bitmaps.back() + size);
+        bitmaps.pop_back();
+        for (const uint64_t * const other : bitmaps)
+            bitmap_and(words.data(), other, size);
+        if (deleted != nullptr)
+            bitmap_and_not(words.data(), deleted->words().data(), size);
+        bitmap_extract(words.data(), size, returns);
+        return returns;
+    }
+
+    size_t first = 0U, second = 0U;
+    auto iter = unions.begin();
+    if (const shared_ptr<const postings_type> start = ids.empty() ?
+            nullptr : intersect(ids, first, second);
+        start != nullptr && deleted != nullptr
+    ) {
+        returns.reserve(start->size());
+        copy_if(start->cbegin(), start->cend(), back_inserter(returns),
+            [deleted](const index::doc_id id) -> bool {
+                return !deleted->contains(id);
+            });
+    } else if (start != nullptr)
+        returns = *start;
+    else
+        returns.swap(*iter++);
+    for (size_t i = 0U; i < ids.size() && !returns.empty(); ++i) {
+        if (i == first || i == second)
+            continue;
+        const shared_ptr<const postings_type> current = postings(ids[i]);
+        intersection.clear();
+        set_intersection(returns.cbegin(), returns.cend(),
+            current->cbegin(), current->cend(), back_inserter(intersection));
+        returns.swap(intersection);
+    }
+    for (; iter != unions.end() && !returns.empty(); ++iter) {
+        intersection.clear();
+        set_intersection(returns.cbegin(), returns.cend(),
+            iter->cbegin(), iter->cend(), back_inserter(intersection));
+        returns.swap(intersection);
+    }
+    for (const uint64_t * const words : bitmaps)
+        erase_if(returns, [words](const index::doc_id id) -> bool {
+            return !bitmap_contains(words, id);
+        });
+    return returns;
+}
+
+// Plain words are analyzed together, wildcard patterns are normalized one by
+// one and kept as terms with their stars, and fuzzy terms are kept with '~'
+// followed by their distance.
+vector<string> searcher::terms(const string_view query) const {
+    using std::min, std::move, std::sort, std::unique;
+    static constexpr string_view spaces = " \t\n\v\f\r";
+
+    vector<string> returns;
+    string plain;
+    for (size_t first = query.find_first_not_of(spaces);
+        first != string_view::npos;
+        first = query.find_first_not_of(spaces, first)
+    ) {
+        const string_view word = query.substr(first,
+            query.find_first_of(spaces, first) - first);
+        first += word.size();
+        const size_t tilde = word.find('~');
+        if (word.find('*') != string_view::npos) {
+            if (string normalized = pattern(word); !normalized.empty())
+                returns.push_back(move(normalized));
+        } else if (tilde != string_view::npos) {
+            uint distance = default_distance;
+            if (tilde + 2U == word.size() && word.back() >= '0' &&
+                word.back() <= '9'
+            ) distance = min(static_cast<uint>(word.back() - '0'),
+                max_distance);
+            for (string &term : analyze_(word.substr(0U, tilde))) {
+                if (distance != 0U)
+                    term.append(1U, '~').push_back(
+                        static_cast<char>('0' + distance));
+                returns.push_back(move(term));
+            }
+        } else
+            plain.append(word).push_back(' ');
+    }
+    const vector<string> analyzed = analyze_(plain);
+    returns.insert(returns.cend(), analyzed.cbegin(), analyzed.cend());
+
+    sort(returns.begin(), returns.end());
+    returns.erase(unique(returns.begin(), returns.end()), returns.end());
+    return returns;
+}
+
+// Unions the postings of the terms matching a wildcard pattern or a fuzzy term
+// with a heap merge, or in a bitmap when one of them is a bitmap or they add
+// up to a dense union.
+auto searcher::expand(
+    const string_view term,
+    const tombstones * const deleted
+) const -> postings_type {
+    using std::pair, std::pop_heap, std::push_heap;
+    using cursor = pair<const index::doc_id *, const index::doc_id *>;
+
+    vector<index::term_id> ids;
+    if (const size_t tilde = term.find('~'); tilde != string_view::npos)
+        view_.fuzzy(term.substr(0U, tilde),
+            static_cast<uint>(term.back() - '0'), max_expansions_, ids);
+    else
+        view_.expand(term, max_expansions_, ids);
+
+    size_t total = 0U;
+    bool has_bitmap = false;
+    for (const index::term_id id : ids) {
+        total += view_.frequency(id);
+        has_bitmap |= view_.bitmap(id) != nullptr;
+    }
+    if (has_bitmap || total >= view_.size() / dense_union) {
+        const size_t size = bitmap_words(view_.size());
+        vector<uint64_t> words(size, 0U);
+        for (const index::term_id id : ids)
+            if (const auto *other = view_.bitmap(id); other != nullptr)
+                bitmap_or(words.data(), other, size);
+            else {
+                const shared_ptr<const postings_type> current = postings(id);
+                for (const index::doc_id doc : *current)
+                    words[doc / 64U] |= uint64_t{1} << (doc % 64U);
+            }
+        if (deleted != nullptr)
+            bitmap_and_not(words.data(), deleted->words().data(), size);
+        postings_type returns;
+        bitmap_extract(words.data(), size, returns);
+        return returns;
+    }
+
+    vector<shared_ptr<const postings_type>> lists;
+    lists.reserve(ids.size());
+    vector<cursor> heap;
+    heap.reserve(ids.size());
+    const auto greater = [](const cursor &lhs, const cursor &rhs) -> bool {
+        return *lhs.first > *rhs.first;
+    };
+    for (const index::term_id id : ids) {
+        const postings_type &current = *lists.emplace_back(postings(id));
+        if (current.empty())
+            continue;
+        heap.emplace_back(current.data(), current.data() + current.size());
+        push_heap(heap.begin(), heap.end(), greater);
+    }
+
+    postings_type returns;
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater);
+        cursor &top = heap.back();
+        if ((returns.empty() || returns.back() != *top.first) &&
+            (deleted == nullptr || !deleted->contains(*top.first))
+        ) returns.push_back(*top.first);
+        if (++top.first == top.second)
+            heap.pop_back();
+        else
+            push_heap(heap.begin(), heap.end(), greater);
+    }
+    return returns;
+}
+
+// Returns the intersection the evaluation starts from and the positions of the
+// terms it covers: the smallest cached intersection of a pair of query terms,
+// otherwise the intersection of the two rarest terms, which is then offered to
+// the cache.
+auto searcher::intersect(
+    const vector<index::term_id> &ids,
+    size_t &first,
+    size_t &second
+) const -> shared_ptr<const postings_type> {
+    using std::back_inserter, std::make_shared, std::move,
+        std::set_intersection;
+
+    first = 0U;
+    second = ids.size() == 1U ? 0U : 1U;
+    if (second == 0U)
+        return postings(ids.front());
+
+    shared_ptr<const postings_type> returns;
+    if (cache_ != nullptr) {
+        const size_t count = ids.size() <= max_pair_terms ? ids.size() : 2U;
+        for (size_t i = 0U; i + 1U < count; ++i)
+            for (size_t j = i + 1U; j < count; ++j)
+                if (auto found = cache_->pairs().find(
+                        posting_cache::key(ids[i], ids[j]));
+                    found != nullptr &&
+                    (returns == nullptr || found->size() < returns->size())
+                ) {
+                    returns = move(found);
+                    first = i;
+                    second = j;
+                }
+    }
+    if (returns != nullptr)
+        return returns;
+
+    first = 0U;
+    second = 1U;
+    const shared_ptr<const postings_type> lhs = postings(ids[0]),
+        rhs = postings(ids[1]);
+    auto intersection = make_shared<postings_type>();
+    set_intersection(lhs->cbegin(), lhs->cend(), rhs->cbegin(), rhs->cend(),
+        back_inserter(*intersection));
+    if (cache_ != nullptr)
+        cache_->pairs().insert(posting_cache::key(ids[0], ids[1]),
+            intersection, sizeof(index::doc_id) * intersection->size() +
+                sizeof(uint64_t));
+    return intersection;
+}
+
+auto searcher::postings(const index::term_id id) const
+    -> shared_ptr<const postings_type> {
+    using std::make_shared;
+
+    if (cache_ != nullptr)
+        if (auto found = cache_->lists().find(id); found != nullptr)
+            return found;
+    auto returns = make_shared<postings_type>();
+    view_.postings(id, *returns);
+    if (cache_ != nullptr)
+        cache_->lists().insert(id, returns,
+            sizeof(index::doc_id) * returns->size() + sizeof(index::term_id));
+    return returns;
+}
+
+// Normalizes the fragments between stars without stop words. The last one
+// is also stemmed when it is anchored to the end of the term, so that suffix
+// patterns agree with stemmed terms. Returns an empty string for patterns
+// without any characters.
+string searcher::pattern(const string_view word) const {
+    string returns;
+    bool is_empty = true;
+    for (size_t first = 0U; first <= word.size(); ) {
+        size_t last = word.find('*', first);
+        const bool is_suffix = last == string_view::npos && first != 0U;
+        if (last == string_view::npos)
+            last = word.size();
+        for (const string &token : (is_suffix ? suffix_ :
+                analyze<false, false>)(word.substr(first, last - first))
+        ) {
+            returns.append(token);
+            is_empty = false;
+        }
+        if (last != word.size() && (returns.empty() || returns.back() != '*'))
+            returns.push_back('*');
+        first = last + 1U;
+    }
+    if (is_empty)
+        returns.clear();
+    return returns;
+}
+
+template<bool StopWords, bool Stem>
+static vector<string> analyze(const string_view query) {
+    using std::sort, std::unique;
+
+    vector<string> returns;
+    auto push_back = [&returns](const string &term) -> void {
+        returns.push_back(term);
+    };
+    analyzer<decltype(push_back), StopWords, Stem> text_analyzer(push_back);
+    for (const char c : query)
+        text_analyzer(c);
+    text_analyzer.flush();
+
+    sort(returns.begin(), returns.end());
+    returns.erase(unique(returns.begin(), returns.end()), returns.end());
+    return returns;
+}
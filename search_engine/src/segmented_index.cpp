@@ -0,0 +1,544 @@
+#include <cassert> // assert
+#include <cerrno> // EEXIST, errno
+#include <cstdio> // rename
+
+#include <algorithm> // copy_n, max
+#include <charconv> // from_chars
+#include <fstream> // ifstream
+#include <limits> // numeric_limits
+#include <optional> // optional
+#include <stdexcept> // length_error, logic_error, out_of_range
+#include <system_error> // generic_category, system_error
+#include <utility> // move
+
+#include <fcntl.h> // O_DIRECTORY, O_RDONLY, open
+#include <sys/stat.h> // mkdir
+#include <unistd.h> // close, fsync, unlink
+
+#include <search_engine/index_view.hpp>
+#include <search_engine/indexer.hpp>
+#include <search_engine/memmap.hpp>
+#include <search_engine/searcher.hpp>
+#include <search_engine/segmented_index.hpp>
+#include <search_engine/writable_memmap.hpp>
+
+using std::generic_category, std::lock_guard, std::logic_error,
+    std::make_shared, std::move, std::mutex, std::numeric_limits,
+    std::shared_ptr, std::size_t, std::string, std::string_view,
+    std::system_error, std::uint32_t, std::uint64_t, std::unique_lock,
+    std::unordered_set, std::vector;
+
+// A mapped segment file and the searcher over it.
+struct segmented_index::segment final {
+    segment(const string &, const string &);
+
+    string name;
+    memmap map;
+    index_view view;
+    searcher search;
+};
+
+static constexpr string_view manifest_name = "manifest",
+    segment_prefix = "segment", segment_suffix = ".idx",
+    tombstones_prefix = "tombstones", tombstones_suffix = ".del";
+
+static uint64_t file_number(string_view, string_view, string_view);
+static void sync_directory(const string &);
+static void write_file(const string &, const string &, const char *,
+    size_t);
+
+segmented_index::segment::segment(
+    const string &directory,
+    const string &file_name
+) : name(file_name), map((directory + '/' + file_name).c_str()),
+    view(static_cast<string_view>(map)), search(view) {}
+
+segmented_index::segmented_index(
+    const char * const directory,
+    const uint32_t flags
+) : directory_(directory), segments_(make_shared<const snapshot>()),
+    flags_(flags) {
+    using std::getline, std::ifstream, std::max, std::thread;
+
+    if (mkdir(directory, 0777) == -1 && errno != EEXIST) [[unlikely]]
+        throw system_error(errno, generic_category(),
+            "segmented_index::segmented_index");
+
+    // Every line holds the name of a segment and, if any of its documents
+    // are deleted, a space and the name of its tombstones.
+    snapshot loaded;
+    ifstream manifest(directory_ + '/' + string(manifest_name));
+    for (string line; getline(manifest, line); ) {
+        if (line.empty())
+            continue;
+        const size_t space = line.find(' ');
+        string name = line.substr(0U, space), deleted_name =
+            space == string::npos ? string() : line.substr(space + 1U);
+        next_name_ = max(next_name_,
+            file_number(name, segment_prefix, segment_suffix) + 1U);
+        if (!deleted_name.empty())
+            next_name_ = max(next_name_, file_number(deleted_name,
+                tombstones_prefix, tombstones_suffix) + 1U);
+        auto file = make_shared<const segment>(directory_, name);
+        if (file->view.flags() != flags_) [[unlikely]] throw logic_error(
+            "segmented_index::segmented_index: flags do not match");
+        auto deleted = load(deleted_name, file->view.size());
+        loaded.push_back({move(file), move(deleted), move(deleted_name)});
+    }
+    segments_ = make_shared<const snapshot>(move(loaded));
+    thread_ = thread(&segmented_index::merge, this);
+}
+
+segmented_index::~segmented_index() noexcept {
+    {
+        const lock_guard<mutex> lock(mutex_);
+        state_ = state::stopped;
+    }
+    changed_.notify_all();
+    thread_.join();
+}
+
+void segmented_index::append(const index &built) {
+    using std::length_error;
+
+    if (built.flags() != flags_) [[unlikely]]
+        throw logic_error("segmented_index::append: flags do not match");
+    if (built.size() == 0U)
+        return;
+
+    string name;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        name = next_name(segment_prefix, segment_suffix);
+    }
+    built.write((directory_ + '/' + name).c_str());
+    auto added = make_shared<const segment>(directory_, name);
+
+    unordered_set<string_view> titles;
+    titles.reserve(built.size());
+    for (doc_id id = 0U; id < built.size(); ++id)
+        titles.insert(built.title(id));
+    vector<string> replaced;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        snapshot after(*segments_);
+        size_t documents = built.size();
+        for (const part &current_part : after)
+            documents += current_part.file->view.size();
+        if (documents > numeric_limits<doc_id>::max()) [[unlikely]]
+            throw length_error("segmented_index::append: too many documents");
+        bury(after, titles, replaced);
+        after.push_back({move(added), nullptr, string()});
+        publish(after);
+        unlink(replaced);
+    }
+    changed_.notify_all();
+}
+
+void segmented_index::append(const vector<string> &texts_files) {
+    switch (flags_) {
+        case 0U:
+            append(make_index<false, false>(texts_files));
+            break;
+        case index::stop_words:
+            append(make_index<true, false>(texts_files));
+            break;
+        case index::stem:
+            append(make_index<false, true>(texts_files));
+            break;
+        case index::stop_words | index::stem:
+            append(make_index<true, true>(texts_files));
+            break;
+        default:
+            throw logic_error("segmented_index::append: invalid flags");
+    }
+}
+
+vector<index::doc_id> segmented_index::operator()(
+    const string_view query
+) const {
+    vector<string> titles;
+    return (*this)(query, 0U, titles);
+}
+
+// The query is analyzed once, all segments share the analyzer flags, and
+// evaluated segment by segment; the results stay sorted because the
+// segments are in document order.
+vector<index::doc_id> segmented_index::operator()(
+    const string_view query,
+    const size_t limit,
+    vector<string> &titles
+) const {
+    const shared_ptr<const snapshot> parts = current();
+    vector<doc_id> returns;
+    titles.clear();
+    if (parts->empty())
+        return returns;
+
+    const vector<string> terms = parts->front().file->search.terms(query);
+    doc_id base = 0U;
+    for (const auto &[file, deleted, deleted_name] : *parts) {
+        for (const doc_id id : file->search.evaluate(terms, deleted.get())) {
+            returns.push_back(base + id);
+            if (titles.size() < limit)
+                titles.emplace_back(file->view.title(id));
+        }
+        base += static_cast<doc_id>(file->view.size());
+    }
+    return returns;
+}
+
+// Merges wait for the lock, which keeps the snapshot current throughout.
+size_t segmented_index::remove(const vector<string> &titles) {
+    const unordered_set<string_view> wanted(titles.cbegin(), titles.cend());
+    size_t returns = 0U;
+    vector<string> replaced;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        snapshot after(*segments_);
+        returns = bury(after, wanted, replaced);
+        if (returns != 0U) {
+            publish(after);
+            unlink(replaced);
+        }
+    }
+    // Segments with fewer live documents may now fall into a lower tier.
+    changed_.notify_all();
+    return returns;
+}
+
+size_t segmented_index::segments() const {
+    return current()->size();
+}
+
+size_t segmented_index::size() const {
+    size_t returns = 0U;
+    for (const part &current_part : *current())
+        returns += live(current_part);
+    return returns;
+}
+
+string segmented_index::title(doc_id id) const {
+    using std::out_of_range;
+
+    for (const auto &[file, deleted, deleted_name] : *current()) {
+        if (id < file->view.size())
+            return string(file->view.title(id));
+        id -= static_cast<doc_id>(file->view.size());
+    }
+    throw out_of_range("segmented_index::title: document is out of range");
+}
+
+void segmented_index::wait() {
+    using std::rethrow_exception;
+
+    unique_lock<mutex> lock(mutex_);
+    size_t first;
+    changed_.wait(lock, [this, &first]() noexcept -> bool {
+        return error_ != nullptr ||
+            (state_ != state::merging && !find_run(*segments_, first));
+    });
+    if (error_ != nullptr) [[unlikely]]
+        rethrow_exception(error_);
+}
+
+// Looks for merge_factor adjacent segments whose live documents put them in
+// the same tier, oldest first.
+bool segmented_index::find_run(
+    const snapshot &parts,
+    size_t &first
+) noexcept {
+    for (size_t i = 0U, run = 0U; i < parts.size(); ++i) {
+        run = i != 0U && tier(live(parts[i])) == tier(live(parts[i - 1U])) ?
+            run + 1U : 1U;
+        if (run == merge_factor) {
+            first = i + 1U - merge_factor;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t segmented_index::live(const part &current_part) noexcept {
+    return current_part.file->view.size() -
+        (current_part.deleted == nullptr ? 0U : current_part.deleted->count());
+}
+
+size_t segmented_index::tier(size_t documents) noexcept {
+    size_t returns = 0U;
+    for (; documents >= merge_factor; documents /= merge_factor)
+        ++returns;
+    return returns;
+}
+
+// Marks the live documents with any of the titles as deleted, writing the
+// tombstones of the segments that change to new files, and returns their
+// number. The files they replace are added to the list, to be unlinked once
+// the manifest no longer lists them. Must be called with the mutex held.
+size_t segmented_index::bury(
+    snapshot &parts,
+    const unordered_set<string_view> &titles,
+    vector<string> &replaced
+) {
+    using std::optional;
+
+    size_t returns = 0U;
+    if (titles.empty())
+        return returns;
+    for (auto &[file, deleted, deleted_name] : parts) {
+        optional<tombstones> updated;
+        for (doc_id id = 0U; id < file->view.size(); ++id) {
+            if ((deleted != nullptr && deleted->contains(id)) ||
+                !titles.contains(file->view.title(id))
+            ) continue;
+            if (!updated.has_value())
+                updated.emplace(deleted != nullptr ? *deleted :
+                    tombstones(file->view.size()));
+            updated->insert(id);
+            ++returns;
+        }
+        if (updated.has_value()) {
+            if (!deleted_name.empty())
+                replaced.push_back(move(deleted_name));
+            deleted_name = write(*updated);
+            deleted = make_shared<const tombstones>(move(*updated));
+        }
+    }
+    return returns;
+}
+
+auto segmented_index::current() const -> shared_ptr<const snapshot> {
+    const lock_guard<mutex> lock(snapshot_mutex_);
+    return segments_;
+}
+
+// Returns null for a segment without tombstones, which have no name.
+shared_ptr<const tombstones> segmented_index::load(
+    const string &name,
+    const size_t documents
+) const {
+    if (name.empty())
+        return nullptr;
+    const memmap map((directory_ + '/' + name).c_str());
+    const string_view data(map);
+    vector<uint64_t> words(data.size() / sizeof(uint64_t));
+    if (words.size() * sizeof(uint64_t) != data.size()) [[unlikely]]
+        throw logic_error("segmented_index::load: invalid tombstones");
+    std::copy_n(data.data(), data.size(),
+        reinterpret_cast<char *>(words.data()));
+    return make_shared<const tombstones>(documents, move(words));
+}
+
+// Merge thread: rebuilds a run in memory from the live documents of its
+// segments, titles first and then the postings of every segment mapped to
+// the new ids, and swaps the new segment in. Appends only add segments at
+// the end, so the run is still in place when the merge is published;
+// documents deleted in the meantime are carried over to the tombstones of
+// the new segment. The replaced files are unlinked and stay mapped for as
+// long as older snapshots use them.
+void segmented_index::merge() noexcept {
+    using std::current_exception, std::optional, std::ptrdiff_t;
+    static constexpr doc_id dead = numeric_limits<doc_id>::max();
+
+    unique_lock<mutex> lock(mutex_);
+    for (size_t first = 0U; ; ) {
+        changed_.wait(lock, [this, &first]() noexcept -> bool {
+            return state_ == state::stopped ||
+                (error_ == nullptr && find_run(*segments_, first));
+        });
+        if (state_ == state::stopped)
+            return;
+
+        const shared_ptr<const snapshot> before = segments_;
+        state_ = state::merging;
+        try {
+            const string name = next_name(segment_prefix, segment_suffix);
+            lock.unlock();
+
+            index merged(flags_);
+            vector<vector<doc_id>> renumbered(merge_factor);
+            size_t terms = 0U;
+            for (size_t i = 0U; i < merge_factor; ++i)
+                terms += (*before)[first + i].file->view.terms();
+            merged.reserve(terms);
+            for (size_t i = 0U; i < merge_factor; ++i) {
+                const auto &[file, deleted, deleted_name] =
+                    (*before)[first + i];
+                renumbered[i].assign(file->view.size(), dead);
+                for (doc_id id = 0U; id < file->view.size(); ++id)
+                    if (deleted == nullptr || !deleted->contains(id))
+                        renumbered[i][id] =
+                            merged.insert_document(file->view.title(id));
+            }
+            vector<doc_id> ids, mapped;
+            for (size_t i = 0U; i < merge_factor; ++i) {
+                const index_view &view = (*before)[first + i].file->view;
+                for (auto iter = view.dictionary().begin();
+                    iter != view.dictionary().end();
+                    ++iter
+                ) {
+                    view.postings(iter.id(), ids);
+                    mapped.clear();
+                    for (const doc_id id : ids)
+                        if (renumbered[i][id] != dead)
+                            mapped.push_back(renumbered[i][id]);
+                    merged.insert_postings(*iter, mapped, 0U);
+                }
+            }
+            const size_t documents = merged.size();
+            shared_ptr<const segment> added;
+            if (documents != 0U) {
+                merged.write((directory_ + '/' + name).c_str());
+                merged = index();
+                added = make_shared<const segment>(directory_, name);
+            }
+
+            lock.lock();
+            snapshot after(*segments_);
+            optional<tombstones> carried;
+            for (size_t i = 0U; i < merge_factor; ++i) {
+                const shared_ptr<const tombstones> &then =
+                    (*before)[first + i].deleted,
+                    &now = after[first + i].deleted;
+                if (now == then)
+                    continue;
+                for (doc_id id = 0U; id < now->size(); ++id)
+                    if (now->contains(id) &&
+                        (then == nullptr || !then->contains(id))
+                    ) {
+                        if (!carried.has_value())
+                            carried.emplace(documents);
+                        carried->insert(renumbered[i][id]);
+                    }
+            }
+            vector<string> replaced;
+            for (size_t i = 0U; i < merge_factor; ++i) {
+                replaced.push_back(after[first + i].file->name);
+                if (!after[first + i].deleted_name.empty())
+                    replaced.push_back(after[first + i].deleted_name);
+            }
+            const auto run = after.begin() + static_cast<ptrdiff_t>(first),
+                run_end = run + static_cast<ptrdiff_t>(merge_factor);
+            if (added == nullptr)
+                after.erase(run, run_end);
+            else {
+                after.erase(run + 1, run_end);
+                after[first] = {move(added), nullptr, string()};
+                if (carried.has_value()) {
+                    after[first].deleted_name = write(*carried);
+                    after[first].deleted =
+                        make_shared<const tombstones>(move(*carried));
+                }
+            }
+            publish(after);
+            unlink(replaced);
+        } catch (...) {
+            if (!lock.owns_lock())
+                lock.lock();
+            error_ = current_exception();
+        }
+        if (state_ == state::merging)
+            state_ = state::idle;
+        changed_.notify_all();
+    }
+}
+
+// Segments and tombstones are numbered together, so that no name is ever
+// reused. Must be called with the mutex held.
+string segmented_index::next_name(
+    const string_view prefix,
+    const string_view suffix
+) {
+    string returns(prefix);
+    returns.append(std::to_string(next_name_++)).append(suffix);
+    return returns;
+}
+
+// Writes the manifest, so that a crash leaves either the old or the new
+// list, then makes the list visible to queries. Must be called with the
+// mutex held.
+void segmented_index::publish(const snapshot &parts) {
+    string manifest;
+    for (const part &current_part : parts) {
+        manifest.append(current_part.file->name);
+        if (!current_part.deleted_name.empty())
+            manifest.append(1U, ' ').append(current_part.deleted_name);
+        manifest.push_back('\n');
+    }
+    write_file(directory_, string(manifest_name), manifest.data(),
+        manifest.size());
+
+    auto published = make_shared<const snapshot>(parts);
+    const lock_guard<mutex> lock(snapshot_mutex_);
+    segments_.swap(published);
+}
+
+// Removes files that the manifest no longer lists. Files left behind by a
+// failure are not listed in the manifest either and do no harm.
+void segmented_index::unlink(const vector<string> &names) const noexcept {
+    for (const string &name : names)
+        ::unlink((directory_ + '/' + name).c_str());
+}
+
+// Writes tombstones to a new file and returns its name. Must be called with
+// the mutex held.
+string segmented_index::write(const tombstones &deleted) {
+    string returns = next_name(tombstones_prefix, tombstones_suffix);
+    write_file(directory_, returns,
+        reinterpret_cast<const char *>(deleted.words().data()),
+        deleted.words().size() * sizeof(uint64_t));
+    return returns;
+}
+
+// The number in the name of a segment or tombstones file.
+static uint64_t file_number(
+    const string_view name,
+    const string_view prefix,
+    const string_view suffix
+) {
+    using std::errc, std::from_chars;
+
+    uint64_t returns = 0U;
+    if (name.size() <= prefix.size() + suffix.size() ||
+        !name.starts_with(prefix) || !name.ends_with(suffix)
+    ) [[unlikely]] throw logic_error("file_number: invalid file name");
+    const char * const first = name.data() + prefix.size(),
+        * const last = name.data() + name.size() - suffix.size();
+    if (const auto [ptr, errnum] = from_chars(first, last, returns);
+        ptr != last || errnum != errc()
+    ) [[unlikely]] throw logic_error("file_number: invalid file name");
+    return returns;
+}
+
+static void sync_directory(const string &directory) {
+    const int fildes = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fildes == -1 || fsync(fildes) == -1) [[unlikely]] {
+        const int errnum = errno;
+        if (fildes != -1)
+            close(fildes);
+        throw system_error(errnum, generic_category(), "sync_directory");
+    }
+    close(fildes);
+}
+
+// Replaces a file atomically: writes the data next to it and renames it
+// over, so that a crash leaves either version.
+static void write_file(
+    const string &directory,
+    const string &name,
+    const char * const data,
+    const size_t size
+) {
+    using std::copy_n, std::rename;
+
+    const string path = directory + '/' + name, temporary = path + ".tmp";
+    {
+        writable_memmap file(temporary.c_str(), size);
+        copy_n(data, size, file.data());
+        file.sync();
+        file.close();
+    }
+    if (rename(temporary.c_str(), path.c_str()) == -1) [[unlikely]]
+        throw system_error(errno, generic_category(), "write_file");
+    sync_directory(directory);
+}
@@ -0,0 +1,353 @@
+#include <cassert> // assert
+#include <cerrno> // EAGAIN, ECONNABORTED, EINTR, EMFILE, ENFILE, errno, ...
+#include <cstring> // memcpy
+
+#include <array> // array
+#include <exception> // current_exception, exception
+#include <stdexcept> // length_error, logic_error
+#include <system_error> // generic_category, system_error
+#include <utility> // move
+#include <vector> // vector
+
+#include <sys/epoll.h> // EPOLL*, epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h> // EFD_CLOEXEC, EFD_NONBLOCK, eventfd
+#include <sys/socket.h> // AF_UNIX, MSG_NOSIGNAL, SOCK_*, accept4, bind, ...
+#include <sys/stat.h> // S_ISSOCK, stat
+#include <sys/types.h> // ssize_t
+#include <sys/un.h> // sockaddr_un
+#include <unistd.h> // close, read, unlink, write
+
+#include <search_engine/server.hpp>
+
+using std::current_exception, std::exception, std::generic_category,
+    std::lock_guard, std::logic_error, std::move, std::mutex, std::size_t,
+    std::string, std::system_error, std::uint32_t, std::uint64_t,
+    std::unique_lock, std::vector;
+
+server::server(
+    const char * const path,
+    const handler &invocable,
+    const size_t concurrency
+) : handler_(invocable), path_(path), concurrency_(concurrency) {
+    using std::length_error, std::memcpy;
+    static constexpr const char *what = "server::server";
+
+    if (!handler_) [[unlikely]]
+        throw logic_error("server::server: handler must not be empty");
+    else if (concurrency_ == 0U) [[unlikely]]
+        throw logic_error("server::server: concurrency must be positive");
+    sockaddr_un address{};
+    if (path_.empty() || path_.size() >= sizeof(address.sun_path)) [[unlikely]]
+        throw length_error("server::server: invalid socket path");
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path_.c_str(), path_.size() + 1U);
+
+    try {
+        if (epoll_ = epoll_create1(EPOLL_CLOEXEC); epoll_ == -1) [[unlikely]]
+            throw system_error(errno, generic_category(), what);
+        if (event_ = eventfd(0U, EFD_CLOEXEC | EFD_NONBLOCK); event_ == -1)
+            [[unlikely]] throw system_error(errno, generic_category(), what);
+        listener_ =
+            socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener_ == -1) [[unlikely]]
+            throw system_error(errno, generic_category(), what);
+
+        if (struct stat buf; ::stat(path_.c_str(), &buf) == 0 &&
+            S_ISSOCK(buf.st_mode)
+        ) ::unlink(path_.c_str());
+        if (bind(listener_, reinterpret_cast<const sockaddr *>(&address),
+                sizeof(address)) == -1 || listen(listener_, SOMAXCONN) == -1
+        ) [[unlikely]] throw system_error(errno, generic_category(), what);
+
+        epoll_event listener{EPOLLIN, {.u64 = listener_id}},
+            event{EPOLLIN, {.u64 = event_id}};
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, listener_, &listener) == -1 ||
+            epoll_ctl(epoll_, EPOLL_CTL_ADD, event_, &event) == -1
+        ) [[unlikely]] throw system_error(errno, generic_category(), what);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+server::~server() noexcept {
+    shutdown();
+    release();
+}
+
+void server::run() {
+    using std::array;
+
+    if (!workers_.empty()) [[unlikely]]
+        throw logic_error("server::run: server is already running");
+
+    try {
+        for (size_t i = 0U; i < concurrency_; ++i)
+            workers_.emplace_back(&server::work, this);
+
+        array<epoll_event, 64U> events;
+        while (!stopping_.load()) {
+            const int count =
+                epoll_wait(epoll_, events.data(), events.size(), -1);
+            if (count == -1) [[unlikely]] {
+                if (errno == EINTR)
+                    continue;
+                throw system_error(errno, generic_category(), "server::run");
+            }
+
+            for (int i = 0; i < count; ++i) {
+                const uint64_t id = events[i].data.u64;
+                const uint32_t flags = events[i].events;
+                if (id == listener_id)
+                    accept();
+                else if (id == event_id)
+                    complete();
+                else if ((flags & (EPOLLERR | EPOLLHUP)) != 0U)
+                    close(id);
+                else {
+                    if ((flags & (EPOLLIN | EPOLLRDHUP)) != 0U)
+                        receive(id);
+                    if (const auto iter = connections_.find(id);
+                        (flags & EPOLLOUT) != 0U &&
+                        iter != connections_.end() && flush(id, iter->second)
+                    ) dispatch(id, iter->second);
+                }
+            }
+        }
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+    shutdown();
+}
+
+void server::stop() noexcept {
+    static constexpr uint64_t value = 1U;
+
+    stopping_.store(1);
+    [[maybe_unused]] const ssize_t size =
+        ::write(event_, &value, sizeof(value));
+}
+
+void server::accept() {
+    static constexpr const char *what = "server::accept";
+
+    while (true) {
+        const int fildes =
+            accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fildes == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            else if (errno == EAGAIN || errno == EWOULDBLOCK ||
+                errno == EMFILE || errno == ENFILE ||
+                errno == ENOBUFS || errno == ENOMEM
+            ) return;
+            throw system_error(errno, generic_category(), what);
+        }
+
+        const uint64_t id = next_id_++;
+        epoll_event event{EPOLLIN | EPOLLRDHUP, {.u64 = id}};
+        if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fildes, &event) == -1)
+            [[unlikely]] {
+            const int errnum = errno;
+            ::close(fildes);
+            throw system_error(errnum, generic_category(), what);
+        }
+        connection &current = connections_[id];
+        current.fildes = fildes;
+    }
+}
+
+void server::close(const uint64_t id) noexcept {
+    const auto iter = connections_.find(id);
+    if (iter == connections_.end())
+        return;
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, iter->second.fildes, nullptr);
+    ::close(iter->second.fildes);
+    connections_.erase(iter);
+}
+
+void server::complete() {
+    uint64_t value;
+    [[maybe_unused]] const ssize_t size = ::read(event_, &value, sizeof(value));
+
+    vector<task> results;
+    {
+        const lock_guard<mutex> lock(results_mutex_);
+        results.swap(results_);
+    }
+    for (task &result : results) {
+        const auto iter = connections_.find(result.id);
+        if (iter == connections_.end())
+            continue;
+        connection &current = iter->second;
+        assert(current.busy);
+        current.busy = false;
+        if (result.error) [[unlikely]] {
+            close(result.id);
+            continue;
+        }
+        current.output.append(result.text);
+        if (flush(result.id, current))
+            dispatch(result.id, current);
+    }
+}
+
+void server::dispatch(const uint64_t id, connection &current) {
+    if (current.busy || !current.output.empty())
+        return;
+
+    const size_t end = current.input.find('\n');
+    if (end == string::npos) {
+        if (current.closing)
+            close(id);
+        return;
+    }
+
+    task next{id, current.input.substr(0U, end), nullptr};
+    if (!next.text.empty() && next.text.back() == '\r')
+        next.text.pop_back();
+    current.input.erase(0U, end + 1U);
+    current.busy = true;
+    {
+        const lock_guard<mutex> lock(tasks_mutex_);
+        tasks_.push_back(move(next));
+    }
+    tasks_ready_.notify_one();
+}
+
+bool server::flush(const uint64_t id, connection &current) {
+    size_t offset = 0U;
+    while (offset < current.output.size()) {
+        const ssize_t size = send(current.fildes,
+            current.output.data() + offset, current.output.size() - offset,
+            MSG_NOSIGNAL);
+        if (size >= 0)
+            offset += static_cast<size_t>(size);
+        else if (errno == EINTR)
+            continue;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        else {
+            close(id);
+            return false;
+        }
+    }
+    current.output.erase(0U, offset);
+    return update(id, current);
+}
+
+void server::receive(const uint64_t id) {
+    using std::array;
+
+    const auto iter = connections_.find(id);
+    if (iter == connections_.end()) [[unlikely]]
+        return;
+    connection &current = iter->second;
+
+    array<char, 1U << 14U> buffer;
+    while (!current.closing) {
+        const ssize_t size =
+            recv(current.fildes, buffer.data(), buffer.size(), 0);
+        if (size > 0) {
+            current.input.append(buffer.data(), static_cast<size_t>(size));
+            if (current.input.size() > max_request_size) [[unlikely]] {
+                close(id);
+                return;
+            }
+        } else if (size == 0)
+            current.closing = true;
+        else if (errno == EINTR)
+            continue;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        else {
+            close(id);
+            return;
+        }
+    }
+    if (update(id, current))
+        dispatch(id, current);
+}
+
+void server::release() noexcept {
+    for (const auto &[id, current] : connections_)
+        ::close(current.fildes);
+    connections_.clear();
+    if (listener_ != -1) {
+        ::close(listener_);
+        ::unlink(path_.c_str());
+        listener_ = -1;
+    }
+    if (event_ != -1) {
+        ::close(event_);
+        event_ = -1;
+    }
+    if (epoll_ != -1) {
+        ::close(epoll_);
+        epoll_ = -1;
+    }
+}
+
+void server::shutdown() noexcept {
+    {
+        const lock_guard<mutex> lock(tasks_mutex_);
+        stopping_.store(1);
+    }
+    tasks_ready_.notify_all();
+    for (std::thread &worker : workers_)
+        worker.join();
+    workers_.clear();
+    tasks_.clear();
+    results_.clear();
+}
+
+bool server::update(const uint64_t id, connection &current) {
+    const bool reading = !current.closing, writing = !current.output.empty();
+    if (reading == current.reading && writing == current.writing)
+        return true;
+
+    epoll_event event{
+        (reading ? EPOLLIN | EPOLLRDHUP : 0U) | (writing ? EPOLLOUT : 0U),
+        {.u64 = id}
+    };
+    if (epoll_ctl(epoll_, EPOLL_CTL_MOD, current.fildes, &event) == -1)
+        [[unlikely]] {
+        close(id);
+        return false;
+    }
+    current.reading = reading;
+    current.writing = writing;
+    return true;
+}
+
+void server::work() {
+    while (true) {
+        task current;
+        {
+            unique_lock<mutex> lock(tasks_mutex_);
+            tasks_ready_.wait(lock, [this]() -> bool {
+                return stopping_.load() || !tasks_.empty();
+            });
+            if (stopping_.load())
+                return;
+            current = move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        string response;
+        try {
+            handler_(current.text, response);
+        } catch (const exception &) {
+            current.error = current_exception();
+        }
+        current.text = move(response);
+        {
+            const lock_guard<mutex> lock(results_mutex_);
+            results_.push_back(move(current));
+        }
+        static constexpr uint64_t value = 1U;
+        [[maybe_unused]] const ssize_t size =
+            ::write(event_, &value, sizeof(value));
+    }
+}
@@ -0,0 +1,264 @@
+#include <algorithm> // min, sort
+#include <atomic> // atomic
+#include <exception> // current_exception, exception_ptr, rethrow_exception
+#include <mutex> // lock_guard, mutex
+#include <thread> // jthread
+#include <type_traits> // conditional_t
+
+#include <search_engine/char_encoder.hpp>
+#include <search_engine/normalizer.hpp>
+#include <search_engine/snippets.hpp>
+#include <search_engine/stemmer.hpp>
+#include <search_engine/str_encoder.hpp>
+#include <search_engine/tokenizer.hpp>
+#include <search_engine/types.hpp>
+
+using std::min, std::size_t, std::string, std::string_view, std::vector;
+
+static bool matches(string_view, string_view) noexcept;
+
+snippet_generator::snippet_generator(
+    const std::uint32_t flags,
+    const size_t window,
+    const size_t snippets,
+    const size_t max_scan
+) : tokenize_(nullptr), window_(window == 0U ? 1U : window),
+    snippets_(snippets), max_scan_(max_scan) {
+    const bool stop_words = (flags & index::stop_words) != 0U,
+        stem = (flags & index::stem) != 0U;
+    if (stop_words)
+        tokenize_ = stem ? tokenize<true, true> : tokenize<true, false>;
+    else
+        tokenize_ = stem ? tokenize<false, true> : tokenize<false, false>;
+}
+
+void snippet_generator::operator()(
+    const string_view text,
+    const vector<string> &terms,
+    string &snippet
+) const {
+    using std::sort;
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    // Cuts the text at a character boundary.
+    size_t size = min(text.size(), max_scan_);
+    while (size < text.size() && size > 0U &&
+        (static_cast<uchar>(text[size]) & 0xC0U) == 0x80U
+    ) --size;
+    vector<token> tokens;
+    tokenize_(text.substr(0U, size), tokens);
+    if (tokens.empty() || snippets_ == 0U)
+        return;
+
+    // The query term matched by every token.
+    vector<size_t> matched(tokens.size(), none);
+    for (size_t i = 0U; i < tokens.size(); ++i)
+        for (size_t j = 0U; j < terms.size() && !tokens[i].term.empty(); ++j)
+            if (matches(terms[j], tokens[i].term)) {
+                matched[i] = j;
+                break;
+            }
+
+    const size_t width = min(window_, tokens.size()),
+        starts = tokens.size() - width + 1U;
+    vector<size_t> scores(starts), counts(terms.size(), 0U);
+    size_t distinct = 0U, hits = 0U;
+    const auto add = [&](const size_t i, const bool is_added) -> void {
+        if (matched[i] == none)
+            return;
+        size_t &count = counts[matched[i]];
+        if (is_added) {
+            distinct += count++ == 0U ? 1U : 0U;
+            ++hits;
+        } else {
+            distinct -= --count == 0U ? 1U : 0U;
+            --hits;
+        }
+    };
+    for (size_t i = 0U; i < width; ++i)
+        add(i, true);
+    for (size_t first = 0U; first < starts; ++first) {
+        scores[first] = distinct * (width + 1U) + hits;
+        if (first + 1U < starts) {
+            add(first, false);
+            add(first + width, true);
+        }
+    }
+
+    // Ties go to the window with its matches nearest to the middle, then to
+    // the earliest: the imbalance is the difference between the numbers of
+    // tokens before the first match and after the last one.
+    vector<size_t> before(tokens.size() + 1U, none), after(tokens.size(), none);
+    for (size_t i = tokens.size(); i-- > 0U; )
+        before[i] = matched[i] != none ? i : before[i + 1U];
+    for (size_t i = 0U; i < tokens.size(); ++i)
+        after[i] = matched[i] != none ? i : i == 0U ? none : after[i - 1U];
+    const auto imbalance = [&](const size_t first) -> size_t {
+        const size_t last = first + width - 1U;
+        if (before[first] > last)
+            return 0U;
+        const size_t lead = before[first] - first, trail = last - after[last];
+        return lead > trail ? lead - trail : trail - lead;
+    };
+
+    // The best window, then the best ones that do not overlap it and still
+    // match something.
+    vector<size_t> chosen;
+    while (chosen.size() < snippets_) {
+        size_t best = none;
+        for (size_t first = 0U; first < starts; ++first) {
+            bool is_free = true;
+            for (const size_t other : chosen)
+                is_free &= first + width <= other || other + width <= first;
+            if (is_free && (best == none || scores[first] > scores[best] ||
+                (scores[first] == scores[best] &&
+                    imbalance(first) < imbalance(best)))
+            ) best = first;
+        }
+        if (best == none || (!chosen.empty() && scores[best] == 0U))
+            break;
+        chosen.push_back(best);
+    }
+    sort(chosen.begin(), chosen.end());
+
+    const auto append = [&snippet, &text](const size_t first,
+        const size_t last
+    ) -> void {
+        for (size_t i = first; i < last; ++i)
+            snippet.push_back(text[i] == '\n' || text[i] == '\r' ||
+                text[i] == '\t' ? ' ' : text[i]);
+    };
+    for (const size_t first : chosen) {
+        if (first != chosen.front())
+            snippet.append(" ... ");
+        size_t at = tokens[first].first;
+        for (size_t i = first; i < first + width; ++i) {
+            append(at, tokens[i].first);
+            if (matched[i] != none)
+                snippet.push_back('[');
+            append(tokens[i].first, tokens[i].last);
+            if (matched[i] != none)
+                snippet.push_back(']');
+            at = tokens[i].last;
+        }
+    }
+}
+
+vector<string> snippet_generator::operator()(
+    const doc_store &store,
+    const vector<index::doc_id> &ids,
+    const size_t limit,
+    const vector<string> &terms,
+    size_t threads
+) const {
+    using std::atomic, std::current_exception, std::exception_ptr,
+        std::jthread, std::lock_guard, std::mutex, std::rethrow_exception;
+
+    const size_t count = min(ids.size(), limit);
+    vector<stored_document> documents;
+    documents.reserve(count);
+    size_t bytes = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        documents.push_back(store.get(ids[i]));
+        bytes += min(documents.back().text.size(), max_scan_);
+    }
+
+    vector<string> returns(count);
+    threads = min(threads, count);
+    if (threads <= 1U || bytes < parallel_bytes) {
+        for (size_t i = 0U; i < count; ++i)
+            (*this)(documents[i].text, terms, returns[i]);
+        return returns;
+    }
+
+    atomic<size_t> next = 0U;
+    exception_ptr error;
+    mutex error_mutex;
+    const auto work = [&]() noexcept -> void {
+        try {
+            for (size_t i; i = next++, i < count; )
+                (*this)(documents[i].text, terms, returns[i]);
+        } catch (...) {
+            const lock_guard lock(error_mutex);
+            if (error == nullptr)
+                error = current_exception();
+        }
+    };
+    {
+        vector<jthread> workers;
+        workers.reserve(threads - 1U);
+        for (size_t i = 1U; i < threads; ++i)
+            workers.emplace_back(work);
+        work();
+    }
+    if (error != nullptr)
+        rethrow_exception(error);
+    return returns;
+}
+
+// The analyzer chain, with the tokenizer reporting where every token ends:
+// it calls back on the character after the token, whose first byte is at
+// start, unless it dropped a trailing separator before that character.
+template<bool StopWords, bool Stem>
+void snippet_generator::tokenize(
+    const string_view text,
+    vector<token> &tokens
+) {
+    using std::conditional_t, std::wstring;
+
+    string term;
+    auto set_term = [&term](const string &encoded) -> void {
+        term = encoded;
+    };
+    using encoder = str_encoder<wchar_t, char, decltype(set_term)>;
+    conditional_t<Stem, stemmer<encoder>, encoder> next{encoder(set_term)};
+    auto stage = [&next](size_t, wstring &wcs) -> void { next(wcs); };
+    normalizer<decltype(stage), StopWords> normalize(stage);
+
+    size_t start = 0U;
+    auto record = [&](wstring &wcs) -> void {
+        size_t last = start, bytes = 0U;
+        if (last > 0U && (text[last - 1U] == '\'' ||
+                text[last - 1U] == ',' || text[last - 1U] == '.')
+        ) --last;
+        for (const wchar_t wc : wcs)
+            bytes += wc < 0x80 ? 1U : wc < 0x800 ? 2U : wc < 0x10000 ? 3U : 4U;
+        term.clear();
+        normalize(wcs);
+        tokens.push_back({last - bytes, last, term});
+    };
+    char_encoder<char, wchar_t, tokenizer<decltype(record)>> chain{
+        tokenizer(record)};
+    for (size_t i = 0U; i < text.size(); ++i) {
+        if ((static_cast<uchar>(text[i]) & 0xC0U) != 0x80U)
+            start = i;
+        chain(text[i]);
+    }
+    start = text.size();
+    chain.invocable().flush_buffer();
+}
+
+// Wildcard patterns match like in the index and fuzzy terms only match
+// their own spelling.
+static bool matches(const string_view term, const string_view token)
+    noexcept {
+    if (term.find('*') == string_view::npos)
+        return term.substr(0U, term.find('~')) == token;
+
+    size_t i = 0U, j = 0U, star = string_view::npos, mark = 0U;
+    while (j < token.size())
+        if (i < term.size() && term[i] == '*') {
+            star = i++;
+            mark = j;
+        } else if (i < term.size() && term[i] == token[j]) {
+            ++i;
+            ++j;
+        } else if (star != string_view::npos) {
+            i = star + 1U;
+            j = ++mark;
+        } else
+            return false;
+    while (i < term.size() && term[i] == '*')
+        ++i;
+    return i == term.size();
+}
@@ -0,0 +1,137 @@
+#include <cassert> // assert
+#include <cerrno> // ECANCELED, EINTR, errno
+
+#include <system_error> // generic_category, system_error
+
+#include <fcntl.h> // O_CLOEXEC
+#include <poll.h> // POLLIN, poll, pollfd
+#include <unistd.h> // close, pipe2, read, write
+
+#include <search_engine/stream_reader.hpp>
+
+using std::lock_guard, std::mutex, std::size_t, std::unique_lock;
+
+stream_reader::stream_reader(
+    const int fildes,
+    const size_t buffers,
+    const size_t buffer_size
+) : buffers_(buffers), fildes_(fildes) {
+    using std::generic_category, std::logic_error, std::system_error,
+        std::thread;
+
+    if (buffers < 2U || buffer_size == 0U) [[unlikely]] throw logic_error(
+        "stream_reader::stream_reader: at least two non-empty buffers "
+        "required"
+    );
+    for (buffer &current : buffers_)
+        current.data.resize(buffer_size);
+    if (pipe2(stop_.data(), O_CLOEXEC) == -1) [[unlikely]]
+        throw system_error(errno, generic_category(),
+            "stream_reader::stream_reader");
+    try {
+        thread_ = thread(&stream_reader::fill, this);
+    } catch (...) {
+        close(stop_[0]);
+        close(stop_[1]);
+        throw;
+    }
+}
+
+stream_reader::~stream_reader() noexcept {
+    {
+        const lock_guard<mutex> lock(mutex_);
+        errnum_ = ECANCELED;
+    }
+    emptied_.notify_one();
+    // Wakes the thread up if it waits for input.
+    static_cast<void>(write(stop_[1], "", 1U));
+    thread_.join();
+    close(stop_[0]);
+    close(stop_[1]);
+}
+
+std::string_view stream_reader::next() {
+    using std::generic_category, std::string_view, std::system_error;
+
+    unique_lock<mutex> lock(mutex_);
+    if (released_ != consumed_) {
+        released_ = consumed_;
+        emptied_.notify_one();
+    }
+    filled_.wait(lock, [this]() noexcept -> bool {
+        return produced_ > consumed_ || end_ != size_limits::max();
+    });
+    if (produced_ > consumed_) {
+        const buffer &current = buffers_[consumed_++ % buffers_.size()];
+        return string_view(current.data.data(), current.size);
+    } else if (errnum_ != 0) [[unlikely]]
+        throw system_error(errnum_, generic_category(), "stream_reader::next");
+    return string_view();
+}
+
+// Producer side: fills every free buffer with the input that is available
+// without blocking, so that the consumer gets large pieces while the input
+// keeps up and whatever has arrived when it does not, until the end of the
+// input or the destruction of the reader.
+void stream_reader::fill() noexcept {
+    const auto fail = [this](const int errnum) -> void {
+        const lock_guard<mutex> error_lock(mutex_);
+        errnum_ = errnum;
+        end_ = produced_;
+        filled_.notify_one();
+    };
+    for (;;) {
+        unique_lock<mutex> lock(mutex_);
+        emptied_.wait(lock, [this]() noexcept -> bool {
+            return errnum_ != 0 || produced_ - released_ < buffers_.size();
+        });
+        if (errnum_ != 0)
+            return;
+        buffer &current = buffers_[produced_ % buffers_.size()];
+        lock.unlock();
+
+        bool is_end = false;
+        current.size = 0U;
+        while (!is_end && current.size < current.data.size()) {
+            // Waits for input only while the buffer is empty. poll ignores
+            // negative descriptors, which are left for read to report.
+            pollfd events[2] = {
+                {fildes_, POLLIN, 0}, {stop_[0], POLLIN, 0}
+            };
+            const int ready = fildes_ < 0 ? 1 :
+                poll(events, 2U, current.size == 0U ? -1 : 0);
+            if (ready == -1) [[unlikely]] {
+                if (errno == EINTR)
+                    continue;
+                fail(errno);
+                return;
+            } else if (events[1].revents != 0)
+                return;
+            else if (ready == 0)
+                break;
+
+            const ssize_t count = read(fildes_,
+                current.data.data() + current.size,
+                current.data.size() - current.size);
+            if (count > 0) [[likely]]
+                current.size += static_cast<size_t>(count);
+            else if (count == 0)
+                is_end = true;
+            else if (errno != EINTR) [[unlikely]] {
+                fail(errno);
+                return;
+            }
+        }
+
+        lock.lock();
+        assert(end_ == size_limits::max());
+        if (current.size != 0U)
+            ++produced_;
+        if (is_end)
+            end_ = produced_;
+        lock.unlock();
+        filled_.notify_one();
+        if (is_end)
+            return;
+    }
+}
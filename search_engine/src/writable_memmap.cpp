@@ -0,0 +1,88 @@
+#include <cassert> // assert
+#include <cerrno> // EINVAL, EOPNOTSUPP, errno
+
+#include <exception> // exception
+#include <iostream> // cerr, endl
+#include <stdexcept> // logic_error
+#include <system_error> // generic_category, system_error
+
+#include <fcntl.h> // O_*, fallocate, open
+#include <sys/mman.h> // MAP_*, MS_SYNC, PROT_*, mmap, msync, munmap
+#include <unistd.h> // close, ftruncate
+
+#include <search_engine/writable_memmap.hpp>
+
+using std::generic_category, std::logic_error, std::size_t,
+    std::system_error;
+
+writable_memmap::writable_memmap(
+    const char * const filename,
+    const size_t size
+) : addr_(MAP_FAILED), size_(size) {
+    const int fildes =
+        ::open(filename, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fildes == -1) [[unlikely]] throw system_error(errno,
+        generic_category(), "writable_memmap::writable_memmap");
+
+    // Not every file system can allocate blocks, ftruncate at least sets the
+    // size.
+    int errnum = 0;
+    if (size != 0U) {
+        if (fallocate(fildes, 0, 0, static_cast<off_t>(size)) == -1 &&
+            ((errno != EOPNOTSUPP && errno != EINVAL) ||
+                ftruncate(fildes, static_cast<off_t>(size)) == -1)
+        ) [[unlikely]] errnum = errno;
+        else if (addr_ = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_SHARED, fildes, 0);
+            addr_ == MAP_FAILED
+        ) [[unlikely]] errnum = errno;
+    }
+    if (::close(fildes) == -1 && errnum == 0) [[unlikely]]
+        errnum = errno;
+    if (errnum != 0) [[unlikely]] {
+        if (addr_ != MAP_FAILED)
+            munmap(addr_, size);
+        throw system_error(errnum, generic_category(),
+            "writable_memmap::writable_memmap");
+    }
+}
+
+writable_memmap::~writable_memmap() noexcept {
+    using std::cerr, std::endl, std::exception;
+
+    if (is_open())
+        try {
+            close();
+        } catch (const exception &except) {
+#           ifndef NDEBUG
+            cerr << except.what() << endl;
+#           endif
+        }
+    assert(!is_open());
+}
+
+void writable_memmap::close() {
+    if (!is_open()) [[unlikely]]
+        throw logic_error("writable_memmap::close: file is not open");
+
+    const int returns = addr_ == MAP_FAILED ? 0 : munmap(addr_, size_);
+    addr_ = MAP_FAILED;
+    size_ = size_limits::max();
+    if (returns == -1) [[unlikely]]
+        throw system_error(errno, generic_category(),
+            "writable_memmap::close");
+}
+
+char *writable_memmap::data() const {
+    if (!is_open()) [[unlikely]]
+        throw logic_error("writable_memmap::data: file is not open");
+    return addr_ == MAP_FAILED ? nullptr : static_cast<char *>(addr_);
+}
+
+void writable_memmap::sync() const {
+    if (!is_open()) [[unlikely]]
+        throw logic_error("writable_memmap::sync: file is not open");
+    if (addr_ != MAP_FAILED && msync(addr_, size_, MS_SYNC) == -1)
+        [[unlikely]] throw system_error(errno, generic_category(),
+            "writable_memmap::sync");
+}
@@ -0,0 +1,75 @@
+#include <clocale> // LC_ALL, setlocale
+
+#include <functional> // function
+#include <stdexcept> // logic_error, runtime_error
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/analyzer.hpp>
+
+using std::logic_error, std::string, std::string_view, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+template<bool StopWords = false, bool Stem = false>
+static vector<string> analyze(string_view);
+
+TEST(AnalyzerTest, Empty) {
+    ASSERT_THAT(analyze(""), IsEmpty());
+    ASSERT_THAT(analyze(" \t\n,.-"), IsEmpty());
+}
+
+TEST(AnalyzerTest, Incomplete) {
+    ASSERT_THROW(analyze("\xD0"), logic_error);
+}
+
+TEST(AnalyzerTest, Normalize) {
+    ASSERT_THAT(analyze("The quick brown fox's U.S.A."),
+        ElementsAre("the", "quick", "brown", "fox", "usa")
+    );
+    ASSERT_THAT(analyze("Съешь ЕЩЁ этих булок"),
+        ElementsAre("съешь", "еще", "этих", "булок")
+    );
+}
+
+TEST(AnalyzerTest, Stem) {
+    ASSERT_THAT((analyze<false, true>("Москва москвы МОСКВОЙ")),
+        ElementsAre("москв", "москв", "москв")
+    );
+    ASSERT_THAT((analyze<false, true>("jumping foxes")),
+        ElementsAre("jump", "fox")
+    );
+}
+
+TEST(AnalyzerTest, StopWords) {
+    ASSERT_THAT((analyze<true>("The fox and the dog")),
+        ElementsAre("fox", "dog")
+    );
+    ASSERT_THAT((analyze<true, true>("история и география России")),
+        ElementsAre("истори", "географи", "росс")
+    );
+}
+
+template<bool StopWords, bool Stem>
+static vector<string> analyze(const string_view str) {
+    using std::function, std::runtime_error, std::setlocale;
+
+    if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
+        throw runtime_error("analyze: unable to set locale");
+
+    vector<string> terms;
+    analyzer<function<void(const string &)>, StopWords, Stem> invocable(
+        [&terms](const string &term) -> void {
+            terms.push_back(term);
+        }
+    );
+    for (const char c : str)
+        invocable(c);
+    invocable.flush();
+
+    return terms;
+}
@@ -0,0 +1,59 @@
+#include <cstdint> // uint32_t, uint64_t
+
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/bitmap.hpp>
+
+using std::uint32_t, std::uint64_t, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+static vector<uint64_t> make_bitmap(const vector<uint32_t> &ids) {
+    vector<uint64_t> words(bitmap_words(200U), 0U);
+    for (const uint32_t id : ids)
+        words[id / 64U] |= uint64_t{1} << (id % 64U);
+    return words;
+}
+
+TEST(BitmapTest, Words) {
+    ASSERT_EQ(bitmap_words(0U), 0U);
+    ASSERT_EQ(bitmap_words(1U), 1U);
+    ASSERT_EQ(bitmap_words(64U), 1U);
+    ASSERT_EQ(bitmap_words(65U), 2U);
+}
+
+TEST(BitmapTest, Extract) {
+    const vector<uint64_t> words = make_bitmap({0U, 63U, 64U, 130U, 199U});
+    ASSERT_EQ(bitmap_count(words.data(), words.size()), 5U);
+    ASSERT_TRUE(bitmap_contains(words.data(), 63U));
+    ASSERT_FALSE(bitmap_contains(words.data(), 62U));
+    vector<uint32_t> ids{7U};
+    bitmap_extract(words.data(), words.size(), ids);
+    ASSERT_THAT(ids, ElementsAre(7U, 0U, 63U, 64U, 130U, 199U));
+
+    ids.clear();
+    const vector<uint64_t> empty = make_bitmap({});
+    bitmap_extract(empty.data(), empty.size(), ids);
+    ASSERT_THAT(ids, IsEmpty());
+}
+
+TEST(BitmapTest, AndOr) {
+    vector<uint64_t> lhs = make_bitmap({1U, 64U, 100U, 150U});
+    const vector<uint64_t> rhs = make_bitmap({1U, 100U, 151U});
+    vector<uint64_t> both = lhs, only = lhs;
+    bitmap_and(both.data(), rhs.data(), both.size());
+    bitmap_and_not(only.data(), rhs.data(), only.size());
+    bitmap_or(lhs.data(), rhs.data(), lhs.size());
+    vector<uint32_t> ids;
+    bitmap_extract(both.data(), both.size(), ids);
+    ASSERT_THAT(ids, ElementsAre(1U, 100U));
+    ids.clear();
+    bitmap_extract(only.data(), only.size(), ids);
+    ASSERT_THAT(ids, ElementsAre(64U, 150U));
+    ids.clear();
+    bitmap_extract(lhs.data(), lhs.size(), ids);
+    ASSERT_THAT(ids, ElementsAre(1U, 64U, 100U, 150U, 151U));
+}
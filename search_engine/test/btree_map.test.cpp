@@ -0,0 +1,106 @@
+#include <cstddef> // size_t
+
+#include <algorithm> // sort, unique
+#include <stdexcept> // logic_error
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <utility> // pair
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/btree_map.hpp>
+
+using std::logic_error, std::pair, std::size_t, std::string,
+    std::string_view, std::to_string, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+template<typename Key, typename Value>
+static vector<Key> keys(const btree_map<Key, Value> &map) {
+    return vector<Key>(map.begin(), map.end());
+}
+
+TEST(BtreeMapTest, Empty) {
+    btree_map<uint, uint> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+    ASSERT_EQ(map.lower_bound(1U), map.end());
+    ASSERT_EQ(map.find(1U), nullptr);
+    map.assign({});
+    ASSERT_THAT(keys(map), IsEmpty());
+}
+
+TEST(BtreeMapTest, Insert) {
+    using std::sort, std::unique;
+
+    btree_map<uint, uint> map;
+    vector<uint> expected;
+    vector<bool> seen(1U << 16U, false);
+    uint seed = 1U;
+    for (size_t i = 0U; i < 20000U; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        const uint key = seed >> 16U;
+        ASSERT_EQ(map.insert(key, key * 2U), !seen[key]);
+        seen[key] = true;
+        expected.push_back(key);
+    }
+    sort(expected.begin(), expected.end());
+    expected.erase(unique(expected.begin(), expected.end()), expected.end());
+    ASSERT_EQ(map.size(), expected.size());
+    ASSERT_EQ(keys(map), expected);
+    for (const uint key : expected) {
+        ASSERT_NE(map.find(key), nullptr);
+        ASSERT_EQ(*map.find(key), key * 2U);
+    }
+    ASSERT_FALSE(map.insert(expected.front(), 0U));
+    ASSERT_EQ(*map.find(expected.front()), expected.front() * 2U);
+
+    ++map[expected.back()];
+    ASSERT_EQ(map[expected.back()], expected.back() * 2U + 1U);
+    ASSERT_EQ(map[70000U], 0U);
+    ASSERT_EQ(map.size(), expected.size() + 1U);
+}
+
+TEST(BtreeMapTest, Assign) {
+    btree_map<uint, uint> map;
+    vector<pair<uint, uint>> pairs;
+    for (uint key = 0U; key < 10000U; key += 2U)
+        pairs.emplace_back(key, key + 1U);
+    map.assign(vector<pair<uint, uint>>(pairs));
+    ASSERT_EQ(map.size(), pairs.size());
+    for (uint key = 1U; key < 10000U; key += 2U)
+        ASSERT_TRUE(map.insert(key, key + 1U));
+    uint expected = 0U;
+    for (auto iter = map.begin(); iter != map.end(); ++iter, ++expected) {
+        ASSERT_EQ(*iter, expected);
+        ASSERT_EQ(iter.value(), expected + 1U);
+    }
+    ASSERT_EQ(expected, 10000U);
+
+    pairs.emplace_back(0U, 0U);
+    ASSERT_THROW(map.assign(vector<pair<uint, uint>>(pairs)), logic_error);
+}
+
+TEST(BtreeMapTest, Ranges) {
+    btree_map<string, size_t> map;
+    for (size_t i = 0U; i < 1000U; ++i)
+        map.insert("term" + to_string(i), i);
+    ASSERT_EQ(*map.find(string_view("term42")), 42U);
+    ASSERT_EQ(map.find(string_view("term")), nullptr);
+
+    // Prefix scan.
+    vector<size_t> found;
+    for (auto iter = map.lower_bound(string_view("term99"));
+        iter != map.end() && iter->starts_with("term99"); ++iter
+    ) found.push_back(iter.value());
+    ASSERT_THAT(found, ElementsAre(99U, 990U, 991U, 992U, 993U, 994U, 995U,
+        996U, 997U, 998U, 999U));
+
+    ASSERT_EQ(*map.lower_bound(string_view("term5")), "term5");
+    ASSERT_EQ(*map.upper_bound(string_view("term5")), "term50");
+    ASSERT_EQ(*map.lower_bound(string_view("a")), "term0");
+    ASSERT_EQ(map.lower_bound(string_view("u")), map.end());
+    ASSERT_EQ(map.upper_bound(string_view("term999")), map.end());
+}
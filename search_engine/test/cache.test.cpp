@@ -0,0 +1,156 @@
+#include <cstddef> // size_t
+
+#include <memory> // make_shared, shared_ptr
+#include <stdexcept> // logic_error
+#include <string> // string, to_string
+#include <thread> // thread
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/cache.hpp>
+#include <search_engine/frequency_sketch.hpp>
+
+using std::logic_error, std::make_shared, std::size_t, std::string,
+    std::thread, std::to_string, std::vector;
+
+using int_cache = cache<int, int>;
+
+static void insert(int_cache &, int, size_t = 1U);
+
+TEST(CacheTest, Admission) {
+    cache<int, int, true> values(4U, 1U);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j)
+            ASSERT_EQ(values.find(i), nullptr);
+        values.insert(i, make_shared<const int>(i), 1U);
+    }
+    for (int i = 100; i < 200; ++i) {
+        ASSERT_EQ(values.find(i), nullptr);
+        values.insert(i, make_shared<const int>(i), 1U);
+    }
+    for (int i = 0; i < 4; ++i)
+        ASSERT_NE(values.find(i), nullptr);
+
+    const auto stats = values.stats();
+    ASSERT_EQ(stats.insertions, 4U);
+    ASSERT_EQ(stats.rejections, 100U);
+    ASSERT_EQ(stats.evictions, 0U);
+}
+
+TEST(CacheTest, Capacity) {
+    int_cache values(4U, 1U);
+    ASSERT_EQ(values.capacity(), 4U);
+    insert(values, 0, 5U);
+    ASSERT_EQ(values.find(0), nullptr);
+    ASSERT_EQ(values.stats().rejections, 1U);
+
+    for (int i = 0; i < 6; ++i)
+        insert(values, i);
+    const auto stats = values.stats();
+    ASSERT_EQ(stats.insertions, 6U);
+    ASSERT_EQ(stats.evictions, 2U);
+    ASSERT_EQ(stats.entries, 4U);
+    ASSERT_EQ(stats.size, 4U);
+    ASSERT_EQ(values.find(0), nullptr);
+    ASSERT_EQ(values.find(1), nullptr);
+    ASSERT_EQ(*values.find(5), 5);
+
+    values.clear();
+    ASSERT_EQ(values.stats().entries, 0U);
+    ASSERT_EQ(values.stats().size, 0U);
+}
+
+TEST(CacheTest, Shards) {
+    // Two shards of min_shard_capacity instead of 16 smaller ones.
+    int_cache values(2U * int_cache::min_shard_capacity);
+    insert(values, 0, int_cache::min_shard_capacity);
+    insert(values, 1, int_cache::min_shard_capacity + 1U);
+    ASSERT_NE(values.find(0), nullptr);
+    ASSERT_EQ(values.find(1), nullptr);
+    const auto stats = values.stats();
+    ASSERT_EQ(stats.insertions, 1U);
+    ASSERT_EQ(stats.rejections, 1U);
+}
+
+TEST(CacheTest, Invalid) {
+    ASSERT_THROW(int_cache(1U, 0U), logic_error);
+}
+
+TEST(CacheTest, Replace) {
+    int_cache values(8U, 1U);
+    insert(values, 1, 2U);
+    values.insert(1, make_shared<const int>(7), 3U);
+    ASSERT_EQ(*values.find(1), 7);
+    ASSERT_EQ(values.stats().size, 3U);
+    ASSERT_EQ(values.stats().insertions, 1U);
+}
+
+TEST(CacheTest, ScanResistance) {
+    int_cache values(10U, 1U);
+    for (int i = 0; i < 4; ++i) {
+        insert(values, i);
+        ASSERT_NE(values.find(i), nullptr);
+    }
+    for (int i = 100; i < 200; ++i)
+        insert(values, i);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_NE(values.find(i), nullptr);
+
+    const auto stats = values.stats();
+    ASSERT_EQ(stats.hits, 8U);
+    ASSERT_EQ(stats.misses, 0U);
+    ASSERT_EQ(stats.entries, 10U);
+}
+
+TEST(CacheTest, Threads) {
+    cache<string, string> values(1U << 12U);
+    vector<thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([&values]() -> void {
+            for (int j = 0; j < 1000; ++j) {
+                const string key = to_string(j % 64);
+                if (const auto value = values.find(key); value != nullptr)
+                    ASSERT_EQ(*value, key);
+                else
+                    values.insert(key, make_shared<const string>(key), 8U);
+            }
+        });
+    for (thread &current : threads)
+        current.join();
+
+    const auto stats = values.stats();
+    ASSERT_EQ(stats.hits + stats.misses, 4000U);
+    ASSERT_LE(stats.size, values.capacity());
+}
+
+TEST(FrequencySketchTest, Estimate) {
+    frequency_sketch sketch;
+    sketch.increment(1U);
+    ASSERT_EQ(sketch.estimate(1U), 0U);
+
+    sketch.resize(64U);
+    for (int i = 0; i < 5; ++i)
+        sketch.increment(1U);
+    sketch.increment(2U);
+    ASSERT_GE(sketch.estimate(1U), 5U);
+    ASSERT_GE(sketch.estimate(2U), 1U);
+    ASSERT_LT(sketch.estimate(2U), sketch.estimate(1U));
+    for (int i = 0; i < 100; ++i)
+        sketch.increment(1U);
+    ASSERT_LE(sketch.estimate(1U), 15U);
+}
+
+TEST(FrequencySketchTest, Reset) {
+    frequency_sketch sketch(64U);
+    for (int i = 0; i < 8; ++i)
+        sketch.increment(1U);
+    const uint before = sketch.estimate(1U);
+    for (size_t i = 0U; i < 640U; ++i)
+        sketch.increment(1000U + i);
+    ASSERT_LT(sketch.estimate(1U), before);
+}
+
+static void insert(int_cache &values, const int key, const size_t cost) {
+    values.insert(key, make_shared<const int>(key), cost);
+}
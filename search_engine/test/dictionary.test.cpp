@@ -0,0 +1,94 @@
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <algorithm> // sort, unique
+#include <stdexcept> // logic_error, out_of_range
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/dictionary.hpp>
+
+using std::logic_error, std::out_of_range, std::size_t, std::string,
+    std::string_view, std::to_string, std::uint64_t, std::vector;
+
+static vector<string> words(size_t);
+
+TEST(DictionaryTest, Empty) {
+    vector<uint64_t> offsets;
+    string blocks;
+    dictionary::encode({}, offsets, blocks);
+    ASSERT_EQ(offsets.size(), 1U);
+    ASSERT_TRUE(blocks.empty());
+
+    const dictionary dict(offsets.data(), blocks.data(), 0U);
+    ASSERT_EQ(dict.size(), 0U);
+    ASSERT_EQ(dict.begin(), dict.end());
+    ASSERT_EQ(dict.lower_bound("a"), dict.end());
+    ASSERT_FALSE(dict.find("a").has_value());
+    ASSERT_THROW(dict.term(0U), out_of_range);
+}
+
+TEST(DictionaryTest, Find) {
+    const vector<string> terms = words(1000U);
+    const vector<string_view> views(terms.cbegin(), terms.cend());
+    vector<uint64_t> offsets;
+    string blocks;
+    dictionary::encode(views, offsets, blocks);
+    ASSERT_EQ(offsets.size(), dictionary::blocks(terms.size()) + 1U);
+
+    const dictionary dict(offsets.data(), blocks.data(), terms.size());
+    size_t size = 0U;
+    for (const string &term : terms)
+        size += term.size();
+    ASSERT_LT(blocks.size(), size);
+    for (size_t i = 0U; i < terms.size(); ++i) {
+        ASSERT_EQ(dict.term(static_cast<dictionary::term_id>(i)), terms[i]);
+        const auto id = dict.find(terms[i]);
+        ASSERT_TRUE(id.has_value());
+        ASSERT_EQ(*id, i);
+        ASSERT_FALSE(dict.find(terms[i] + '~').has_value());
+    }
+    ASSERT_FALSE(dict.find("").has_value());
+    ASSERT_FALSE(dict.find("zzz").has_value());
+}
+
+TEST(DictionaryTest, Invalid) {
+    const vector<uint64_t> offsets = {0U, 0U};
+    const string blocks;
+    ASSERT_THROW(dictionary(offsets.data(), blocks.data(), 1U), logic_error);
+}
+
+TEST(DictionaryTest, Scan) {
+    const vector<string> terms = words(100U);
+    const vector<string_view> views(terms.cbegin(), terms.cend());
+    vector<uint64_t> offsets;
+    string blocks;
+    dictionary::encode(views, offsets, blocks);
+    const dictionary dict(offsets.data(), blocks.data(), terms.size());
+
+    size_t i = 0U;
+    for (auto iter = dict.begin(); iter != dict.end(); ++iter, ++i) {
+        ASSERT_EQ(iter.id(), i);
+        ASSERT_EQ(*iter, terms[i]);
+    }
+    ASSERT_EQ(i, terms.size());
+
+    ASSERT_EQ(dict.lower_bound("").id(), 0U);
+    ASSERT_EQ(*dict.lower_bound(terms[40] + '~'), terms[41]);
+    ASSERT_EQ(*dict.lower_bound(terms[63]), terms[63]);
+    ASSERT_EQ(dict.lower_bound("я"), dict.end());
+}
+
+static vector<string> words(const size_t count) {
+    using std::sort, std::unique;
+
+    vector<string> returns;
+    for (size_t i = 0U; returns.size() < count; ++i)
+        returns.push_back("москв" + to_string(i * 7U % 1009U) + "ой");
+    sort(returns.begin(), returns.end());
+    returns.erase(unique(returns.begin(), returns.end()), returns.end());
+    return returns;
+}
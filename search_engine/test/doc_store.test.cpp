@@ -0,0 +1,74 @@
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+
+#include <fstream> // ofstream
+#include <stdexcept> // logic_error, out_of_range
+#include <string> // string, to_string
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/indexer.hpp>
+
+using std::logic_error, std::out_of_range, std::size_t, std::string,
+    std::to_string, std::vector;
+
+TEST(DocStoreTest, Get) {
+    vector<string> titles, texts;
+    {
+        doc_store_writer store("docs.bin", 1024U);
+        for (size_t i = 0U; i < 500U; ++i) {
+            titles.push_back("Title " + to_string(i));
+            texts.push_back(string(i % 7U == 0U ? 3000U : i % 50U, 'a') +
+                " text of document " + to_string(i));
+            store.add(titles.back(), texts.back());
+        }
+        store.add("", "");
+        ASSERT_EQ(store.size(), 501U);
+        store.finish();
+        ASSERT_THROW(store.add("a", "b"), logic_error);
+    }
+
+    const doc_store store("docs.bin", 1U << 16U);
+    ASSERT_EQ(store.size(), 501U);
+    for (size_t i = 500U; i-- > 0U; ) {
+        const stored_document document =
+            store.get(static_cast<doc_store::doc_id>(i));
+        ASSERT_EQ(document.title, titles[i]);
+        ASSERT_EQ(document.text, texts[i]);
+    }
+    ASSERT_EQ(store.get(500U).title, "");
+    ASSERT_EQ(store.get(500U).text, "");
+    ASSERT_THROW(store.get(501U), out_of_range);
+    // Consecutive documents share blocks.
+    ASSERT_GT(store.stats().hits, 0U);
+}
+
+TEST(DocStoreTest, Invalid) {
+    {
+        std::ofstream file("docs.bin");
+        file << "SEDOCS01 but not a store";
+    }
+    ASSERT_THROW(doc_store("docs.bin"), logic_error);
+}
+
+TEST(DocStoreTest, Index) {
+    std::setlocale(LC_ALL, "en_US.utf8");
+    {
+        std::ofstream file("texts.json");
+        file << R"({"First": "Café au lait", "Second": "tea\ntime"})";
+    }
+    {
+        doc_store_writer store("docs.bin");
+        const class index built = make_index(vector<string>{"texts.json"},
+            store);
+        ASSERT_EQ(built.size(), 2U);
+    }
+    const doc_store store("docs.bin");
+    ASSERT_EQ(store.size(), 2U);
+    ASSERT_EQ(store.get(0U).title, "First");
+    ASSERT_EQ(store.get(0U).text, "Café au lait");
+    ASSERT_EQ(store.get(1U).title, "Second");
+    ASSERT_EQ(store.get(1U).text, "tea\ntime");
+}
@@ -0,0 +1,92 @@
+#include <cstddef> // size_t
+
+#include <algorithm> // sort
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <utility> // pair
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/flat_hash_map.hpp>
+
+using std::pair, std::size_t, std::string, std::string_view,
+    std::to_string, std::vector;
+
+using testing::ElementsAre;
+
+// Puts every key in the same group of slots, so that lookups go through the
+// tag matches and the probing.
+struct colliding_hash final {
+    size_t operator()(const size_t key) const noexcept {
+        return key % 2U;
+    }
+};
+
+TEST(FlatHashMapTest, Empty) {
+    flat_hash_map<string_view, size_t> map;
+    ASSERT_EQ(map.size(), 0U);
+    ASSERT_EQ(map.find("a"), nullptr);
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(FlatHashMapTest, Insert) {
+    vector<string> keys;
+    for (size_t i = 0U; i < 10000U; ++i)
+        keys.push_back("term" + to_string(i));
+    flat_hash_map<string_view, size_t> map;
+    for (size_t i = 0U; i < keys.size(); ++i) {
+        ASSERT_EQ(map.find(keys[i]), nullptr);
+        map.insert(keys[i], i);
+    }
+    ASSERT_EQ(map.size(), keys.size());
+    ASSERT_LT(map.size(), map.capacity());
+    for (size_t i = 0U; i < keys.size(); ++i) {
+        ASSERT_NE(map.find(keys[i]), nullptr);
+        ASSERT_EQ(*map.find(keys[i]), i);
+    }
+    ASSERT_EQ(map.find("term"), nullptr);
+    ++*map.find("term7");
+    ASSERT_EQ(*map.find("term7"), 8U);
+
+    size_t count = 0U;
+    for (const auto &[key, value] : map)
+        count += key.starts_with("term") ? 1U : 0U;
+    ASSERT_EQ(count, keys.size());
+}
+
+TEST(FlatHashMapTest, Collisions) {
+    using std::sort;
+
+    flat_hash_map<size_t, size_t, colliding_hash> map;
+    for (size_t key = 0U; key < 100U; ++key)
+        map.insert(key, key * key);
+    for (size_t key = 0U; key < 100U; ++key)
+        ASSERT_EQ(*map.find(key), key * key);
+    ASSERT_EQ(map.find(100U), nullptr);
+    vector<size_t> keys;
+    for (const auto &[key, value] : map)
+        keys.push_back(key);
+    sort(keys.begin(), keys.end());
+    ASSERT_EQ(keys.size(), 100U);
+    ASSERT_EQ(keys.back(), 99U);
+}
+
+TEST(FlatHashMapTest, Reserve) {
+    flat_hash_map<size_t, size_t> map;
+    map.reserve(1000U);
+    const size_t capacity = map.capacity();
+    ASSERT_GE(capacity, 1000U);
+    for (size_t key = 0U; key < 1000U; ++key)
+        map.insert(key, key);
+    ASSERT_EQ(map.capacity(), capacity);
+    map.reserve(10U);
+    ASSERT_EQ(map.capacity(), capacity);
+    map.clear();
+    ASSERT_EQ(map.size(), 0U);
+    ASSERT_EQ(map.find(1U), nullptr);
+    map.insert(1U, 2U);
+    ASSERT_THAT(vector(map.begin(), map.end()),
+        ElementsAre(pair<size_t, size_t>(1U, 2U)));
+}
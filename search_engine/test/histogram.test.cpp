@@ -0,0 +1,63 @@
+#include <cstdint> // uint64_t
+
+#include <limits> // numeric_limits
+
+#include <gtest/gtest.h>
+
+#include <search_engine/histogram.hpp>
+
+using std::numeric_limits, std::uint64_t;
+
+TEST(HistogramTest, Empty) {
+    const histogram values;
+    ASSERT_EQ(values.count(), 0U);
+    ASSERT_EQ(values.max(), 0U);
+    ASSERT_EQ(values.mean(), 0.0);
+    ASSERT_EQ(values.quantile(0.5), 0U);
+}
+
+TEST(HistogramTest, Exact) {
+    histogram values;
+    for (uint64_t i = 1U; i <= 100U; ++i)
+        values.record(i);
+    ASSERT_EQ(values.count(), 100U);
+    ASSERT_EQ(values.max(), 100U);
+    ASSERT_DOUBLE_EQ(values.mean(), 50.5);
+    ASSERT_EQ(values.quantile(0.0), 1U);
+    ASSERT_EQ(values.quantile(0.5), 50U);
+    ASSERT_EQ(values.quantile(0.99), 99U);
+    ASSERT_EQ(values.quantile(1.0), 100U);
+}
+
+TEST(HistogramTest, Precision) {
+    histogram values;
+    for (uint64_t i = 1U; i <= 1000000U; ++i)
+        values.record(i * 1000U);
+    for (const double q : {0.5, 0.9, 0.99, 0.999}) {
+        const double expected = q * 1e9;
+        const double actual = static_cast<double>(values.quantile(q));
+        ASSERT_GE(actual, expected);
+        ASSERT_LE(actual, expected * (1.0 + 1.0 / 64.0));
+    }
+    ASSERT_EQ(values.quantile(1.0), 1000000000U);
+
+    values.record(numeric_limits<uint64_t>::max());
+    ASSERT_EQ(values.quantile(1.0), numeric_limits<uint64_t>::max());
+}
+
+TEST(HistogramTest, Merge) {
+    histogram low, high;
+    for (uint64_t i = 0U; i < 90U; ++i)
+        low.record(10U);
+    for (uint64_t i = 0U; i < 10U; ++i)
+        high.record(5000U);
+    low += high;
+    ASSERT_EQ(low.count(), 100U);
+    ASSERT_EQ(low.quantile(0.9), 10U);
+    ASSERT_GE(low.quantile(0.91), 5000U);
+    ASSERT_LE(low.quantile(0.91), 5000U * 65U / 64U);
+
+    low.reset();
+    ASSERT_EQ(low.count(), 0U);
+    ASSERT_EQ(low.quantile(0.5), 0U);
+}
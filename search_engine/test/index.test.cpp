@@ -1,6 +1,375 @@
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+
+#include <fstream> // ofstream
+#include <iostream> // ios_base
+#include <sstream> // ostringstream
+#include <stdexcept> // logic_error, out_of_range, runtime_error
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <thread> // jthread
+#include <vector> // vector
+
+#include <fcntl.h> // O_NONBLOCK, O_RDONLY, open
+#include <sys/stat.h> // mkfifo
+#include <unistd.h> // close, unlink
+
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <search_engine/index.hpp>
+#include <search_engine/index_view.hpp>
+#include <search_engine/indexer.hpp>
+#include <search_engine/memmap.hpp>
+#include <search_engine/posting_cache.hpp>
+#include <search_engine/searcher.hpp>
+#include <search_engine/tombstones.hpp>
+
+using std::ios_base, std::jthread, std::logic_error, std::ofstream,
+    std::ostringstream, std::out_of_range, std::size_t, std::string,
+    std::string_view, std::to_string, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+template<bool StopWords = false, bool Stem = false>
+static string serialize(string_view);
+template<bool StopWords = false, bool Stem = false>
+static string serialize_profiled(string_view);
+
+static constexpr string_view texts = R"({
+"Москва": "Москва — столица России.",
+"Санкт-Петербург": "Второй по численности город России, бывшая столица.",
+"Fox": "The quick brown fox jumps over the lazy dog.",
+"Пустая статья": ""
+})";
+
+TEST(IndexTest, Cache) {
+    const string data = serialize<true, true>(texts);
+    const index_view view(data);
+    posting_cache postings(1U << 16U);
+    const searcher search(view, &postings);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_THAT(search("столица россии"), ElementsAre(0U, 1U));
+        ASSERT_THAT(search("столица россии город"), ElementsAre(1U));
+        ASSERT_THAT(search("столица москвы"), ElementsAre(0U));
+        ASSERT_THAT(search("fox"), ElementsAre(2U));
+        ASSERT_THAT(search("fox россии"), IsEmpty());
+    }
+    ASSERT_EQ(postings.pairs().stats().entries, 3U);
+    ASSERT_GT(postings.pairs().stats().hits, 0U);
+    ASSERT_GT(postings.lists().stats().hits, 0U);
+}
+
+TEST(IndexTest, Containers) {
+    class index built(0U);
+    vector<index::doc_id> all, even, rare{3U, 500U, 998U};
+    for (index::doc_id id = 0U; id < 1000U; ++id) {
+        built.insert_document("Document " + to_string(id));
+        built.insert_term(id, "every");
+        built.insert_term(id, id % 2U == 0U ? "even" : "odd");
+        all.push_back(id);
+        if (id % 2U == 0U)
+            even.push_back(id);
+    }
+    for (const index::doc_id id : rare)
+        built.insert_term(id, "rare");
+    built.write("containers.idx");
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << built;
+    const string data = stream.str();
+    const memmap map("containers.idx");
+    ASSERT_EQ(static_cast<string_view>(map), data);
+
+    const index_view view(data);
+    const index_statistics stats = view.stats(0U);
+    const container_statistics &gaps = stats.containers[index::gaps],
+        &runs = stats.containers[index::runs],
+        &bitmaps = stats.containers[index::bitmap];
+    ASSERT_EQ(gaps.lists, 1U);
+    ASSERT_EQ(gaps.postings, rare.size());
+    ASSERT_EQ(runs.lists, 1U);
+    ASSERT_EQ(runs.postings, all.size());
+    ASSERT_EQ(bitmaps.lists, 2U);
+    ASSERT_EQ(bitmaps.postings, all.size());
+    ASSERT_EQ(gaps.bytes + runs.bytes + bitmaps.bytes, stats.posting_bytes);
+    ASSERT_EQ(view.bitmap(*view.find("every")), nullptr);
+    ASSERT_EQ(view.bitmap(*view.find("rare")), nullptr);
+    ASSERT_NE(view.bitmap(*view.find("even")), nullptr);
+    vector<index::doc_id> ids;
+    view.postings(*view.find("every"), ids);
+    ASSERT_EQ(ids, all);
+    view.postings(*view.find("even"), ids);
+    ASSERT_EQ(ids, even);
+    view.postings(*view.find("rare"), ids);
+    ASSERT_EQ(ids, rare);
+
+    const searcher search(view);
+    ASSERT_EQ(search("even every"), even);
+    ASSERT_THAT(search("even odd"), IsEmpty());
+    ASSERT_THAT(search("rare even"), ElementsAre(500U, 998U));
+    ASSERT_THAT(search("rare odd every"), ElementsAre(3U));
+    ASSERT_EQ(search("ev*"), all);
+    ASSERT_EQ(search("o* r*").size(), 1U);
+
+    tombstones deleted(view.size());
+    for (const index::doc_id id : {0U, 3U, 500U, 501U})
+        deleted.insert(id);
+    const auto evaluate = [&search, &deleted](const string_view query) {
+        return search.evaluate(search.terms(query), &deleted);
+    };
+    ASSERT_EQ(evaluate("even").size(), even.size() - 2U);
+    ASSERT_EQ(evaluate("every").size(), all.size() - 4U);
+    ASSERT_THAT(evaluate("rare every"), ElementsAre(998U));
+    ASSERT_THAT(evaluate("rare odd every"), IsEmpty());
+    ASSERT_EQ(evaluate("ev*").size(), all.size() - 4U);
+    ASSERT_THAT(evaluate("ra*"), ElementsAre(998U));
+    ASSERT_EQ(search("rare"), rare);
+}
+
+TEST(IndexTest, Empty) {
+    const string data = serialize("{}");
+    const index_view view(data);
+    ASSERT_EQ(view.size(), 0U);
+    ASSERT_EQ(view.terms(), 0U);
+    ASSERT_FALSE(view.find("fox").has_value());
+    ASSERT_THAT(searcher(view)("fox"), IsEmpty());
+}
+
+TEST(IndexTest, Invalid) {
+    ASSERT_THROW(serialize(""), logic_error);
+    ASSERT_THROW(serialize("["), logic_error);
+    ASSERT_THROW(serialize("{\"title\": \"text\""), logic_error);
+    ASSERT_THROW(serialize("{\"\": \"text\"}"), logic_error);
+
+    string data = serialize(texts);
+    ASSERT_THROW(index_view(string_view(data).substr(0U, data.size() - 1U)),
+        logic_error);
+    data[0] = 'X';
+    ASSERT_THROW(index_view{data}, logic_error);
+}
+
+TEST(IndexTest, Search) {
+    const string data = serialize<true, true>(texts);
+    const index_view view(data);
+    const searcher search(view);
+    ASSERT_EQ(view.size(), 4U);
+    ASSERT_EQ(view.flags(), index::stop_words | index::stem);
+    ASSERT_EQ(view.title(0U), "Москва");
+    ASSERT_EQ(view.title(3U), "Пустая статья");
+    ASSERT_THROW(view.title(4U), out_of_range);
+
+    ASSERT_THAT(search("россии"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("СТОЛИЦЫ России"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("москвы"), ElementsAre(0U));
+    ASSERT_THAT(search("столица город"), ElementsAre(1U));
+    ASSERT_THAT(search("the foxes"), ElementsAre(2U));
+    ASSERT_THAT(search("fox россии"), IsEmpty());
+    ASSERT_THAT(search("несуществующий"), IsEmpty());
+    ASSERT_THAT(search("и или"), IsEmpty());
+}
+
+TEST(IndexTest, Wildcard) {
+    const string data = serialize<true, true>(texts);
+    const index_view view(data);
+    const searcher search(view);
+
+    ASSERT_THAT(search.terms("Мос* столица"),
+        ElementsAre("мос*", "столиц"));
+    ASSERT_THAT(search.terms("* ** и*"), ElementsAre("и*"));
+    ASSERT_THAT(search("мос*"), ElementsAre(0U));
+    ASSERT_THAT(search("РОС*"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("*ица"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("*олиц*"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("с*ц"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("*т*"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("*q*k"), ElementsAre(2U));
+    ASSERT_THAT(search("*g"), ElementsAre(2U));
+    ASSERT_THAT(search("*ю*"), IsEmpty());
+    ASSERT_THAT(search("f* *g"), ElementsAre(2U));
+    ASSERT_THAT(search("город *ица"), ElementsAre(1U));
+    ASSERT_THAT(search("город мос*"), IsEmpty());
+    ASSERT_THAT(search("*xyz*"), IsEmpty());
+
+    vector<index::term_id> ids;
+    view.expand("*", 2U, ids);
+    ASSERT_EQ(ids.size(), 2U);
+    view.expand("столиц", 10U, ids);
+    ASSERT_EQ(ids.size(), 1U);
+}
+
+TEST(IndexTest, Fuzzy) {
+    const string data = serialize<true, true>(texts);
+    const index_view view(data);
+    const searcher search(view);
+
+    ASSERT_THAT(search.terms("Моксва~ столца~2 город~0 brwn~9"),
+        ElementsAre("brwn~2", "город", "моксв~1", "столц~2"));
+    ASSERT_THAT(search("моксва~2"), ElementsAre(0U));
+    ASSERT_THAT(search("моксва~"), IsEmpty());
+    ASSERT_THAT(search("москва~0"), ElementsAre(0U));
+    ASSERT_THAT(search("столца~"), ElementsAre(0U, 1U));
+    ASSERT_THAT(search("горд~ столца~"), ElementsAre(1U));
+    ASSERT_THAT(search("quikc~2 brwn~"), ElementsAre(2U));
+    ASSERT_THAT(search("xyzzy~2"), IsEmpty());
+
+    vector<index::term_id> ids;
+    view.fuzzy("столица", 1U, 10U, ids);
+    ASSERT_EQ(ids.size(), 1U);
+    ASSERT_EQ(view.term(ids[0]), "столиц");
+    view.fuzzy("столица", 0U, 10U, ids);
+    ASSERT_TRUE(ids.empty());
+    view.fuzzy("", 3U, 2U, ids);
+    ASSERT_EQ(ids.size(), 2U);
+}
+
+TEST(IndexTest, Chunks) {
+    const string expected = serialize<true, true>(texts);
+    for (const size_t size : {1U, 2U, 3U, 7U, 16U, 64U}) {
+        vector<string> files;
+        for (size_t i = 0U; i < texts.size(); i += size) {
+            files.push_back("texts.json" + to_string(files.size()));
+            const string_view chunk = texts.substr(i, size);
+            ofstream(
+                files.back(),
+                ios_base::binary | ios_base::out | ios_base::trunc
+            ).write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }
+        ostringstream stream(ios_base::binary | ios_base::out);
+        stream << make_index<true, true>(files);
+        ASSERT_EQ(stream.str(), expected);
+    }
+}
+
+TEST(IndexTest, Fifo) {
+    static constexpr const char *filename = "texts.fifo";
+    unlink(filename);
+    ASSERT_EQ(mkfifo(filename, 0600), 0);
+    jthread writer([]() -> void {
+        ofstream(filename, ios_base::binary | ios_base::out).write(
+            texts.data(), static_cast<std::streamsize>(texts.size()));
+    });
+    // If make_index throws before it opens the FIFO, the writer blocks in
+    // open; a reader opened here lets it through and stays open until the
+    // writer is joined, so that the writer does not get SIGPIPE either.
+    struct guard final {
+        jthread &writer;
+
+        ~guard() noexcept {
+            const int fildes = open(filename, O_RDONLY | O_NONBLOCK);
+            writer.join();
+            if (fildes != -1)
+                close(fildes);
+            unlink(filename);
+        }
+    } unblock{writer};
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << make_index<true, true>(vector<string>{filename});
+    ASSERT_EQ(stream.str(), (serialize<true, true>(texts)));
+}
+
+TEST(IndexTest, Write) {
+    static constexpr const char *filename = "texts.idx";
+    const string expected = serialize<true, true>(texts);
+    make_index<true, true>("texts.json").write(filename);
+    const memmap map(filename);
+    ASSERT_EQ(static_cast<string_view>(map), expected);
+}
+
+TEST(IndexTest, Profile) {
+    ASSERT_EQ(serialize(texts), serialize_profiled(texts));
+    ASSERT_EQ((serialize<true, true>(texts)),
+        (serialize_profiled<true, true>(texts)));
+}
+
+TEST(IndexTest, Inversion) {
+    static constexpr const char *filename = "texts.json";
+
+    const string expected = serialize<true, true>(texts);
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << make_index<true, true>(filename, inversion::sort);
+    ASSERT_EQ(stream.str(), expected);
+    index_profile profile;
+    stream.str("");
+    stream << make_index<true, true>(vector<string>{filename}, profile,
+        inversion::sort);
+    ASSERT_EQ(stream.str(), expected);
+    ASSERT_GT(profile.stages[index_profile::invert].wall_time, 0U);
+}
+
+TEST(IndexTest, Stats) {
+    const string data = serialize(texts);
+    const index_view view(data);
+    const index_statistics stats = view.stats(2U);
+    ASSERT_EQ(stats.documents, 4U);
+    ASSERT_EQ(stats.terms, view.terms());
+    ASSERT_EQ(stats.lengths.size(), 2U);
+    ASSERT_EQ(stats.lengths[0] + stats.lengths[1], view.terms());
+    ASSERT_EQ(stats.lengths[1], 2U);
+    ASSERT_EQ(stats.postings, stats.lengths[0] + 2U * stats.lengths[1]);
+    ASSERT_EQ(stats.header_bytes + stats.title_bytes +
+        stats.dictionary_bytes + stats.hash_bytes + stats.gram_bytes +
+        stats.posting_table_bytes + stats.posting_bytes, data.size());
+    // One container byte and one byte per d-gap.
+    ASSERT_EQ(stats.posting_bytes, stats.terms + stats.postings);
+    ASSERT_EQ(stats.containers[index::gaps].lists, stats.terms);
+    ASSERT_EQ(stats.containers[index::gaps].postings, stats.postings);
+    ASSERT_EQ(stats.containers[index::gaps].bytes, stats.posting_bytes);
+    ASSERT_EQ(stats.containers[index::runs].lists +
+        stats.containers[index::bitmap].lists, 0U);
+    ASSERT_EQ(stats.longest.size(), 2U);
+    ASSERT_EQ(stats.longest[0].second, 2U);
+    ASSERT_EQ(stats.longest[1].second, 2U);
+    ASSERT_NE(stats.longest[0].first, stats.longest[1].first);
+
+    ASSERT_TRUE(view.stats(0U).longest.empty());
+    ASSERT_EQ(index_view().stats(1U).terms, 0U);
+}
+
+TEST(IndexTest, Terms) {
+    const string data = serialize(texts);
+    const index_view view(data);
+    for (index::term_id id = 1U; id < view.terms(); ++id)
+        ASSERT_LT(view.term(id - 1U), view.term(id));
+
+    const auto id = view.find("россии");
+    ASSERT_TRUE(id.has_value());
+    ASSERT_EQ(view.term(*id), "россии");
+    ASSERT_EQ(view.frequency(*id), 2U);
+    vector<index::doc_id> ids;
+    view.postings(*id, ids);
+    ASSERT_THAT(ids, ElementsAre(0U, 1U));
+    ASSERT_FALSE(view.find("росси").has_value());
+}
+
+template<bool StopWords, bool Stem>
+static string serialize(const string_view json) {
+    using std::runtime_error, std::setlocale;
+    static constexpr const char *filename = "texts.json";
+
+    if (setlocale(LC_ALL, "en_US.utf8") == nullptr) [[unlikely]]
+        throw runtime_error("serialize: unable to set locale");
+
+    ofstream(
+        filename,
+        ios_base::binary | ios_base::out | ios_base::trunc
+    ).write(json.data(), static_cast<std::streamsize>(json.size()));
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << make_index<StopWords, Stem>(filename);
+    return stream.str();
+}
+
+template<bool StopWords, bool Stem>
+static string serialize_profiled(const string_view json) {
+    static constexpr const char *filename = "texts.json";
 
-TEST(IndexTest, FIXME) {
+    serialize<StopWords, Stem>(json);
+    index_profile profile;
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << make_index<StopWords, Stem>(vector<string>{filename}, profile);
+    for (const stage_statistics &stats : profile.stages) {
+        EXPECT_EQ(stats.bytes, profile.stages.front().bytes);
+        EXPECT_EQ(stats.tokens, profile.stages.front().tokens);
+    }
+    EXPECT_GT(profile.stages.front().tokens, 0U);
+    return stream.str();
 }
@@ -0,0 +1,58 @@
+#include <cstddef> // size_t
+
+#include <iostream> // ios_base
+#include <sstream> // ostringstream
+#include <string> // string, to_string
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/index.hpp>
+#include <search_engine/inverter.hpp>
+#include <search_engine/radix_sort.hpp>
+
+using std::ios_base, std::ostringstream, std::size_t, std::string,
+    std::to_string, std::vector;
+
+static string serialize(const class index &);
+
+TEST(InverterTest, Empty) {
+    class index built(0U), expected(0U);
+    inverter records(built);
+    records.finish();
+    ASSERT_EQ(records.size(), 0U);
+    ASSERT_EQ(serialize(built), serialize(expected));
+}
+
+TEST(InverterTest, Postings) {
+    static constexpr index::doc_id documents = 3U * radix_slice;
+
+    class index built(index::stem), expected(index::stem);
+    inverter records(built, 4U);
+    size_t terms = 0U;
+    for (index::doc_id id = 0U; id < documents; ++id) {
+        const string title = "Document " + to_string(id);
+        built.insert_document(title);
+        expected.insert_document(title);
+        // Every term twice, to be recorded once.
+        const string thousandth = string("m").append(to_string(id % 1000U)),
+            seventh = string("s").append(to_string(id % 7U));
+        const vector<string> words{"every", thousandth, seventh, "every",
+            seventh};
+        for (const string &word : words) {
+            records.insert_term(id, word);
+            expected.insert_term(id, word);
+        }
+        terms += 3U;
+    }
+    ASSERT_EQ(records.size(), terms);
+    records.finish();
+    ASSERT_EQ(records.size(), 0U);
+    ASSERT_EQ(serialize(built), serialize(expected));
+}
+
+static string serialize(const class index &built) {
+    ostringstream stream(ios_base::binary | ios_base::out);
+    stream << built;
+    return stream.str();
+}
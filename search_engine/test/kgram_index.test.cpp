@@ -0,0 +1,57 @@
+#include <stdexcept> // logic_error
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/kgram_index.hpp>
+
+using std::logic_error, std::string, std::string_view, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+TEST(KgramIndexTest, Find) {
+    const vector<string_view> terms = {"биолог", "истори", "москв", "мост"};
+    const string data = kgram_index::encode(terms);
+    const kgram_index grams(data.data(), data.size());
+    ASSERT_GT(grams.size(), 0U);
+
+    vector<kgram_index::term_id> ids;
+    grams.find("$мо", ids);
+    ASSERT_THAT(ids, ElementsAre(2U, 3U));
+    grams.find("ори", ids);
+    ASSERT_THAT(ids, ElementsAre(1U));
+    grams.find("ог$", ids);
+    ASSERT_THAT(ids, ElementsAre(0U));
+    grams.find("т", ids);
+    ASSERT_THAT(ids, ElementsAre(1U, 3U));
+    grams.find("$м", ids);
+    ASSERT_THAT(ids, ElementsAre(2U, 3U));
+    grams.find("и$", ids);
+    ASSERT_THAT(ids, ElementsAre(1U));
+    grams.find("$", ids);
+    ASSERT_THAT(ids, IsEmpty());
+    grams.find("xyz", ids);
+    ASSERT_THAT(ids, IsEmpty());
+}
+
+TEST(KgramIndexTest, Grams) {
+    vector<string_view> grams;
+    kgram_index::grams("$мост$", grams);
+    ASSERT_THAT(grams, ElementsAre("$мо", "мос", "ост", "ст$"));
+    grams.clear();
+    kgram_index::grams("мо", grams);
+    ASSERT_THAT(grams, ElementsAre("мо"));
+    grams.clear();
+    kgram_index::grams("$", grams);
+    kgram_index::grams("", grams);
+    ASSERT_THAT(grams, IsEmpty());
+}
+
+TEST(KgramIndexTest, Invalid) {
+    const string data = kgram_index::encode({"москв"});
+    ASSERT_THROW(kgram_index(data.data(), data.size() - 8U),
+        logic_error);
+}
@@ -0,0 +1,56 @@
+#include <cstddef> // size_t
+
+#include <string_view> // wstring_view
+
+#include <gtest/gtest.h>
+
+#include <search_engine/levenshtein_automaton.hpp>
+
+using std::size_t, std::wstring_view;
+
+static bool accepts(levenshtein_automaton &, wstring_view);
+
+TEST(LevenshteinAutomatonTest, Distance) {
+    levenshtein_automaton one(L"москва", 1U);
+    ASSERT_TRUE(accepts(one, L"москва"));
+    ASSERT_TRUE(accepts(one, L"моска"));
+    ASSERT_TRUE(accepts(one, L"москвы"));
+    ASSERT_TRUE(accepts(one, L"москвая"));
+    ASSERT_FALSE(accepts(one, L"моксва"));
+    ASSERT_FALSE(accepts(one, L"мск"));
+    ASSERT_FALSE(accepts(one, L""));
+
+    levenshtein_automaton two(L"москва", 2U);
+    ASSERT_TRUE(accepts(two, L"моксва"));
+    ASSERT_TRUE(accepts(two, L"моск"));
+    ASSERT_FALSE(accepts(two, L"мск"));
+    ASSERT_FALSE(accepts(two, L"питер"));
+}
+
+TEST(LevenshteinAutomatonTest, Dead) {
+    levenshtein_automaton automaton(L"fox", 1U);
+    auto state = levenshtein_automaton::start();
+    for (const wchar_t wc : wstring_view(L"zz"))
+        state = automaton.step(state, wc);
+    ASSERT_EQ(state, levenshtein_automaton::dead);
+    ASSERT_EQ(automaton.step(state, L'f'), levenshtein_automaton::dead);
+    ASSERT_FALSE(automaton.is_match(state));
+}
+
+TEST(LevenshteinAutomatonTest, Empty) {
+    levenshtein_automaton zero(L"", 0U);
+    ASSERT_TRUE(accepts(zero, L""));
+    ASSERT_FALSE(accepts(zero, L"a"));
+
+    levenshtein_automaton two(L"", 2U);
+    ASSERT_TRUE(accepts(two, L"ab"));
+    ASSERT_FALSE(accepts(two, L"abc"));
+}
+
+static bool accepts(levenshtein_automaton &automaton, const wstring_view str) {
+    auto state = levenshtein_automaton::start();
+    for (size_t i = 0U; i < str.size() && state != levenshtein_automaton::dead;
+        ++i
+    ) state = automaton.step(state, str[i]);
+    return automaton.is_match(state);
+}
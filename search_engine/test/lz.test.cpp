@@ -0,0 +1,62 @@
+#include <cstddef> // size_t
+
+#include <random> // mt19937, uniform_int_distribution
+#include <stdexcept> // logic_error
+#include <string> // string
+
+#include <gtest/gtest.h>
+
+#include <search_engine/lz.hpp>
+
+using std::logic_error, std::size_t, std::string;
+
+static void round_trip(const string &input) {
+    string compressed, output;
+    lz_compress(input, compressed);
+    lz_decompress(compressed, input.size(), output);
+    ASSERT_EQ(output, input);
+}
+
+TEST(LzTest, Empty) {
+    round_trip("");
+    round_trip("abc");
+}
+
+TEST(LzTest, Repetitive) {
+    string input;
+    for (size_t i = 0U; i < 1000U; ++i)
+        input += "the quick brown fox jumps over the lazy dog ";
+    string compressed;
+    lz_compress(input, compressed);
+    ASSERT_LT(compressed.size(), input.size() / 20U);
+    round_trip(input);
+    // Runs, which decompress from overlapping matches.
+    round_trip(string(100000U, 'a'));
+    round_trip("ab" + string(300U, 'b') + "ab");
+}
+
+TEST(LzTest, Random) {
+    using std::mt19937, std::uniform_int_distribution;
+
+    mt19937 generator(42U);
+    uniform_int_distribution<int> byte(0, 255), letter('a', 'd');
+    string noise, letters;
+    for (size_t i = 0U; i < 200000U; ++i) {
+        noise.push_back(static_cast<char>(byte(generator)));
+        letters.push_back(static_cast<char>(letter(generator)));
+    }
+    round_trip(noise);
+    round_trip(letters);
+}
+
+TEST(LzTest, Invalid) {
+    string compressed, output;
+    lz_compress(string(1000U, 'x') + "yz", compressed);
+    ASSERT_THROW(lz_decompress(compressed, 1001U, output), logic_error);
+    ASSERT_THROW(lz_decompress(compressed, 1003U, output), logic_error);
+    ASSERT_THROW(lz_decompress(compressed.substr(0U, 3U), 1002U, output),
+        logic_error);
+    // An offset pointing before the start of the output.
+    ASSERT_THROW(lz_decompress(string("\x10" "a\x05\x00", 4U), 5U, output),
+        logic_error);
+}
@@ -1,12 +1,16 @@
+#include <cstddef> // size_t
+
 #include <fstream> // ofstream
 #include <iostream> // ios_base
+#include <string> // string
 #include <string_view> // string_view
 
 #include <gtest/gtest.h>
 
 #include <search_engine/memmap.hpp>
 
-using std::ios_base, std::ofstream, std::string_view;
+using std::ios_base, std::ofstream, std::size_t, std::string,
+    std::string_view;
 
 TEST(MemmapTest, Empty) {
     static constexpr const char *filename = "empty.txt";
@@ -39,3 +43,35 @@ TEST(MemmapTest, Pangram) {
     ASSERT_EQ(static_cast<string_view>(map), data);
     ASSERT_EQ(map.size(), data.size());
 }
+
+TEST(MemmapTest, Advance) {
+    static constexpr const char *filename = "advance.txt";
+    string data;
+    for (size_t i = 0U; data.size() < (1U << 20U); ++i)
+        data.append(std::to_string(i)).push_back('\n');
+    ofstream(
+        filename,
+        ios_base::binary | ios_base::out | ios_base::trunc
+    ).write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    memmap map(filename, memmap::sequential | memmap::huge_pages);
+    const string_view view(map);
+    string read;
+    for (size_t offset = 0U; offset < view.size(); offset += 10000U) {
+        map.advance(offset, 1U << 16U, true);
+        read.append(view.substr(offset, 10000U));
+    }
+    map.advance(view.size() + 1U, 1U << 16U, true);
+    ASSERT_EQ(read, data);
+    ASSERT_EQ(view, data);
+
+    const memmap populated(filename, memmap::populate);
+    ASSERT_EQ(static_cast<string_view>(populated), data);
+
+    static constexpr const char *empty_filename = "empty.txt";
+    ofstream(empty_filename,
+        ios_base::binary | ios_base::out | ios_base::trunc);
+    memmap empty(empty_filename, memmap::sequential);
+    empty.advance(0U, 1U << 16U, true);
+    ASSERT_TRUE(empty.empty());
+}
@@ -0,0 +1,56 @@
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#include <stdexcept> // logic_error
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/perfect_hash.hpp>
+
+using std::logic_error, std::size_t, std::string, std::string_view,
+    std::to_string, std::uint64_t, std::vector;
+
+TEST(PerfectHashTest, Empty) {
+    const vector<uint64_t> words = perfect_hash::encode({});
+    const perfect_hash hash(words.data(), words.size(), 0U);
+    ASSERT_EQ(hash.size(), 0U);
+    ASSERT_FALSE(hash.find("").has_value());
+    ASSERT_FALSE(hash.find("москва").has_value());
+}
+
+TEST(PerfectHashTest, Find) {
+    static constexpr size_t count = 10000U;
+
+    vector<string> terms;
+    for (size_t i = 0U; i < count; ++i)
+        terms.push_back("слово" + to_string(i));
+    const vector<string_view> views(terms.cbegin(), terms.cend());
+    const vector<uint64_t> words = perfect_hash::encode(views);
+    ASSERT_LT(words.size() * 64U, count * 48U);
+    const perfect_hash hash(words.data(), words.size(), count);
+    for (size_t i = 0U; i < count; ++i) {
+        const auto id = hash.find(terms[i]);
+        ASSERT_TRUE(id.has_value());
+        ASSERT_EQ(*id, i);
+    }
+
+    size_t rejected = 0U;
+    for (size_t i = count; i < 2U * count; ++i)
+        rejected += !hash.find("слово" + to_string(i)).has_value();
+    ASSERT_GT(rejected, count * 9U / 10U);
+}
+
+TEST(PerfectHashTest, Invalid) {
+    const vector<string_view> terms = {"a", "b", "c"};
+    vector<uint64_t> words = perfect_hash::encode(terms);
+    ASSERT_THROW(perfect_hash(words.data(), words.size() - 1U, terms.size()),
+        logic_error);
+    ASSERT_THROW(perfect_hash(words.data(), words.size(), terms.size() + 8U),
+        logic_error);
+    words[0] = 1000U;
+    ASSERT_THROW(perfect_hash(words.data(), words.size(), terms.size()),
+        logic_error);
+}
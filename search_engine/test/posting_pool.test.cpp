@@ -0,0 +1,61 @@
+#include <cstddef> // size_t
+
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/posting_pool.hpp>
+
+using std::size_t, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+using doc_id = posting_pool::doc_id;
+
+TEST(PostingPoolTest, Empty) {
+    const posting_pool pool;
+    vector<doc_id> ids{1U};
+    pool.copy(posting_pool::list{}, ids);
+    ASSERT_THAT(ids, IsEmpty());
+    ASSERT_EQ(pool.capacity(), 0U);
+}
+
+TEST(PostingPoolTest, Interleaved) {
+    posting_pool pool;
+    vector<posting_pool::list> lists(100U);
+    vector<vector<doc_id>> expected(lists.size());
+    // List i gets every id divisible by i + 1, so the lengths range from
+    // a single block to hundreds of blocks of the largest size.
+    for (doc_id id = 0U; id < 1000000U; ++id)
+        for (size_t i = 0U; i < lists.size(); i += 7U)
+            if (id % (i + 1U) == 0U) {
+                pool.append(lists[i], id);
+                expected[i].push_back(id);
+                ASSERT_EQ(pool.back(lists[i]), id);
+            }
+    vector<doc_id> ids;
+    for (size_t i = 0U; i < lists.size(); ++i) {
+        pool.copy(lists[i], ids);
+        ASSERT_EQ(ids, expected[i]);
+    }
+    ASSERT_GT(pool.capacity(), posting_pool::slab_size * sizeof(doc_id));
+}
+
+TEST(PostingPoolTest, Blocks) {
+    posting_pool pool;
+    posting_pool::list small, large;
+    pool.append(small, 7U);
+    for (doc_id id = 0U; id < 10U; ++id)
+        pool.append(large, id);
+    pool.append(small, 8U);
+    vector<doc_id> ids;
+    pool.copy(small, ids);
+    ASSERT_THAT(ids, ElementsAre(7U, 8U));
+    pool.copy(large, ids);
+    ASSERT_EQ(ids.size(), 10U);
+    ASSERT_EQ(ids.back(), 9U);
+    ASSERT_EQ(large.size, 10U);
+    // Blocks of 4 and 4 ids, then one of 8.
+    ASSERT_EQ(large.free, 6U);
+}
@@ -0,0 +1,73 @@
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint32_t, uint64_t
+
+#include <algorithm> // sort, stable_sort
+#include <random> // mt19937_64
+#include <utility> // pair
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/radix_sort.hpp>
+
+using std::mt19937_64, std::pair, std::size_t, std::sort, std::stable_sort,
+    std::uint32_t, std::uint64_t, std::uint8_t, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+static constexpr auto identity = [](const uint64_t value) noexcept {
+    return value;
+};
+
+TEST(RadixSortTest, Empty) {
+    vector<uint64_t> values;
+    radix_sort(values, identity, 4U);
+    ASSERT_THAT(values, IsEmpty());
+    values = {3U, 1U, 2U};
+    radix_sort(values, identity, 4U);
+    ASSERT_THAT(values, ElementsAre(1U, 2U, 3U));
+}
+
+TEST(RadixSortTest, Keys) {
+    mt19937_64 random(42U);
+    for (const size_t threads : {1U, 4U}) {
+        vector<uint64_t> values(3U * radix_slice + 5U);
+        for (uint64_t &value : values)
+            value = random();
+        vector<uint64_t> expected = values;
+        sort(expected.begin(), expected.end());
+        radix_sort(values, identity, threads);
+        ASSERT_EQ(values, expected);
+    }
+}
+
+TEST(RadixSortTest, Stable) {
+    using record = pair<uint32_t, uint32_t>;
+
+    mt19937_64 random(7U);
+    const auto key = [](const record &value) noexcept -> uint32_t {
+        return value.first;
+    };
+    for (const size_t threads : {1U, 3U}) {
+        // Keys below 1000 leave the two high bytes the same everywhere.
+        vector<record> values(4U * radix_slice);
+        for (uint32_t i = 0U; i < values.size(); ++i)
+            values[i] = {static_cast<uint32_t>(random() % 1000U), i};
+        vector<record> expected = values;
+        stable_sort(expected.begin(), expected.end(),
+            [&key](const record &lhs, const record &rhs) -> bool {
+                return key(lhs) < key(rhs);
+            });
+        radix_sort(values, key, threads);
+        ASSERT_EQ(values, expected);
+    }
+}
+
+TEST(RadixSortTest, Bytes) {
+    vector<uint32_t> values{0x1FFU, 0x200U, 0x100U, 0x2FFU, 0x101U};
+    radix_sort(values, [](const uint32_t value) noexcept {
+        return static_cast<uint8_t>(value);
+    });
+    ASSERT_THAT(values, ElementsAre(0x200U, 0x100U, 0x101U, 0x1FFU, 0x2FFU));
+}
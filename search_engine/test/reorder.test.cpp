@@ -0,0 +1,97 @@
+#include <cstddef> // size_t
+
+#include <algorithm> // is_permutation
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index.hpp>
+#include <search_engine/index_view.hpp>
+#include <search_engine/memmap.hpp>
+#include <search_engine/reorder.hpp>
+
+using std::size_t, std::string, std::string_view, std::to_string, std::vector;
+
+// Documents of two topics in a shuffled order, each with a term of its own.
+static void make_topics(const char * const file, vector<uint> &topics) {
+    static constexpr const char *words[2][4] = {
+        {"apple", "banana", "cherry", "date"},
+        {"xray", "yankee", "zulu", "whiskey"}
+    };
+
+    class index built(0U);
+    uint seed = 1U;
+    for (index::doc_id id = 0U; id < 256U; ++id) {
+        seed = seed * 1103515245U + 12345U;
+        topics.push_back(seed >> 30U & 1U);
+        built.insert_document("Document " + to_string(id));
+        for (index::doc_id term = 0U; term < 4U; ++term)
+            if ((id + term) % 4U != 0U)
+                built.insert_term(id, words[topics.back()][term]);
+        built.insert_term(id, "unique" + to_string(id));
+    }
+    built.write(file);
+}
+
+TEST(ReorderTest, Topics) {
+    using std::is_permutation;
+
+    vector<uint> topics;
+    make_topics("topics.idx", topics);
+    const memmap map("topics.idx");
+    const index_view view(static_cast<string_view>(map));
+    for (const size_t threads : {1U, 4U}) {
+        const vector<index::doc_id> order = bisection_order(view, threads);
+        vector<index::doc_id> identity(order.size());
+        for (index::doc_id id = 0U; id < identity.size(); ++id)
+            identity[id] = id;
+        ASSERT_TRUE(is_permutation(order.cbegin(), order.cend(),
+            identity.cbegin()));
+        // The topics end up in contiguous runs.
+        size_t runs = 1U;
+        for (size_t i = 1U; i < order.size(); ++i)
+            runs += topics[order[i]] != topics[order[i - 1U]] ? 1U : 0U;
+        ASSERT_LE(runs, 4U);
+
+        const class index reordered = reorder(view, order);
+        reordered.write("reordered.idx");
+        const memmap reordered_map("reordered.idx");
+        const index_view reordered_view(
+            static_cast<string_view>(reordered_map));
+        ASSERT_EQ(reordered_view.size(), 256U);
+        vector<index::doc_id> ids;
+        for (index::doc_id id = 0U; id < 256U; ++id) {
+            ASSERT_EQ(reordered_view.title(id), view.title(order[id]));
+            reordered_view.postings(*reordered_view.find(
+                "unique" + string(view.title(order[id]).substr(9U))), ids);
+            ASSERT_EQ(ids, vector<index::doc_id>{id});
+        }
+    }
+}
+
+TEST(ReorderTest, Store) {
+    {
+        doc_store_writer writer("docs.bin", 64U);
+        for (size_t i = 0U; i < 10U; ++i)
+            writer.add("Title " + to_string(i), "Text " + to_string(i));
+        writer.finish();
+    }
+    const vector<index::doc_id> order = {3U, 1U, 4U, 0U, 5U, 9U, 2U, 6U, 8U,
+        7U};
+    {
+        const doc_store store("docs.bin");
+        doc_store_writer writer("reordered.bin");
+        reorder(store, order, writer);
+    }
+    const doc_store store("reordered.bin");
+    ASSERT_EQ(store.size(), 10U);
+    for (size_t i = 0U; i < order.size(); ++i) {
+        ASSERT_EQ(store.get(static_cast<index::doc_id>(i)).title,
+            "Title " + to_string(order[i]));
+        ASSERT_EQ(store.get(static_cast<index::doc_id>(i)).text,
+            "Text " + to_string(order[i]));
+    }
+}
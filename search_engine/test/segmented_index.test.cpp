@@ -0,0 +1,159 @@
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+
+#include <algorithm> // sort
+#include <filesystem> // directory_entry, directory_iterator, path,
+                      // remove_all
+#include <fstream> // ofstream
+#include <iostream> // ios_base
+#include <stdexcept> // logic_error
+#include <string> // string
+#include <string_view> // string_view
+#include <vector> // vector
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <search_engine/index.hpp>
+#include <search_engine/segmented_index.hpp>
+
+using std::ios_base, std::ofstream, std::size_t, std::string,
+    std::string_view, std::vector;
+
+using testing::ElementsAre, testing::IsEmpty;
+
+static constexpr const char *directory = "segments";
+
+static constexpr string_view documents[] = {
+    R"({"Москва": "Москва — столица России."})",
+    R"({"Санкт-Петербург": "Второй по численности город России, )"
+        R"(бывшая столица."})",
+    R"({"Fox": "The quick brown fox jumps over the lazy dog."})",
+    R"({"Пустая статья": ""})",
+    R"({"Dog": "A lazy dog."})"
+};
+
+static void append(segmented_index &, string_view);
+
+TEST(SegmentedIndexTest, Empty) {
+    std::filesystem::remove_all(directory);
+    const segmented_index segments(directory);
+    ASSERT_EQ(segments.segments(), 0U);
+    ASSERT_EQ(segments.size(), 0U);
+    ASSERT_THAT(segments("fox"), IsEmpty());
+}
+
+TEST(SegmentedIndexTest, Merge) {
+    ASSERT_NE(std::setlocale(LC_ALL, "en_US.utf8"), nullptr);
+    std::filesystem::remove_all(directory);
+    {
+        segmented_index segments(directory);
+        for (const string_view document : documents)
+            append(segments, document);
+        segments.wait();
+        // Four single documents merge into one segment of the next tier.
+        ASSERT_EQ(segments.segments(), 2U);
+        ASSERT_EQ(segments.size(), 5U);
+        ASSERT_THAT(segments("столица"), ElementsAre(0U, 1U));
+        ASSERT_THAT(segments("lazy dog"), ElementsAre(2U, 4U));
+        ASSERT_THAT(segments("росс*"), ElementsAre(0U, 1U));
+        ASSERT_EQ(segments.title(1U), "Санкт-Петербург");
+        ASSERT_EQ(segments.title(4U), "Dog");
+    }
+    const segmented_index reopened(directory);
+    ASSERT_EQ(reopened.segments(), 2U);
+    ASSERT_THAT(reopened("dog"), ElementsAre(2U, 4U));
+    ASSERT_EQ(reopened.title(3U), "Пустая статья");
+}
+
+TEST(SegmentedIndexTest, Flags) {
+    std::filesystem::remove_all(directory);
+    {
+        segmented_index segments(directory);
+        const class index plain(0U);
+        ASSERT_THROW(segments.append(plain), std::logic_error);
+        append(segments, documents[2]);
+    }
+    ASSERT_THROW(segmented_index(directory, 0U), std::logic_error);
+}
+
+TEST(SegmentedIndexTest, Remove) {
+    ASSERT_NE(std::setlocale(LC_ALL, "en_US.utf8"), nullptr);
+    std::filesystem::remove_all(directory);
+    {
+        segmented_index segments(directory);
+        for (size_t i = 0U; i < 3U; ++i)
+            append(segments, documents[i]);
+        segments.wait();
+        ASSERT_EQ(segments.remove({"Москва", "Nowhere"}), 1U);
+        ASSERT_EQ(segments.remove({"Москва"}), 0U);
+        ASSERT_EQ(segments.size(), 2U);
+        ASSERT_THAT(segments("столица"), ElementsAre(1U));
+        vector<string> titles;
+        ASSERT_THAT(segments("росс*", 10U, titles), ElementsAre(1U));
+        ASSERT_THAT(titles, ElementsAre("Санкт-Петербург"));
+    }
+    segmented_index reopened(directory);
+    ASSERT_EQ(reopened.size(), 2U);
+    ASSERT_THAT(reopened("столица"), ElementsAre(1U));
+
+    // The fourth segment triggers a merge that purges the deleted document
+    // and renumbers the rest.
+    append(reopened, documents[3]);
+    reopened.wait();
+    ASSERT_EQ(reopened.segments(), 1U);
+    ASSERT_EQ(reopened.size(), 3U);
+    ASSERT_THAT(reopened("столица"), ElementsAre(0U));
+    ASSERT_THAT(reopened("fox"), ElementsAre(1U));
+    ASSERT_EQ(reopened.title(2U), "Пустая статья");
+}
+
+TEST(SegmentedIndexTest, Update) {
+    ASSERT_NE(std::setlocale(LC_ALL, "en_US.utf8"), nullptr);
+    std::filesystem::remove_all(directory);
+    segmented_index segments(directory);
+    append(segments, documents[2]);
+    append(segments, R"({"Fox": "The fox sleeps."})");
+    ASSERT_EQ(segments.size(), 1U);
+    ASSERT_THAT(segments("quick"), IsEmpty());
+    ASSERT_THAT(segments("fox"), ElementsAre(1U));
+    ASSERT_THAT(segments("sleeps"), ElementsAre(1U));
+}
+
+TEST(SegmentedIndexTest, Manifest) {
+    namespace fs = std::filesystem;
+
+    ASSERT_NE(std::setlocale(LC_ALL, "en_US.utf8"), nullptr);
+    fs::remove_all(directory);
+    {
+        segmented_index segments(directory);
+        append(segments, R"({"Москва": "Столица.", "Fox": "A fox."})");
+        // Both updates replace the tombstones of the first segment.
+        append(segments, R"({"Москва": "Город."})");
+        append(segments, R"({"Fox": "The fox sleeps."})");
+        segments.wait();
+    }
+    // Files that are not listed, like those a crash may leave behind before
+    // the manifest is replaced, are ignored.
+    ofstream(fs::path(directory) / "tombstones100.del",
+        ios_base::binary | ios_base::out | ios_base::trunc).put('\xFF');
+    vector<string> files;
+    for (const fs::directory_entry &entry : fs::directory_iterator(directory))
+        files.push_back(entry.path().filename().string());
+    std::sort(files.begin(), files.end());
+    ASSERT_THAT(files, ElementsAre("manifest", "segment0.idx",
+        "segment1.idx", "segment3.idx", "tombstones100.del",
+        "tombstones4.del"));
+
+    segmented_index reopened(directory);
+    ASSERT_EQ(reopened.size(), 2U);
+    ASSERT_THAT(reopened("город"), ElementsAre(2U));
+    ASSERT_THAT(reopened("fox"), ElementsAre(3U));
+}
+
+static void append(segmented_index &segments, const string_view document) {
+    static constexpr const char *filename = "segment.json";
+    ofstream(filename, ios_base::binary | ios_base::out | ios_base::trunc)
+        .write(document.data(), static_cast<std::streamsize>(document.size()));
+    segments.append(vector<string>{filename});
+}
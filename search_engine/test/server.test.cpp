@@ -0,0 +1,118 @@
+#include <cerrno> // errno
+#include <cstddef> // size_t
+#include <cstring> // memcpy
+
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <system_error> // generic_category, system_error
+#include <thread> // thread
+#include <vector> // vector
+
+#include <sys/socket.h> // AF_UNIX, SOCK_STREAM, connect, recv, send, socket
+#include <sys/un.h> // sockaddr_un
+#include <unistd.h> // close
+
+#include <gtest/gtest.h>
+
+#include <search_engine/server.hpp>
+
+using std::string, std::string_view, std::thread, std::vector;
+
+static constexpr const char *socket_file = "server.test.sock";
+
+class client final {
+public:
+    client();
+    client(const client &) = delete;
+    client &operator=(const client &) = delete;
+    ~client() noexcept;
+
+    string request(string_view);
+    void send(string_view);
+    string receive(std::size_t);
+
+private:
+    int fildes_;
+};
+
+static void reverse(string_view, string &);
+
+TEST(ServerTest, Concurrent) {
+    server instance(socket_file, reverse, 4U);
+    thread runner(&server::run, &instance);
+
+    vector<thread> threads;
+    for (int i = 0; i < 8; ++i)
+        threads.emplace_back([i]() -> void {
+            client connection;
+            for (int j = 0; j < 32; ++j) {
+                const string query = std::to_string(i * 100 + j) + "ab";
+                ASSERT_EQ(connection.request(query + '\n'),
+                    string(query.crbegin(), query.crend()) + '\n');
+            }
+        });
+    for (thread &current : threads)
+        current.join();
+
+    instance.stop();
+    runner.join();
+}
+
+TEST(ServerTest, Pipeline) {
+    server instance(socket_file, reverse, 2U);
+    thread runner(&server::run, &instance);
+
+    client connection;
+    connection.send("abc\r\ndef\n\nxyz");
+    ASSERT_EQ(connection.receive(9U), "cba\nfed\n\n");
+    connection.send("\n");
+    ASSERT_EQ(connection.receive(4U), "zyx\n");
+
+    instance.stop();
+    runner.join();
+}
+
+client::client() : fildes_(socket(AF_UNIX, SOCK_STREAM, 0)) {
+    using std::generic_category, std::memcpy, std::system_error;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socket_file, string_view(socket_file).size() + 1U);
+    if (connect(fildes_, reinterpret_cast<const sockaddr *>(&address),
+        sizeof(address)) == -1
+    ) throw system_error(errno, generic_category(), "client::client");
+}
+
+client::~client() noexcept {
+    ::close(fildes_);
+}
+
+string client::request(const string_view query) {
+    send(query);
+    string response;
+    for (char c = '\0'; c != '\n'; response.push_back(c))
+        if (recv(fildes_, &c, 1U, 0) != 1)
+            return response;
+    return response;
+}
+
+void client::send(const string_view data) {
+    ::send(fildes_, data.data(), data.size(), 0);
+}
+
+string client::receive(const std::size_t size) {
+    string response(size, '\0');
+    for (std::size_t offset = 0U; offset < size; ) {
+        const ssize_t count =
+            recv(fildes_, response.data() + offset, size - offset, 0);
+        if (count <= 0)
+            break;
+        offset += static_cast<std::size_t>(count);
+    }
+    return response;
+}
+
+static void reverse(const string_view query, string &response) {
+    response.assign(query.crbegin(), query.crend());
+    response.push_back('\n');
+}
@@ -0,0 +1,75 @@
+#include <clocale> // LC_ALL, setlocale
+#include <cstddef> // size_t
+
+#include <string> // string, to_string
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/doc_store.hpp>
+#include <search_engine/index.hpp>
+#include <search_engine/snippets.hpp>
+
+using std::size_t, std::string, std::to_string, std::vector;
+
+static string snippet(const snippet_generator &generate, const string &text,
+    const vector<string> &terms) {
+    string returns;
+    generate(text, terms, returns);
+    return returns;
+}
+
+TEST(SnippetsTest, Window) {
+    std::setlocale(LC_ALL, "en_US.utf8");
+    const snippet_generator generate(index::stop_words | index::stem, 4U, 1U);
+    ASSERT_EQ(snippet(generate, "", {"cat"}), "");
+    ASSERT_EQ(snippet(generate, "One two three four five", {}),
+        "One two three four");
+    // The window with both terms wins over the one with the first term twice.
+    const string text =
+        "Cats, cats and more.\nA dog met\tthe cat's owner here.";
+    ASSERT_EQ(snippet(generate, text, {"cat", "dog"}),
+        "[dog] met the [cat's]");
+    ASSERT_EQ(snippet(generate, text, {"cat"}), "[Cats], [cats] and more");
+}
+
+TEST(SnippetsTest, Several) {
+    std::setlocale(LC_ALL, "en_US.utf8");
+    const snippet_generator generate(0U, 3U, 2U);
+    const string text = "alpha beta gamma delta epsilon zeta eta theta iota";
+    ASSERT_EQ(snippet(generate, text, {"theta", "beta"}),
+        "alpha [beta] gamma ... eta [theta] iota");
+    ASSERT_EQ(snippet(generate, text, {"the*", "z*a", "eps~1"}),
+        "[zeta] eta [theta]");
+    ASSERT_EQ(snippet(generate, text, {"the*", "z*a", "epsilon~1"}),
+        "gamma delta [epsilon] ... [zeta] eta [theta]");
+    // Without a second match there is a single window.
+    ASSERT_EQ(snippet(generate, text, {"delta"}), "gamma [delta] epsilon");
+    ASSERT_EQ(snippet(generate, "Ünïcode wörds ünïcode", {"ünïcode"}),
+        "[Ünïcode] wörds [ünïcode]");
+}
+
+TEST(SnippetsTest, Store) {
+    std::setlocale(LC_ALL, "en_US.utf8");
+    vector<index::doc_id> ids;
+    {
+        doc_store_writer store("docs.bin", 4096U);
+        for (size_t i = 0U; i < 100U; ++i) {
+            string text;
+            for (size_t j = 0U; j < 200U; ++j)
+                text += "word" + to_string(j) + ' ';
+            store.add("Title " + to_string(i), text + "needle");
+            ids.push_back(static_cast<index::doc_id>(99U - i));
+        }
+        store.finish();
+    }
+    const doc_store store("docs.bin");
+    const snippet_generator generate(0U, 2U, 1U);
+    for (const size_t threads : {1U, 4U}) {
+        const vector<string> snippets =
+            generate(store, ids, 50U, {"needle"}, threads);
+        ASSERT_EQ(snippets.size(), 50U);
+        for (const string &current : snippets)
+            ASSERT_EQ(current, "word199 [needle]");
+    }
+}
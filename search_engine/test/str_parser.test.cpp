@@ -1,3 +1,6 @@
+#include <cstddef> // size_t
+
+#include <algorithm> // min
 #include <stdexcept> // logic_error
 #include <string> // string
 #include <string_view> // string_view
@@ -6,9 +9,10 @@
 
 #include <search_engine/str_parser.hpp>
 
-using std::logic_error, std::string, std::string_view;
+using std::logic_error, std::size_t, std::string, std::string_view;
 
 static string parse_string(string_view);
+static string resume_string(string_view, size_t);
 
 TEST(StrParserTest, Pangram) {
     ASSERT_EQ(parse_string(
@@ -65,6 +69,28 @@ TEST(StrParserTest, ParseEscape) {
     ASSERT_EQ(parse_string("\"\\u007f\""), "\x7F");
 }
 
+TEST(StrParserTest, Resume) {
+    static constexpr string_view str =
+        "\"Съешь \\\"еще\\\" \\u0007этих\\n\\tбулок\"";
+    const string expected = parse_string(str);
+    for (size_t piece = 1U; piece <= str.size(); ++piece)
+        ASSERT_EQ(resume_string(str, piece), expected);
+
+    string buffer;
+    str_parser invocable([&buffer](const char c) constexpr -> void {
+        buffer.push_back(c);
+    });
+    const string_view first = "\"a\\u00", second = "07\"b";
+    ASSERT_EQ(invocable.resume(first.cbegin(), first.cend()), first.cend());
+    ASSERT_TRUE(invocable.is_partial());
+    ASSERT_EQ(invocable.resume(second.cbegin(), second.cend()),
+        second.cbegin() + 3);
+    ASSERT_FALSE(invocable.is_partial());
+    ASSERT_EQ(buffer, "a\x07");
+    ASSERT_THROW(invocable.resume(second.cbegin() + 3, second.cend()),
+        logic_error);
+}
+
 TEST(StrParserTest, Throw) {
     ASSERT_THROW(parse_string(""),            logic_error);
     ASSERT_THROW(parse_string("\""),          logic_error);
@@ -95,3 +121,24 @@ static string parse_string(const string_view str) {
 
     return buffer;
 }
+
+// Feeds the string to resume in pieces of the given size.
+static string resume_string(const string_view str, const size_t piece) {
+    using std::min;
+
+    string buffer;
+    str_parser invocable([&buffer](const char c) constexpr -> void {
+        buffer.push_back(c);
+    });
+    for (size_t i = 0U; i < str.size(); i += piece) {
+        const string_view part = str.substr(i, min(piece, str.size() - i));
+        const auto last = invocable.resume(part.cbegin(), part.cend());
+        if (invocable.is_partial() != (last == part.cend() &&
+            i + part.size() < str.size())
+        ) throw logic_error("resume_string: string is not parsed completely");
+    }
+    if (invocable.is_partial())
+        throw logic_error("resume_string: string is not ended");
+
+    return buffer;
+}
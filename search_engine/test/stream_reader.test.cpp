@@ -0,0 +1,89 @@
+#include <cstddef> // size_t
+
+#include <algorithm> // min
+#include <string> // string, to_string
+#include <string_view> // string_view
+#include <system_error> // system_error
+#include <thread> // thread
+
+#include <unistd.h> // close, pipe, write
+
+#include <gtest/gtest.h>
+
+#include <search_engine/stream_reader.hpp>
+
+using std::size_t, std::string, std::string_view, std::thread;
+
+static string through_pipe(string_view, size_t, size_t);
+
+TEST(StreamReaderTest, Empty) {
+    ASSERT_EQ(through_pipe("", 2U, 1U), "");
+}
+
+TEST(StreamReaderTest, Pipe) {
+    string data;
+    for (size_t i = 0U; i < 10000U; ++i)
+        data += std::to_string(i) + ' ';
+    for (const size_t buffers : {2U, 3U, 4U})
+        for (const size_t size : {1U, 7U, 64U, 4096U, 1U << 20U})
+            ASSERT_EQ(through_pipe(data, buffers, size), data);
+}
+
+TEST(StreamReaderTest, Error) {
+    stream_reader reader(-1, 2U, 16U);
+    ASSERT_THROW(static_cast<void>(reader.next()), std::system_error);
+}
+
+TEST(StreamReaderTest, Stop) {
+    int fildes[2];
+    ASSERT_EQ(pipe(fildes), 0);
+    ASSERT_EQ(write(fildes[1], "0123456789", 10U), 10);
+    {
+        stream_reader reader(fildes[0], 2U, 1U);
+        ASSERT_EQ(reader.next(), "0");
+    }
+    close(fildes[0]);
+    close(fildes[1]);
+}
+
+TEST(StreamReaderTest, Stall) {
+    int fildes[2];
+    ASSERT_EQ(pipe(fildes), 0);
+    ASSERT_EQ(write(fildes[1], "0123456789", 10U), 10);
+    {
+        // The writer stalls, so the reader gets what has arrived and then
+        // gives up waiting for more when destroyed.
+        stream_reader reader(fildes[0], 2U, 1U << 20U);
+        ASSERT_EQ(reader.next(), "0123456789");
+    }
+    close(fildes[0]);
+    close(fildes[1]);
+}
+
+// Writes the data to a pipe in small pieces and reads it back.
+static string through_pipe(
+    const string_view data,
+    const size_t buffers,
+    const size_t size
+) {
+    using std::min;
+
+    int fildes[2];
+    if (pipe(fildes) != 0)
+        return "pipe";
+    thread writer([data, out = fildes[1]]() noexcept -> void {
+        for (size_t i = 0U; i < data.size(); i += 100U)
+            static_cast<void>(write(out, data.data() + i,
+                min<size_t>(100U, data.size() - i)));
+        close(out);
+    });
+    string result;
+    {
+        stream_reader reader(fildes[0], buffers, size);
+        for (string_view piece; piece = reader.next(), !piece.empty(); )
+            result += piece;
+    }
+    writer.join();
+    close(fildes[0]);
+    return result;
+}
@@ -0,0 +1,40 @@
+#include <cstdint> // uint64_t
+
+#include <stdexcept> // out_of_range
+#include <vector> // vector
+
+#include <gtest/gtest.h>
+
+#include <search_engine/tombstones.hpp>
+
+using std::out_of_range, std::uint64_t, std::vector;
+
+TEST(TombstonesTest, Insert) {
+    tombstones deleted(130U);
+    ASSERT_EQ(deleted.size(), 130U);
+    ASSERT_EQ(deleted.words().size(), 3U);
+    for (const tombstones::doc_id id : {0U, 63U, 64U, 129U, 64U})
+        deleted.insert(id);
+    ASSERT_EQ(deleted.count(), 4U);
+    ASSERT_TRUE(deleted.contains(0U));
+    ASSERT_FALSE(deleted.contains(1U));
+    ASSERT_TRUE(deleted.contains(63U));
+    ASSERT_TRUE(deleted.contains(64U));
+    ASSERT_FALSE(deleted.contains(128U));
+    ASSERT_TRUE(deleted.contains(129U));
+    ASSERT_FALSE(deleted.contains(130U));
+    ASSERT_THROW(deleted.insert(130U), out_of_range);
+}
+
+TEST(TombstonesTest, Words) {
+    tombstones deleted(70U);
+    deleted.insert(3U);
+    deleted.insert(69U);
+    vector<uint64_t> words = deleted.words();
+    const tombstones loaded(70U, vector<uint64_t>(words));
+    ASSERT_EQ(loaded.count(), 2U);
+    ASSERT_TRUE(loaded.contains(69U));
+    ASSERT_THROW(tombstones(64U, vector<uint64_t>(words)), out_of_range);
+    words.back() |= uint64_t{1} << 10U;
+    ASSERT_THROW(tombstones(70U, vector<uint64_t>(words)), out_of_range);
+}
@@ -0,0 +1,58 @@
+#include <cstdint> // uint32_t
+
+#include <iterator> // back_inserter
+#include <limits> // numeric_limits
+#include <stdexcept> // logic_error
+#include <string> // string
+
+#include <gtest/gtest.h>
+
+#include <search_engine/varbyte.hpp>
+
+using std::back_inserter, std::logic_error, std::numeric_limits, std::string,
+    std::uint32_t;
+
+TEST(VarbyteTest, Invalid) {
+    uint32_t value;
+    const string empty, truncated = "\x80\x80",
+        overlong = "\xFF\xFF\xFF\xFF\xFF\x01";
+    ASSERT_THROW(varbyte_decode(empty.data(), empty.data(), value),
+        logic_error);
+    ASSERT_THROW(varbyte_decode(truncated.data(),
+        truncated.data() + truncated.size(), value), logic_error);
+    ASSERT_THROW(varbyte_decode(overlong.data(),
+        overlong.data() + overlong.size(), value), logic_error);
+}
+
+TEST(VarbyteTest, RoundTrip) {
+    static constexpr uint32_t values[] = {
+        0U, 1U, 0x7FU, 0x80U, 0x3FFFU, 0x4000U, 0x1FFFFFU, 0x200000U,
+        0xFFFFFFFU, 0x10000000U, numeric_limits<uint32_t>::max()
+    };
+
+    string encoded;
+    for (const uint32_t value : values)
+        varbyte_encode(value, back_inserter(encoded));
+    ASSERT_EQ(encoded.size(),
+        1U + 1U + 1U + 2U + 2U + 3U + 3U + 4U + 4U + 5U + 5U);
+
+    const char *first = encoded.data();
+    const char * const last = first + encoded.size();
+    for (const uint32_t expected : values) {
+        uint32_t value;
+        first = varbyte_decode(first, last, value);
+        ASSERT_EQ(value, expected);
+    }
+    ASSERT_EQ(first, last);
+}
+
+TEST(VarbyteTest, Size) {
+    for (const uint32_t value : {0U, 0x7FU, 0x80U, 0x3FFFU, 0x4000U,
+            0x1FFFFFU, 0x200000U, 0xFFFFFFFU, 0x10000000U,
+            numeric_limits<uint32_t>::max()}
+    ) {
+        string encoded;
+        varbyte_encode(value, back_inserter(encoded));
+        ASSERT_EQ(varbyte_size(value), encoded.size());
+    }
+}
@@ -0,0 +1,43 @@
+#include <cstring> // memcpy
+
+#include <string> // string
+#include <string_view> // string_view
+
+#include <gtest/gtest.h>
+
+#include <search_engine/memmap.hpp>
+#include <search_engine/writable_memmap.hpp>
+
+using std::string, std::string_view;
+
+TEST(WritableMemmapTest, Empty) {
+    static constexpr const char *filename = "writable_empty.bin";
+    writable_memmap map(filename, 0U);
+    ASSERT_TRUE(map.is_open());
+    ASSERT_EQ(map.data(), nullptr);
+    ASSERT_EQ(map.size(), 0U);
+    map.sync();
+    map.close();
+    ASSERT_FALSE(map.is_open());
+    ASSERT_TRUE(memmap(filename).empty());
+}
+
+TEST(WritableMemmapTest, RoundTrip) {
+    static constexpr const char *filename = "writable.bin";
+    static constexpr string_view data = "The quick brown fox jumps over the "
+        "lazy dog.";
+    {
+        writable_memmap map(filename, data.size() + 8U);
+        std::memcpy(map.data() + 8, data.data(), data.size());
+        map.sync();
+    }
+    const memmap map(filename);
+    ASSERT_EQ(static_cast<string_view>(map), string(8U, '\0') + string(data));
+}
+
+TEST(WritableMemmapTest, Truncate) {
+    static constexpr const char *filename = "writable_truncate.bin";
+    writable_memmap(filename, 1U << 16U).data()[0] = 'x';
+    writable_memmap(filename, 1U).data()[0] = 'y';
+    ASSERT_EQ(static_cast<string_view>(memmap(filename)), "y");
+}